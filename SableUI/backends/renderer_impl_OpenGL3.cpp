@@ -799,8 +799,9 @@ void GpuTexture2DArray::Init(int width, int height, int depth)
 	glBindTexture(GL_TEXTURE_2D_ARRAY, handle);
 	glTexStorage3D(GL_TEXTURE_2D_ARRAY, 1, GL_R8, width, height, depth);
 
-	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	GLint filter = m_linear ? GL_LINEAR : GL_NEAREST;
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, filter);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, filter);
 	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 }
@@ -820,8 +821,9 @@ void GpuTexture2DArray::Resize(int newDepth)
 
 	glTexStorage3D(GL_TEXTURE_2D_ARRAY, 1, GL_R8, m_width, m_height, newDepth);
 
-	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	GLint filter = m_linear ? GL_LINEAR : GL_NEAREST;
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, filter);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, filter);
 	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
@@ -837,6 +839,18 @@ void GpuTexture2DArray::Resize(int newDepth)
 	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
 }
 
+void GpuTexture2DArray::SetLinearFiltering(bool linear)
+{
+	m_linear = linear;
+	if (handle == 0) return;
+
+	GLint filter = m_linear ? GL_LINEAR : GL_NEAREST;
+	glBindTexture(GL_TEXTURE_2D_ARRAY, handle);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, filter);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, filter);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
 void GpuTexture2DArray::SubImage(int xOffset, int yOffset, int zOffset,
 	int width, int height, int depth, const uint8_t* pixels)
 {
@@ -26,7 +26,7 @@ void Button::Init(
 
 static Rect GetDefaultPadding(const ElementInfo& info)
 {
-	switch (info.appearance.size)
+	switch (info.appearance->size)
 	{
 	case ComponentSize::Small:  return { 8, 4, 8, 4 };
 	case ComponentSize::Medium: return { 12, 6, 12, 6 };
@@ -37,13 +37,13 @@ static Rect GetDefaultPadding(const ElementInfo& info)
 
 static Rect ResolvePadding(const ElementInfo& info)
 {
-	if (info.layout.pB || info.layout.pT || info.layout.pL || info.layout.pR)
+	if (info.layout->pB || info.layout->pT || info.layout->pL || info.layout->pR)
 	{
 		return {
-			info.layout.pR,
-			info.layout.pT,
-			info.layout.pL,
-			info.layout.pB
+			info.layout->pR,
+			info.layout->pT,
+			info.layout->pL,
+			info.layout->pB
 		};
 	}
 
@@ -58,19 +58,19 @@ static void ApplyButtonBackground(
 	const Theme& t = GetTheme();
 	const float dFac = 0.9f;
 
-	if (src.appearance.hasHoverBg)
+	if (src.appearance->hasHoverBg)
 	{
-		Colour base = src.appearance.bg.value_or(t.primary);
+		Colour base = src.appearance->bg.value_or(t.primary);
 
 		PackStylesToInfo(i,
-			pressed ? hoverBg(base * dFac, src.appearance.hoverBg * dFac)
-			: hoverBg(base, src.appearance.hoverBg)
+			pressed ? hoverBg(base * dFac, src.appearance->hoverBg * dFac)
+			: hoverBg(base, src.appearance->hoverBg)
 		);
 		return;
 	}
 
 
-	Colour base = src.appearance.bg.value_or(t.primary);
+	Colour base = src.appearance->bg.value_or(t.primary);
 
 	PackStylesToInfo(i,
 		pressed ? hoverBg(base * dFac, base * dFac * dFac)
@@ -90,13 +90,13 @@ void Button::Layout()
 	Rect padding = ResolvePadding(info);
 
 	ElementInfo i{};
-	i.layout.pR = padding.x;
-	i.layout.pT = padding.y;
-	i.layout.pL = padding.w;
-	i.layout.pB = padding.h;
+	i.layout.mut().pR = padding.x;
+	i.layout.mut().pT = padding.y;
+	i.layout.mut().pL = padding.w;
+	i.layout.mut().pB = padding.h;
 
-	i.layout.wType = RectType::Fill;
-	i.layout.hType = RectType::Fill;
+	i.layout.mut().wType = RectType::Fill;
+	i.layout.mut().hType = RectType::Fill;
 
 	Colour col;
 	if (info.text.colour.has_value())
@@ -104,18 +104,18 @@ void Button::Layout()
 	else
 		col = GetTheme().text;
 
-	if (info.appearance.disabled)
+	if (info.appearance->disabled)
 		ApplyDisabledStyle(i, col);
 	else
 		ApplyButtonBackground(i, info, isPressed.get());
 
-	i.appearance.rTL = info.appearance.rTL > 0.0f ? info.appearance.rTL : 4.0f;
-	i.appearance.rTR = info.appearance.rTR > 0.0f ? info.appearance.rTR : 4.0f;
-	i.appearance.rBL = info.appearance.rBL > 0.0f ? info.appearance.rBL : 4.0f;
-	i.appearance.rBR = info.appearance.rBR > 0.0f ? info.appearance.rBR : 4.0f;
+	i.appearance.mut().rTL = info.appearance->rTL > 0.0f ? info.appearance->rTL : 4.0f;
+	i.appearance.mut().rTR = info.appearance->rTR > 0.0f ? info.appearance->rTR : 4.0f;
+	i.appearance.mut().rBL = info.appearance->rBL > 0.0f ? info.appearance->rBL : 4.0f;
+	i.appearance.mut().rBR = info.appearance->rBR > 0.0f ? info.appearance->rBR : 4.0f;
 
 	i.onClickFunc = [this]() {
-		if (!info.appearance.disabled && onClickCallback)
+		if (!info.appearance->disabled && onClickCallback)
 			onClickCallback();
 	};
 
@@ -143,7 +143,7 @@ void Button::OnUpdate(const UIEventContext& ctx)
 
 	bool isHovered = RectBoundingBox(root->rect, ctx.mousePos);
 
-	if (!info.appearance.disabled && isHovered)
+	if (!info.appearance->disabled && isHovered)
 	{
 		if (ctx.mousePressed.test(SABLE_MOUSE_BUTTON_LEFT))
 			isPressed.set(true);
@@ -37,7 +37,7 @@ bool Checkbox::IsChecked() const
 
 static int GetBoxSize(const SableUI::ElementInfo& info)
 {
-	switch (info.appearance.size)
+	switch (info.appearance->size)
 	{
 	case ComponentSize::Small:  return 12;
 	case ComponentSize::Large:  return 18;
@@ -47,7 +47,7 @@ static int GetBoxSize(const SableUI::ElementInfo& info)
 
 static int GetFontSize(const SableUI::ElementInfo& info)
 {
-	switch (info.appearance.size)
+	switch (info.appearance->size)
 	{
 	case ComponentSize::Small:	return 10;
 	case ComponentSize::Large:	return 13;
@@ -57,10 +57,10 @@ static int GetFontSize(const SableUI::ElementInfo& info)
 
 static Colour GetCheckColour(const SableUI::ElementInfo& info, bool checked, const SableUI::Theme& t)
 {
-	if (info.appearance.disabled)
+	if (info.appearance->disabled)
 	{
 		if (checked)
-			return info.appearance.bg.value_or(t.overlay2) * 0.6f;
+			return info.appearance->bg.value_or(t.overlay2) * 0.6f;
 
 		return t.overlay2;
 	}
@@ -68,7 +68,7 @@ static Colour GetCheckColour(const SableUI::ElementInfo& info, bool checked, con
 	Colour base{};
 
 	if (checked)
-		base = info.appearance.bg.value_or(t.checkColour);
+		base = info.appearance->bg.value_or(t.checkColour);
 	else
 		base = t.surface2;
 
@@ -90,7 +90,7 @@ void Checkbox::Layout()
 			HandleClick();
 		}))
 	{
-		if (info.appearance.disabled)
+		if (info.appearance->disabled)
 		{
 			Div(w(size), h(size), bg(col), rounded(4), mr(6), centerY)
 			{
@@ -120,7 +120,7 @@ void Checkbox::Layout()
 
 void Checkbox::HandleClick()
 {
-	if (info.appearance.disabled)
+	if (info.appearance->disabled)
 		return;
 
 	bool newValue = !IsChecked();
@@ -0,0 +1,610 @@
+#include <SableUI/components/data_grid.h>
+#include <SableUI/SableUI.h>
+#include <SableUI/styles/styles.h>
+#include <SableUI/styles/theme.h>
+#include <SableUI/utils/console.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace SableUI;
+using namespace SableUI::Style;
+
+constexpr int SCROLL_STEP = 50;
+constexpr int CELL_PADDING = 6;
+constexpr int RESIZE_HANDLE_WIDTH = 4;
+constexpr int MIN_COLUMN_WIDTH = 24;
+constexpr size_t SORT_RUN_LENGTH = 8192; // rows sorted between cancellation checks
+
+// ============================================================================
+// DataGridProvider
+// ============================================================================
+// the grid copies the cells instead unless CompareOnWorker() is overridden too
+bool DataGridProvider::LessThan(size_t, size_t, size_t) const
+{
+	SableUI_Runtime_Error("DataGridProvider::CompareOnWorker() is true but LessThan is not overridden");
+	return false;
+}
+
+bool DataGridProvider::MatchesFilter(size_t, const std::u32string&) const
+{
+	SableUI_Runtime_Error("DataGridProvider::CompareOnWorker() is true but MatchesFilter is not overridden");
+	return false;
+}
+
+// ============================================================================
+// Shared grid state
+// ============================================================================
+// cells copied on the UI thread for the worker, row major
+struct DataGridCells
+{
+	std::vector<char32_t> text;
+	std::vector<size_t> offsets{ 0 };
+	size_t columns = 0;
+
+	void Add(const SableString& cell)
+	{
+		text.insert(text.end(), cell.begin(), cell.end());
+		offsets.push_back(text.size());
+	}
+
+	std::u32string_view Get(size_t row, size_t col) const
+	{
+		size_t cell = row * columns + col;
+		return std::u32string_view(text.data() + offsets[cell], offsets[cell + 1] - offsets[cell]);
+	}
+};
+
+struct DataGridJob
+{
+	// only set when the provider compares on the worker, cells is used otherwise
+	std::shared_ptr<DataGridProvider> provider = nullptr;
+	DataGridCells cells;
+	size_t keyColumn = 0; // sort column within the copied cells
+	size_t rowCount = 0;
+	int sortColumn = -1;
+	bool ascending = true;
+	std::u32string filter;
+
+	std::atomic<bool> cancelled{ false };
+	std::atomic<bool> done{ false };
+	std::vector<uint32_t> rows;
+};
+
+static void RunGridJob(DataGridJob& job);
+
+/* one sort/filter thread per grid, joined when the grid's state is freed so
+ * no job outlives the grid or wakes the event loop after it is gone. a new
+ * job replaces a queued one, the running one is cancelled by its owner */
+class DataGridWorker
+{
+public:
+	~DataGridWorker()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+			if (m_pending) m_pending->cancelled.store(true);
+		}
+		m_wake.notify_one();
+
+		if (m_thread.joinable())
+			m_thread.join();
+	}
+
+	void Submit(std::shared_ptr<DataGridJob> job)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_pending = std::move(job);
+
+			if (!m_thread.joinable())
+				m_thread = std::thread(&DataGridWorker::WorkerMain, this);
+		}
+		m_wake.notify_one();
+	}
+
+private:
+	void WorkerMain()
+	{
+		while (true)
+		{
+			std::shared_ptr<DataGridJob> job;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_wake.wait(lock, [this] { return m_stop || m_pending; });
+				if (m_stop) return;
+				job = std::move(m_pending);
+			}
+
+			RunGridJob(*job);
+		}
+	}
+
+	std::thread m_thread;
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::shared_ptr<DataGridJob> m_pending = nullptr;
+	bool m_stop = false;
+};
+
+// shared between component instances through a Ref, outlives rerenders
+struct SableUI::DataGridState
+{
+	std::shared_ptr<DataGridProvider> provider = nullptr;
+	size_t sourceRowCount = 0;
+
+	std::vector<int> widths;
+	std::vector<int64_t> offsets;
+
+	// permutation of source rows, unused while identity
+	std::vector<uint32_t> rows;
+	bool identity = true;
+
+	int sortColumn = -1;
+	bool ascending = true;
+	std::u32string filter;
+
+	std::shared_ptr<DataGridJob> job = nullptr;
+	DataGridWorker worker; // declared last, joined before the rest is freed
+
+	~DataGridState()
+	{
+		if (job) job->cancelled.store(true);
+	}
+
+	void RebuildOffsets()
+	{
+		offsets.assign(widths.size() + 1, 0);
+		for (size_t i = 0; i < widths.size(); i++)
+			offsets[i + 1] = offsets[i] + widths[i];
+	}
+};
+
+static bool MatchesFilter(const DataGridJob& job, size_t row)
+{
+	if (job.provider)
+		return job.provider->MatchesFilter(row, job.filter);
+
+	for (size_t col = 0; col < job.cells.columns; col++)
+		if (job.cells.Get(row, col).find(job.filter) != std::u32string_view::npos)
+			return true;
+
+	return false;
+}
+
+static bool LessThan(const DataGridJob& job, size_t rowA, size_t rowB)
+{
+	if (job.provider)
+		return job.provider->LessThan(rowA, rowB, static_cast<size_t>(job.sortColumn));
+
+	return job.cells.Get(rowA, job.keyColumn) < job.cells.Get(rowB, job.keyColumn);
+}
+
+static void RunGridJob(DataGridJob& job)
+{
+	std::vector<uint32_t> rows;
+	rows.reserve(job.rowCount);
+
+	for (size_t i = 0; i < job.rowCount; i++)
+	{
+		if ((i & 4095) == 0 && job.cancelled.load())
+			return;
+
+		if (job.filter.empty() || MatchesFilter(job, i))
+			rows.push_back(static_cast<uint32_t>(i));
+	}
+
+	if (job.sortColumn >= 0)
+	{
+		bool ascending = job.ascending;
+		auto less = [&](uint32_t a, uint32_t b) {
+			return ascending ? LessThan(job, a, b) : LessThan(job, b, a);
+		};
+
+		// stable merge sort in runs, cancellation is checked between runs and
+		// merges so the comparator itself stays a strict weak ordering
+		size_t n = rows.size();
+		for (size_t begin = 0; begin < n; begin += SORT_RUN_LENGTH)
+		{
+			if (job.cancelled.load()) return;
+			std::stable_sort(rows.begin() + begin, rows.begin() + std::min(n, begin + SORT_RUN_LENGTH), less);
+		}
+
+		std::vector<uint32_t> merged(n);
+		for (size_t width = SORT_RUN_LENGTH; width < n; width *= 2)
+		{
+			for (size_t lo = 0; lo < n; lo += width * 2)
+			{
+				if (job.cancelled.load()) return;
+
+				size_t mid = std::min(n, lo + width);
+				size_t hi = std::min(n, lo + width * 2);
+				std::merge(rows.begin() + lo, rows.begin() + mid, rows.begin() + mid, rows.begin() + hi,
+					merged.begin() + lo, less);
+			}
+			rows.swap(merged);
+		}
+	}
+
+	if (job.cancelled.load())
+		return;
+
+	job.rows = std::move(rows);
+	job.done.store(true);
+	PostEmptyEvent();
+}
+
+// ============================================================================
+// DataGrid
+// ============================================================================
+void DataGrid::Init(std::shared_ptr<DataGridProvider> provider, int rowHeight, const ElementInfo& p_info)
+{
+	info = p_info;
+	m_provider = std::move(provider);
+	m_rowHeight = std::max(1, rowHeight);
+	m_filter.clear();
+}
+
+void DataGrid::SetFilter(const SableString& filter)
+{
+	m_filter.assign(filter.begin(), filter.end());
+}
+
+DataGridState& DataGrid::GetGridState()
+{
+	constexpr size_t MAX_ROWS = std::numeric_limits<uint32_t>::max();
+	size_t rowCount = m_provider ? std::min(m_provider->GetRowCount(), MAX_ROWS) : 0;
+	size_t colCount = m_provider ? m_provider->GetColumnCount() : 0;
+
+	std::shared_ptr<DataGridState> prev = gridState.get();
+	if (prev && prev->provider == m_provider && prev->sourceRowCount == rowCount && prev->widths.size() == colCount)
+		return *prev;
+
+	if (rowCount == MAX_ROWS)
+		SableUI_Warn("DataGrid row count reached %zu, extra rows are ignored", MAX_ROWS);
+
+	auto next = std::make_shared<DataGridState>();
+	next->provider = m_provider;
+	next->sourceRowCount = rowCount;
+
+	// same provider with new data keeps the user's sort, filter and widths
+	bool keep = prev && prev->provider == m_provider;
+	if (keep && prev->widths.size() == colCount)
+	{
+		next->widths = prev->widths;
+	}
+	else
+	{
+		next->widths.resize(colCount);
+		for (size_t col = 0; col < colCount; col++)
+			next->widths[col] = std::max(MIN_COLUMN_WIDTH, m_provider->GetColumnWidth(col));
+	}
+	next->RebuildOffsets();
+
+	if (keep)
+	{
+		next->sortColumn = (prev->sortColumn < static_cast<int>(colCount)) ? prev->sortColumn : -1;
+		next->ascending = prev->ascending;
+		next->filter = prev->filter;
+	}
+
+	gridState.set(next);
+
+	if (next->sortColumn >= 0 || !next->filter.empty())
+		StartJob();
+
+	return *next;
+}
+
+void DataGrid::StartJob()
+{
+	DataGridState& s = GetGridState();
+
+	if (s.job)
+	{
+		s.job->cancelled.store(true);
+		s.job = nullptr;
+	}
+
+	if (s.sortColumn < 0 && s.filter.empty())
+	{
+		s.rows.clear();
+		s.rows.shrink_to_fit();
+		s.identity = true;
+		return;
+	}
+
+	s.job = std::make_shared<DataGridJob>();
+	s.job->rowCount = s.sourceRowCount;
+	s.job->sortColumn = s.sortColumn;
+	s.job->ascending = s.ascending;
+	s.job->filter = s.filter;
+
+	if (s.provider->CompareOnWorker())
+	{
+		s.job->provider = s.provider;
+	}
+	else
+	{
+		// GetCell stays on the UI thread, the worker only sees the copies.
+		// a filter looks at every column, a sort only at its own
+		DataGridCells& cells = s.job->cells;
+		bool allColumns = !s.filter.empty();
+		cells.columns = allColumns ? s.widths.size() : 1;
+		s.job->keyColumn = (allColumns && s.sortColumn >= 0) ? static_cast<size_t>(s.sortColumn) : 0;
+
+		cells.offsets.reserve(s.sourceRowCount * cells.columns + 1);
+		for (size_t row = 0; row < s.sourceRowCount; row++)
+		{
+			if (allColumns)
+			{
+				for (size_t col = 0; col < cells.columns; col++)
+					cells.Add(s.provider->GetCell(row, col));
+			}
+			else
+			{
+				cells.Add(s.provider->GetCell(row, static_cast<size_t>(s.sortColumn)));
+			}
+		}
+	}
+
+	s.worker.Submit(s.job);
+}
+
+void DataGrid::SortBy(size_t column, bool ascending)
+{
+	DataGridState& s = GetGridState();
+	if (column >= s.widths.size()) return;
+
+	s.sortColumn = static_cast<int>(column);
+	s.ascending = ascending;
+	StartJob();
+	MarkDirty();
+}
+
+void DataGrid::ClearSort()
+{
+	DataGridState& s = GetGridState();
+	if (s.sortColumn < 0) return;
+
+	s.sortColumn = -1;
+	StartJob();
+	MarkDirty();
+}
+
+void DataGrid::ToggleSort(size_t column)
+{
+	// release at the end of a column resize lands on the header too
+	if (resizingColumn.get() >= 0) return;
+
+	DataGridState& s = GetGridState();
+	if (s.sortColumn != static_cast<int>(column))
+		SortBy(column, true);
+	else if (s.ascending)
+		SortBy(column, false);
+	else
+		ClearSort();
+}
+
+bool DataGrid::IsProcessing()
+{
+	return GetGridState().job != nullptr;
+}
+
+size_t DataGrid::GetNumVisibleRows()
+{
+	DataGridState& s = GetGridState();
+	return s.identity ? s.sourceRowCount : s.rows.size();
+}
+
+size_t DataGrid::GetSourceRow(size_t row)
+{
+	DataGridState& s = GetGridState();
+	return s.identity ? row : s.rows[row];
+}
+
+int64_t DataGrid::GetMaxScrollY()
+{
+	int64_t contentH = static_cast<int64_t>(GetNumVisibleRows()) * m_rowHeight;
+	return std::max<int64_t>(0, contentH - viewportHeight.get());
+}
+
+int DataGrid::GetMaxScrollX()
+{
+	const DataGridState& s = GetGridState();
+	return static_cast<int>(std::max<int64_t>(0, s.offsets.back() - viewportWidth.get()));
+}
+
+void DataGrid::SetScroll(int x, int64_t y)
+{
+	scrollX.set(std::clamp(x, 0, GetMaxScrollX()));
+	scrollY.set(std::clamp<int64_t>(y, 0, GetMaxScrollY()));
+}
+
+void DataGrid::Layout()
+{
+	DataGridState& s = GetGridState();
+	if (s.filter != m_filter)
+	{
+		s.filter = m_filter;
+		StartJob();
+	}
+
+	const Theme& t = GetTheme();
+	size_t rowCount = GetNumVisibleRows();
+	size_t colCount = s.widths.size();
+	int vpW = viewportWidth.get();
+	int vpH = viewportHeight.get();
+	int64_t sy = std::clamp<int64_t>(scrollY.get(), 0, GetMaxScrollY());
+	int sx = std::clamp(scrollX.get(), 0, GetMaxScrollX());
+
+	// visible rows, viewport size is unknown until the first layout
+	m_firstRow = 0;
+	m_numRows = 0;
+	if (rowCount > 0)
+	{
+		size_t first = std::min(static_cast<size_t>(sy / m_rowHeight), rowCount - 1);
+		size_t last = (vpH > 0) ? static_cast<size_t>((sy + vpH - 1) / m_rowHeight) + 1 : first + 1;
+
+		m_firstRow = first;
+		m_numRows = std::min(rowCount, last) - first;
+	}
+
+	// visible columns from the width prefix sums
+	m_firstCol = 0;
+	m_numCols = 0;
+	if (colCount > 0)
+	{
+		size_t first = static_cast<size_t>(std::upper_bound(s.offsets.begin(), s.offsets.end(), sx) - s.offsets.begin()) - 1;
+		first = std::min(first, colCount - 1);
+
+		size_t last = first + 1;
+		while (last < colCount && s.offsets[last] < sx + vpW)
+			last++;
+
+		m_firstCol = first;
+		m_numCols = last - first;
+	}
+
+	while (m_handleIds.size() < m_numCols)
+		m_handleIds.push_back(MakeUniqueElementId());
+
+	int colMargin = static_cast<int>(s.offsets[m_firstCol] - sx);
+	int rowMargin = static_cast<int>(static_cast<int64_t>(m_firstRow) * m_rowHeight - sy);
+
+	ElementInfo rootInfo{};
+	rootInfo.appearance = info.appearance;
+	PackStylesToInfo(rootInfo, w_fill, h_fill, up_down, overflow_hidden);
+
+	SableUI::StartDiv(rootInfo);
+
+	Div(w_fill, h(m_rowHeight + 4), left_right, overflow_hidden, bg(t.surface0))
+	{
+		Div(w_fit, h_fill, left_right, ml(colMargin))
+		{
+			for (size_t slot = 0; slot < m_numCols; slot++)
+			{
+				size_t col = m_firstCol + slot;
+				SableString label = m_provider->GetColumnName(col);
+
+				if (s.sortColumn == static_cast<int>(col))
+					label = label + (s.ascending ? " ^" : " v");
+
+				Div(w(s.widths[col]), h_fill, left_right, onClick([this, col]() { ToggleSort(col); }))
+				{
+					Text(label, w_fill, textWrap(false), ml(CELL_PADDING), centerY, textColour(t.text));
+					RectElement(id(m_handleIds[slot]), w(RESIZE_HANDLE_WIDTH), h_fill, bg(t.surface2));
+				}
+			}
+		}
+	}
+
+	// rows and columns occupy slots relative to the first materialised cell so
+	// the element tree keeps the same shape while scrolling
+	Div(id(m_bodyId), w_fill, h_fill, up_down, overflow_hidden)
+	{
+		Div(w_fit, h_fit, up_down, mt(rowMargin), ml(colMargin))
+		{
+			for (size_t r = 0; r < m_numRows; r++)
+			{
+				size_t row = m_firstRow + r;
+				size_t source = GetSourceRow(row);
+
+				Div(key(source), w_fit, h(m_rowHeight), left_right, bg((row & 1) ? t.mantle : t.base))
+				{
+					for (size_t slot = 0; slot < m_numCols; slot++)
+					{
+						size_t col = m_firstCol + slot;
+
+						Div(key(col), w(s.widths[col]), h_fill, overflow_hidden)
+						{
+							Text(m_provider->GetCell(source, col), w_fill, textWrap(false), ml(CELL_PADDING), centerY);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	SableUI::EndDiv();
+}
+
+void DataGrid::OnUpdate(const UIEventContext& ctx)
+{
+	if (!m_provider) return;
+	DataGridState& s = GetGridState();
+
+	// pick up a finished sort/filter
+	if (s.job && s.job->done.load())
+	{
+		s.rows = std::move(s.job->rows);
+		s.identity = false;
+		s.job = nullptr;
+		resultVersion.set(resultVersion.get() + 1);
+		SetScroll(scrollX.get(), scrollY.get());
+	}
+
+	if (resizingColumn.get() >= 0)
+	{
+		if (ctx.mouseReleased.test(SABLE_MOUSE_BUTTON_LEFT))
+		{
+			resizingColumn.set(-1);
+			return;
+		}
+
+		// only the prefix sums change, offscreen cells are never built
+		size_t col = static_cast<size_t>(resizingColumn.get());
+		int width = std::max(MIN_COLUMN_WIDTH, resizeStartWidth.get() + ctx.mousePos.x - resizeOrigX.get());
+		if (col < s.widths.size() && s.widths[col] != width)
+		{
+			s.widths[col] = width;
+			s.RebuildOffsets();
+			MarkDirty();
+		}
+		return;
+	}
+
+	if (ctx.mousePressed.test(SABLE_MOUSE_BUTTON_LEFT))
+	{
+		for (size_t slot = 0; slot < m_numCols && slot < m_handleIds.size(); slot++)
+		{
+			Element* handleEl = GetElementById(m_handleIds[slot]);
+			if (handleEl && RectBoundingBox(handleEl->rect, ctx.mousePos))
+			{
+				size_t col = m_firstCol + slot;
+				resizingColumn.set(static_cast<int>(col));
+				resizeOrigX.set(ctx.mousePos.x);
+				resizeStartWidth.set(s.widths[col]);
+				return;
+			}
+		}
+	}
+
+	Element* bodyEl = GetElementById(m_bodyId);
+	if (!bodyEl) return;
+
+	if ((ctx.scrollDelta.x != 0 || ctx.scrollDelta.y != 0) && RectBoundingBox(bodyEl->rect, ctx.mousePos))
+	{
+		SetScroll(
+			scrollX.get() - static_cast<int>(ctx.scrollDelta.x * SCROLL_STEP),
+			scrollY.get() - static_cast<int64_t>(ctx.scrollDelta.y * SCROLL_STEP));
+	}
+}
+
+void DataGrid::OnUpdatePostLayout(const UIEventContext& ctx)
+{
+	if (Element* bodyEl = GetElementById(m_bodyId))
+	{
+		viewportWidth.set(bodyEl->rect.w);
+		viewportHeight.set(bodyEl->rect.h);
+	}
+}
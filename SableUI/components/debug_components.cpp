@@ -1,6 +1,7 @@
 #include <SableUI/components/debug_components.h>
 #include <SableUI/SableUI.h>
 #include <SableUI/core/component.h>
+#include <SableUI/core/dirty_queue.h>
 #include <SableUI/core/drawable.h>
 #include <SableUI/core/element.h>
 #include <SableUI/core/events.h>
@@ -10,6 +11,7 @@
 #include <SableUI/core/tab_context.h>
 #include <SableUI/core/text.h>
 #include <SableUI/core/texture.h>
+#include <SableUI/core/window.h>
 #include <SableUI/styles/styles.h>
 #include <SableUI/utils/console.h>
 #include <SableUI/utils/memory.h>
@@ -102,6 +104,39 @@ void SableUI::MemoryDebugger::Layout()
 			VirtualNode::GetNumInstances(),
 			SableMemory::GetSizeData(SableMemory::PoolType::VirtualNode).sizeInKB));
 
+		const ReconcileStats& rs = Element::GetReconcileStats();
+		Text(SableString::Format("Reconcile: %llu unchanged, %llu paint, %llu layout",
+			static_cast<unsigned long long>(rs.unchanged),
+			static_cast<unsigned long long>(rs.paintPatches),
+			static_cast<unsigned long long>(rs.layoutPatches)));
+		Text(SableString::Format("Reconcile: %llu created, %llu removed, %llu moved",
+			static_cast<unsigned long long>(rs.created),
+			static_cast<unsigned long long>(rs.removed),
+			static_cast<unsigned long long>(rs.moved)));
+
+		const StyleInternStats& ls = StyleRef<LayoutProps>::GetInternStats();
+		const StyleInternStats& as = StyleRef<AppearanceProps>::GetInternStats();
+		Text(SableString::Format("Style records: %zu layout, %zu appearance (%llu hits, %llu misses)",
+			ls.records, as.records,
+			static_cast<unsigned long long>(ls.hits + as.hits),
+			static_cast<unsigned long long>(ls.misses + as.misses)));
+
+		const ComponentReuseStats& cs = BaseComponent::GetReuseStats();
+		Text(SableString::Format("Components: %llu created, %llu reused, %llu memoised",
+			static_cast<unsigned long long>(cs.created),
+			static_cast<unsigned long long>(cs.reused),
+			static_cast<unsigned long long>(cs.memoSkipped)));
+
+		if (Window* window = GetContext())
+		{
+			const DirtyQueueStats& ds = window->GetDirtyQueue().GetStats();
+			Text(SableString::Format("Dirty queue: %llu queued, %llu rerendered, %llu repainted, %llu covered",
+				static_cast<unsigned long long>(ds.queued),
+				static_cast<unsigned long long>(ds.rerendered),
+				static_cast<unsigned long long>(ds.repainted),
+				static_cast<unsigned long long>(ds.covered)));
+		}
+
 		TextSeperator("Drawables");
 		Text(SableString::Format("Drawable Base: %d", DrawableBase::GetNumInstances()));
 		Text(SableString::Format("Drawable Text: %d    (%zukb)",
@@ -131,12 +166,32 @@ void SableUI::MemoryDebugger::Layout()
 		Text(SableString::Format("Font Packs: %d", FontPack::GetNumInstances()));
 		Text(SableString::Format("Font Ranges: %d", FontRange::GetNumInstances()));
 
+		AtlasStats atlas = GetFontAtlasStats();
+		Text(SableString::Format("Atlas: %d/%d layers, %.1f%% occupied, %llu evicted, %llu over budget",
+			atlas.layers, atlas.layerBudget, atlas.occupancy * 100.0f,
+			static_cast<unsigned long long>(atlas.evictedEntries),
+			static_cast<unsigned long long>(atlas.overBudget)));
+		Text(SableString::Format("Glyphs: %s", GetGlyphRenderMode() == GlyphRenderMode::SDF ? "SDF" : "Bitmap"));
+
+		ParagraphCacheStats paragraphs = GetParagraphCacheStats();
+		Text(SableString::Format("Shaped Lines: %zu, %zukb/%zukb, %llu hits, %llu misses",
+			paragraphs.lines, paragraphs.bytes / 1024, paragraphs.budget / 1024,
+			static_cast<unsigned long long>(paragraphs.hits),
+			static_cast<unsigned long long>(paragraphs.misses)));
+
 		int instanceCount = 0;
 		for (const TextCacheFactory* factory : TextCacheFactory::GetFactories())
 		{
 			instanceCount++;
-			Text(SableString::Format("Instance %d Text Cache: %d",
-				instanceCount, factory->GetNumInstances()));
+			TextCacheStats stats = factory->GetStats();
+			Text(SableString::Format("Instance %d Text Cache: %d (%zu idle), %zukb/%zukb",
+				instanceCount, factory->GetNumInstances(), stats.idleEntries,
+				stats.bytes / 1024, stats.budget / 1024));
+			Text(SableString::Format("Instance %d Text Cache: %llu hits, %llu misses, %llu evicted",
+				instanceCount,
+				static_cast<unsigned long long>(stats.hits),
+				static_cast<unsigned long long>(stats.misses),
+				static_cast<unsigned long long>(stats.evictions)));
 		}
 	}
 }
@@ -233,23 +288,23 @@ void SableUI::PropertiesPanel::Layout()
 		Text(selectedRect.get().ToString(), mb(8));
 
 		Text("Layout Direction", textColour(180, 180, 180), mb(2));
-		Text(LayoutDirectionToString(info.layout.layoutDirection), mb(8));
+		Text(LayoutDirectionToString(info.layout->layoutDirection), mb(8));
 
 		Text("Constraints", textColour(180, 180, 180), mb(2));
 		Text(SableString::Format("{ min-h: %d, max-h: %d }",
-			info.layout.minH, info.layout.maxH), mb(2));
+			info.layout->minH, info.layout->maxH), mb(2));
 		Text(SableString::Format("{ min-w: %d, max-w: %d }",
-			info.layout.minW, info.layout.maxW), mb(8));
+			info.layout->minW, info.layout->maxW), mb(8));
 
 		Text("Margins", textColour(180, 180, 180), mb(2));
 		Text(SableString::Format("{ top: %d, right: %d, bottom: %d, left: %d }",
-			info.layout.mT, info.layout.mR,
-			info.layout.mB, info.layout.mL), mb(8));
+			info.layout->mT, info.layout->mR,
+			info.layout->mB, info.layout->mL), mb(8));
 
 		Text("Padding", textColour(180, 180, 180), mb(2));
 		Text(SableString::Format("{ top: %d, right: %d, bottom: %d, left: %d }",
-			info.layout.pT, info.layout.pR,
-			info.layout.pB, info.layout.pL), mb(8));
+			info.layout->pT, info.layout->pR,
+			info.layout->pB, info.layout->pL), mb(8));
 
 		Text("Text Properties", textColour(180, 180, 180), mb(2));
 		Text("Font Size: " + std::to_string(info.text.fontSize), mb(2));
@@ -257,14 +312,14 @@ void SableUI::PropertiesPanel::Layout()
 		Text("Text justification: " + TextJustificationToString(info.text.justification.value_or(TextJustification::Left)), mb(8));
 
 		Text("Positioning", textColour(180, 180, 180), mb(2));
-		Text(SableString::Format("Center X: %s", info.layout.centerX ? "true" : "false"), mb(2));
-		Text(SableString::Format("Center Y: %s", info.layout.centerY ? "true" : "false"), mb(8));
+		Text(SableString::Format("Center X: %s", info.layout->centerX ? "true" : "false"), mb(2));
+		Text(SableString::Format("Center Y: %s", info.layout->centerY ? "true" : "false"), mb(8));
 
 		Text("Clip rect", textColour(180, 180, 180), mb(2));
 		Text(selectedClipRect.get().ToString(), mb(8));
 
 		Text("Background Colour", textColour(180, 180, 180), mb(2));
-		RectElement(w(20), h(20), bg(info.appearance.bg.value_or(Colour{ 0, 0, 0, 0 })));
+		RectElement(w(20), h(20), bg(info.appearance->bg.value_or(Colour{ 0, 0, 0, 0 })));
 	}
 }
 
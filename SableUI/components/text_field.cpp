@@ -12,19 +12,26 @@
 
 using namespace SableUI::Style;
 
-static int GetNextWordPos(const SableString& text, int cursorPos, int direction)
+// undo steps kept per field, snapshots share all unchanged text
+constexpr size_t MAX_UNDO_STEPS = 256;
+
+static int GetNextWordPos(const SableUI::TextBuffer& text, int cursorPos, int direction)
 {
-	for (int i = cursorPos + direction; i < text.size() && i >= 0; i += direction)
-		if (text[i] == ' ' || text[i] == '\t' || text[i] == '\n')
+	int length = static_cast<int>(text.size());
+	for (int i = cursorPos + direction; i < length && i >= 0; i += direction)
+	{
+		char32_t c = text.At(static_cast<size_t>(i));
+		if (c == ' ' || c == '\t' || c == '\n')
 			return i;
+	}
 
 	if (direction == -1)
 		return 0;
 	else
-		return text.size();
+		return length;
 }
 
-static void DeleteSelection(SableString& text, int& cursorPos, const int& initialCursorPos)
+static void DeleteSelection(SableUI::TextBuffer& text, int& cursorPos, const int& initialCursorPos)
 {
 	int selStart = std::min(cursorPos, initialCursorPos);
 	int selEnd = std::max(cursorPos, initialCursorPos);
@@ -32,8 +39,7 @@ static void DeleteSelection(SableString& text, int& cursorPos, const int& initia
 	selStart = std::max(0, selStart);
 	selEnd = std::max(0, selEnd);
 
-	text = text.substr(0, static_cast<size_t>(selStart)) +
-		text.substr(static_cast<size_t>(selEnd));
+	text.Erase(static_cast<size_t>(selStart), static_cast<size_t>(selEnd - selStart));
 
 	cursorPos = selStart;
 }
@@ -52,10 +58,18 @@ void SableUI::TextFieldComponent::Init(State<InputFieldData>& data, const Elemen
 
 void SableUI::TextFieldComponent::ResetCursorBlink()
 {
-	cursorVisible.set(true);
+	SetCaretVisible(true);
 	m_cursorBlinkInterval.Reset();
 }
 
+void SableUI::TextFieldComponent::SetCaretVisible(bool visible)
+{
+	if (m_caretVisible == visible) return;
+
+	m_caretVisible = visible;
+	m_caretDirty = true;
+}
+
 void SableUI::TextFieldComponent::TriggerOnChange()
 {
 	if (externalState && externalState->get().onChange)
@@ -66,6 +80,9 @@ void SableUI::TextFieldComponent::TriggerOnChange()
 
 void SableUI::TextFieldComponent::Layout()
 {
+	// text, cursor or focus changed, place the caret again after layout
+	m_caretDirty = true;
+
 	if (!externalState) return;
 	const InputFieldData& data = externalState->get();
 
@@ -76,29 +93,29 @@ void SableUI::TextFieldComponent::Layout()
 		return;
 	}
 
-	Colour bgColour = info.appearance.bg.value_or(t.surface0);
+	Colour bgColour = info.appearance->bg.value_or(t.surface0);
 	Colour textCol = info.text.colour.value_or(t.text);
 	Colour placeholderCol = t.subtext0;
 
 	ElementInfo containerInfo = info;
-	containerInfo.appearance.bg = bgColour;
-	containerInfo.appearance.rTL = info.appearance.rTL > 0.0f ? info.appearance.rTL : 4.0f;
-	containerInfo.appearance.rTR = info.appearance.rTR > 0.0f ? info.appearance.rTR : 4.0f;
-	containerInfo.appearance.rBL = info.appearance.rBL > 0.0f ? info.appearance.rBL : 4.0f;
-	containerInfo.appearance.rBR = info.appearance.rBR > 0.0f ? info.appearance.rBR : 4.0f;
+	containerInfo.appearance.mut().bg = bgColour;
+	containerInfo.appearance.mut().rTL = info.appearance->rTL > 0.0f ? info.appearance->rTL : 4.0f;
+	containerInfo.appearance.mut().rTR = info.appearance->rTR > 0.0f ? info.appearance->rTR : 4.0f;
+	containerInfo.appearance.mut().rBL = info.appearance->rBL > 0.0f ? info.appearance->rBL : 4.0f;
+	containerInfo.appearance.mut().rBR = info.appearance->rBR > 0.0f ? info.appearance->rBR : 4.0f;
 
-	if (containerInfo.layout.wType == RectType::Undef) containerInfo.layout.wType = RectType::Fill;
-	if (containerInfo.layout.hType == RectType::Undef) containerInfo.layout.hType = RectType::FitContent;
+	if (containerInfo.layout->wType == RectType::Undef) containerInfo.layout.mut().wType = RectType::Fill;
+	if (containerInfo.layout->hType == RectType::Undef) containerInfo.layout.mut().hType = RectType::FitContent;
 
-	containerInfo.layout.layoutDirection = LayoutDirection::LeftRight;
+	containerInfo.layout.mut().layoutDirection = LayoutDirection::LeftRight;
 	
 	ElementInfo centerInfo{};
-	centerInfo.layout.pT = (info.layout.pT == 0) ? 4 : info.layout.pT;
-	centerInfo.layout.pB = (info.layout.pB == 0) ? 4 : info.layout.pB;
-	centerInfo.layout.pR = (info.layout.pR == 0) ? 4 : info.layout.pR;
-	centerInfo.layout.pL = (info.layout.pL == 0) ? 4 : info.layout.pL;
+	centerInfo.layout.mut().pT = (info.layout->pT == 0) ? 4 : info.layout->pT;
+	centerInfo.layout.mut().pB = (info.layout->pB == 0) ? 4 : info.layout->pB;
+	centerInfo.layout.mut().pR = (info.layout->pR == 0) ? 4 : info.layout->pR;
+	centerInfo.layout.mut().pL = (info.layout->pL == 0) ? 4 : info.layout->pL;
 	centerInfo.id = "TextField";
-	centerInfo.layout.wType = RectType::Fill;
+	centerInfo.layout.mut().wType = RectType::Fill;
 
 	PackStylesToInfo(containerInfo);
 
@@ -122,14 +139,64 @@ void SableUI::TextFieldComponent::Layout()
 	}
 }
 
+void SableUI::TextFieldComponent::SyncBuffer(const SableString& content)
+{
+	// flattened content shares its buffer with what was handed out last update
+	const SableString& current = m_buffer.ToString();
+	if (content.begin() == current.begin() && content.size() == current.size())
+		return;
+
+	if (content == current)
+		return;
+
+	// set from outside the field, the old history no longer applies
+	m_buffer.Assign(content);
+	m_undo.clear();
+	m_redo.clear();
+	m_typingRun = false;
+
+	int length = static_cast<int>(m_buffer.size());
+	if (cursorPos > length) cursorPos.set(length);
+	if (initialCursorPos > length) initialCursorPos.set(-1);
+}
+
+void SableUI::TextFieldComponent::PushUndo(bool typing)
+{
+	// the first char of a run of typing records the step for all of it
+	if (typing && m_typingRun) return;
+	m_typingRun = typing;
+
+	m_undo.push_back({ m_buffer.GetSnapshot(), cursorPos.get() });
+	if (m_undo.size() > MAX_UNDO_STEPS)
+		m_undo.erase(m_undo.begin());
+
+	m_redo.clear();
+}
+
+bool SableUI::TextFieldComponent::StepHistory(std::vector<UndoStep>& from, std::vector<UndoStep>& to)
+{
+	if (from.empty()) return false;
+
+	to.push_back({ m_buffer.GetSnapshot(), cursorPos.get() });
+
+	m_buffer.Restore(from.back().snapshot);
+	cursorPos.set(std::min(from.back().cursor, static_cast<int>(m_buffer.size())));
+	initialCursorPos.set(-1);
+	m_typingRun = false;
+
+	from.pop_back();
+	return true;
+}
+
 void SableUI::TextFieldComponent::OnUpdate(const UIEventContext& ctx)
 {
 	if (!externalState) return;
 	InputFieldData dataCopy = externalState->get();
+	SyncBuffer(dataCopy.content);
 
 	if (ctx.IsFired(m_cursorBlinkInterval.GetHandle()))
 	{
-		cursorVisible.set(!cursorVisible.get());
+		SetCaretVisible(!m_caretVisible);
 	}
 
 	bool ctrlDown = (ctx.isKeyDown.test(SABLE_KEY_LEFT_CONTROL) || ctx.isKeyDown.test(SABLE_KEY_RIGHT_CONTROL));
@@ -138,6 +205,8 @@ void SableUI::TextFieldComponent::OnUpdate(const UIEventContext& ctx)
 	bool vPressed = ctx.keyPressedEvent.test(SABLE_KEY_V);
 	bool cPressed = ctx.keyPressedEvent.test(SABLE_KEY_C);
 	bool xPressed = ctx.keyPressedEvent.test(SABLE_KEY_X);
+	bool zPressed = ctx.keyPressedEvent.test(SABLE_KEY_Z);
+	bool yPressed = ctx.keyPressedEvent.test(SABLE_KEY_Y);
 	bool change = false;
 	
 	if (dataCopy.isFocused && ctrlDown && (cPressed || xPressed))
@@ -148,17 +217,16 @@ void SableUI::TextFieldComponent::OnUpdate(const UIEventContext& ctx)
 			int selEnd = std::max(cursorPos.get(), initialCursorPos.get());
 			size_t count = static_cast<size_t>(selEnd - selStart);
 
-			SableString selectedText = dataCopy.content.substr(selStart, count);
+			SableString selectedText = m_buffer.Substr(selStart, count);
 			SetClipboardContent(selectedText);
 
 			if (xPressed)
 			{
-				SableString baseText = dataCopy.content;
 				int newCursor = cursorPos;
 
-				DeleteSelection(baseText, newCursor, initialCursorPos.get());
+				PushUndo(false);
+				DeleteSelection(m_buffer, newCursor, initialCursorPos.get());
 
-				dataCopy.content = baseText;
 				cursorPos.set(newCursor);
 				initialCursorPos.set(-1);
 				change = true;
@@ -172,17 +240,8 @@ void SableUI::TextFieldComponent::OnUpdate(const UIEventContext& ctx)
 
 		if (!clipboardText.empty())
 		{
-			SableString baseText = dataCopy.content;
 			int newCursor = cursorPos;
 
-			if (sectionHighlighted)
-			{
-				DeleteSelection(baseText, newCursor, initialCursorPos.get());
-			}
-
-			SableString L = baseText.substr(0, static_cast<size_t>(newCursor));
-			SableString R = baseText.substr(static_cast<size_t>(newCursor));
-
 			if (!m_multiline)
 			{
 				for (size_t i = 0; i < clipboardText.size(); i++)
@@ -195,7 +254,14 @@ void SableUI::TextFieldComponent::OnUpdate(const UIEventContext& ctx)
 				}
 			}
 
-			dataCopy.content = L + clipboardText + R;
+			PushUndo(false);
+
+			if (sectionHighlighted)
+			{
+				DeleteSelection(m_buffer, newCursor, initialCursorPos.get());
+			}
+
+			m_buffer.Insert(static_cast<size_t>(newCursor), clipboardText);
 			cursorPos.set(newCursor + static_cast<int>(clipboardText.size()));
 
 			initialCursorPos.set(-1);
@@ -203,6 +269,13 @@ void SableUI::TextFieldComponent::OnUpdate(const UIEventContext& ctx)
 		}
 	}
 
+	if (dataCopy.isFocused && ctrlDown && (zPressed || yPressed))
+	{
+		bool redo = yPressed || shiftDown;
+		if (redo ? StepHistory(m_redo, m_undo) : StepHistory(m_undo, m_redo))
+			change = true;
+	}
+
 	if (ctx.keyPressedEvent.test(SABLE_KEY_LEFT_SHIFT) || ctx.keyPressedEvent.test(SABLE_KEY_RIGHT_SHIFT))
 	{
 		initialCursorPos.set(cursorPos);
@@ -231,13 +304,14 @@ void SableUI::TextFieldComponent::OnUpdate(const UIEventContext& ctx)
 		if (el)
 		{
 			bool clickedInside = RectBoundingBox(el->rect, ctx.mousePos);
+			m_typingRun = false;
 
 			if (clickedInside)
 			{
 				if (!dataCopy.isFocused)
 				{
 					dataCopy.isFocused = true;
-					cursorVisible.set(true);
+					SetCaretVisible(true);
 					m_cursorBlinkInterval.Start(500);
 					change = true;
 				}
@@ -259,31 +333,32 @@ void SableUI::TextFieldComponent::OnUpdate(const UIEventContext& ctx)
 	if (!dataCopy.isFocused)
 	{
 		if (change)
+		{
+			dataCopy.content = m_buffer.ToString();
 			externalState->set(dataCopy);
+		}
 		return;
 	}
 
 	if (ctx.typedCharBuffer.size() != 0)
 	{
-		SableString baseText = dataCopy.content;
 		int newCursor = cursorPos;
 
+		PushUndo(!sectionHighlighted);
+
 		if (sectionHighlighted)
-			DeleteSelection(baseText, newCursor, initialCursorPos.get());
+			DeleteSelection(m_buffer, newCursor, initialCursorPos.get());
 
-		SableString newText = baseText.substr(0, newCursor);
 		for (unsigned int c : ctx.typedCharBuffer)
 		{
 			if (!m_multiline && (c == '\n' || c == '\r'))
 				continue;
 
-			newText.push_back((char32_t)c);
+			m_buffer.Insert(static_cast<size_t>(newCursor), static_cast<char32_t>(c));
+			newCursor++;
 		}
 
-		newText = newText + baseText.substr(newCursor);
-
-		dataCopy.content = newText;
-		cursorPos.set(newCursor + ctx.typedCharBuffer.size());
+		cursorPos.set(newCursor);
 		initialCursorPos.set(-1);
 		change = true;
 	}
@@ -292,27 +367,27 @@ void SableUI::TextFieldComponent::OnUpdate(const UIEventContext& ctx)
 	{
 		if (sectionHighlighted)
 		{
-			SableString newText = dataCopy.content;
 			int newCursor = cursorPos;
 			int init = initialCursorPos;
 
-			DeleteSelection(newText, newCursor, init);
+			PushUndo(false);
+			DeleteSelection(m_buffer, newCursor, init);
 
-			dataCopy.content = newText;
 			cursorPos.set(newCursor);
 			initialCursorPos.set(-1);
 		}
 		else if (ctrlDown)
 		{
-			int delTo = GetNextWordPos(dataCopy.content, cursorPos, -1);
-			SableString newText = dataCopy.content.substr(0, delTo) + dataCopy.content.substr(cursorPos);
-			dataCopy.content = newText;
+			int delTo = GetNextWordPos(m_buffer, cursorPos, -1);
+
+			PushUndo(false);
+			m_buffer.Erase(static_cast<size_t>(delTo), static_cast<size_t>(cursorPos - delTo));
 			cursorPos.set(delTo);
 		}
 		else if (cursorPos > 0)
 		{
-			SableString newText = dataCopy.content.substr(0, cursorPos - 1) + dataCopy.content.substr(cursorPos);
-			dataCopy.content = newText;
+			PushUndo(false);
+			m_buffer.Erase(static_cast<size_t>(cursorPos - 1), 1);
 			cursorPos.set(cursorPos - 1);
 		}
 		change = true;
@@ -322,26 +397,26 @@ void SableUI::TextFieldComponent::OnUpdate(const UIEventContext& ctx)
 	{
 		if (sectionHighlighted)
 		{
-			SableString newText = dataCopy.content;
 			int newCursor = cursorPos;
 			int init = initialCursorPos;
 
-			DeleteSelection(newText, newCursor, init);
+			PushUndo(false);
+			DeleteSelection(m_buffer, newCursor, init);
 
-			dataCopy.content = newText;
 			cursorPos.set(newCursor);
 			initialCursorPos.set(-1);
 		}
 		else if (ctrlDown)
 		{
-			int delTo = GetNextWordPos(dataCopy.content, cursorPos, 1);
-			SableString newText = dataCopy.content.substr(0, cursorPos) + dataCopy.content.substr(delTo);
-			dataCopy.content = newText;
+			int delTo = GetNextWordPos(m_buffer, cursorPos, 1);
+
+			PushUndo(false);
+			m_buffer.Erase(static_cast<size_t>(cursorPos.get()), static_cast<size_t>(delTo - cursorPos));
 		}
-		else if (cursorPos < dataCopy.content.size())
+		else if (cursorPos < static_cast<int>(m_buffer.size()))
 		{
-			SableString newText = dataCopy.content.substr(0, cursorPos) + dataCopy.content.substr(cursorPos + 1);
-			dataCopy.content = newText;
+			PushUndo(false);
+			m_buffer.Erase(static_cast<size_t>(cursorPos.get()), 1);
 		}
 		change = true;
 	}
@@ -350,17 +425,15 @@ void SableUI::TextFieldComponent::OnUpdate(const UIEventContext& ctx)
 	{
 		if (m_multiline)
 		{
-			SableString baseText = dataCopy.content;
 			int newCursor = cursorPos;
 
+			PushUndo(false);
+
 			if (sectionHighlighted)
-				DeleteSelection(baseText, newCursor, initialCursorPos);
+				DeleteSelection(m_buffer, newCursor, initialCursorPos);
 
-			SableString newText = baseText.substr(0, newCursor);
-			newText.push_back(U'\n');
-			newText = newText + baseText.substr(newCursor);
+			m_buffer.Insert(static_cast<size_t>(newCursor), U'\n');
 
-			dataCopy.content = newText;
 			cursorPos.set(newCursor + 1);
 			initialCursorPos.set(-1);
 			change = true;
@@ -380,13 +453,14 @@ void SableUI::TextFieldComponent::OnUpdate(const UIEventContext& ctx)
 			cursorPos.set(std::min(cursorPos.get(), initialCursorPos.get()));
 
 		if (ctrlDown)
-			cursorPos.set(GetNextWordPos(dataCopy.content, cursorPos, -1));
+			cursorPos.set(GetNextWordPos(m_buffer, cursorPos, -1));
 		else if (cursorPos > 0)
 			cursorPos.set(cursorPos - 1);
 
 		if (!shiftDown)
 			initialCursorPos.set(-1);
 
+		m_typingRun = false;
 		change = true;
 	}
 
@@ -396,20 +470,22 @@ void SableUI::TextFieldComponent::OnUpdate(const UIEventContext& ctx)
 			cursorPos.set(std::max(cursorPos.get(), initialCursorPos.get()));
 
 		if (ctrlDown)
-			cursorPos.set(GetNextWordPos(dataCopy.content, cursorPos, +1));
-		else if (cursorPos < dataCopy.content.size())
+			cursorPos.set(GetNextWordPos(m_buffer, cursorPos, +1));
+		else if (cursorPos < static_cast<int>(m_buffer.size()))
 			cursorPos.set(cursorPos + 1);
 
 		if (!shiftDown)
 			initialCursorPos.set(-1);
 
+		m_typingRun = false;
 		change = true;
 	}
 
+	dataCopy.content = m_buffer.ToString();
+
 	if (change)
 	{
-		cursorVisible.set(true);
-		m_cursorBlinkInterval.Reset();
+		ResetCursorBlink();
 		TriggerOnChange();
 	}
 
@@ -420,6 +496,13 @@ void SableUI::TextFieldComponent::OnUpdatePostLayout(const UIEventContext& ctx)
 {
 	if (!externalState || !externalState->get().isFocused || !m_window) return;
 
+	// runs every frame, only rebuild the overlay when the caret changed
+	if (!m_caretDirty && m_caretEpoch == Element::GetLayoutEpoch())
+		return;
+
+	m_caretDirty = false;
+	m_caretEpoch = Element::GetLayoutEpoch();
+
 	if (!queueInitialised)
 	{
 		queue.window = m_window;
@@ -430,22 +513,17 @@ void SableUI::TextFieldComponent::OnUpdatePostLayout(const UIEventContext& ctx)
 	StartCustomLayoutScope(&queue);
 
 	Element* text = GetElementById("TextFieldText");
-	if (!text)
+	// caret queries reuse the line breaks cached on the drawn text
+	_Text* fieldText = text ? text->GetText() : nullptr;
+	if (!fieldText)
 	{
 		EndCustomLayoutScope(&queue);
 		return;
 	}
 
-	auto cursorInfo = QueryCursorPosition(
-		externalState->get().content,
-		cursorPos,
-		text->rect.w,
-		text->info.text.fontSize,
-		text->info.text.lineHeight,
-		text->info.text.justification.value_or(TextJustification::Left)
-	);
+	CursorPosition cursorInfo = fieldText->GetCursorPosition(cursorPos);
 
-	if (cursorVisible.get())
+	if (m_caretVisible)
 	{
 		Rect cursorRect = {
 			text->rect.x + cursorInfo.x,
@@ -459,14 +537,7 @@ void SableUI::TextFieldComponent::OnUpdatePostLayout(const UIEventContext& ctx)
 
 	if (initialCursorPos >= 0 && initialCursorPos != cursorPos)
 	{
-		auto initialCursorInfo = QueryCursorPosition(
-			externalState->get().content,
-			initialCursorPos,
-			text->rect.w,
-			text->info.text.fontSize,
-			text->info.text.lineHeight,
-			text->info.text.justification.value_or(TextJustification::Left)
-		);
+		CursorPosition initialCursorInfo = fieldText->GetCursorPosition(initialCursorPos);
 
 		if (cursorInfo.lineIndex == initialCursorInfo.lineIndex)
 		{
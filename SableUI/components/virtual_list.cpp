@@ -0,0 +1,308 @@
+#include <SableUI/components/virtual_list.h>
+#include <SableUI/SableUI.h>
+#include <SableUI/styles/styles.h>
+#include <SableUI/styles/theme.h>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+
+using namespace SableUI;
+using namespace SableUI::Style;
+
+constexpr int SCROLL_STEP = 50;
+constexpr int BAR_PADDING = 4;
+constexpr int MIN_THUMB_HEIGHT = 16;
+
+// ============================================================================
+// RowHeightIndex
+// ============================================================================
+void RowHeightIndex::Reset(size_t rowCount, int estimatedHeight)
+{
+	m_heights.assign(rowCount, estimatedHeight);
+	m_tree.assign(rowCount + 1, 0);
+
+	// O(n) fenwick build
+	for (size_t i = 1; i <= rowCount; i++)
+	{
+		m_tree[i] += m_heights[i - 1];
+		size_t parent = i + (i & (~i + 1));
+		if (parent <= rowCount)
+			m_tree[parent] += m_tree[i];
+	}
+}
+
+bool RowHeightIndex::SetHeight(size_t row, int height)
+{
+	// a row that has not been laid out has no height to report
+	if (row >= m_heights.size() || height <= 0 || m_heights[row] == height)
+		return false;
+
+	int64_t delta = static_cast<int64_t>(height) - m_heights[row];
+	m_heights[row] = height;
+
+	for (size_t i = row + 1; i < m_tree.size(); i += i & (~i + 1))
+		m_tree[i] += delta;
+
+	return true;
+}
+
+int64_t RowHeightIndex::GetOffset(size_t row) const
+{
+	int64_t sum = 0;
+	for (size_t i = std::min(row, m_heights.size()); i > 0; i -= i & (~i + 1))
+		sum += m_tree[i];
+
+	return sum;
+}
+
+size_t RowHeightIndex::FindRow(int64_t offset) const
+{
+	size_t n = m_heights.size();
+	if (n == 0) return 0;
+
+	size_t step = 1;
+	while (step * 2 <= n) step *= 2;
+
+	// largest number of whole rows that fit before offset
+	size_t pos = 0;
+	for (; step > 0; step /= 2)
+	{
+		if (pos + step <= n && m_tree[pos + step] <= offset)
+		{
+			pos += step;
+			offset -= m_tree[pos];
+		}
+	}
+
+	return std::min(pos, n - 1);
+}
+
+// ============================================================================
+// VirtualList
+// ============================================================================
+void VirtualList::Init(size_t rowCount, int rowHeight, RowBuilder builder, const ElementInfo& p_info)
+{
+	info = p_info;
+	m_rowCount = rowCount;
+	m_rowHeight = std::max(1, rowHeight);
+	m_estimated = false;
+	m_builder = std::move(builder);
+}
+
+void VirtualList::InitEstimated(size_t rowCount, int estimatedRowHeight, RowBuilder builder, const ElementInfo& p_info)
+{
+	Init(rowCount, estimatedRowHeight, std::move(builder), p_info);
+	m_estimated = true;
+}
+
+int64_t VirtualList::GetContentHeight()
+{
+	if (m_estimated && heights.get())
+		return heights.get()->GetTotalHeight();
+
+	return static_cast<int64_t>(m_rowCount) * m_rowHeight;
+}
+
+int64_t VirtualList::GetRowOffset(size_t row)
+{
+	if (m_estimated && heights.get())
+		return heights.get()->GetOffset(row);
+
+	return static_cast<int64_t>(row) * m_rowHeight;
+}
+
+size_t VirtualList::GetRowAt(int64_t offset)
+{
+	if (m_rowCount == 0) return 0;
+
+	if (m_estimated && heights.get())
+		return heights.get()->FindRow(offset);
+
+	return std::min(static_cast<size_t>(std::max<int64_t>(0, offset) / m_rowHeight), m_rowCount - 1);
+}
+
+int64_t VirtualList::GetMaxScroll()
+{
+	return std::max<int64_t>(0, GetContentHeight() - viewportHeight.get());
+}
+
+int VirtualList::GetThumbHeight()
+{
+	int vpH = viewportHeight.get();
+	int64_t contentH = GetContentHeight();
+	if (contentH <= 0) return vpH;
+
+	double fac = static_cast<double>(vpH) / static_cast<double>(contentH);
+	return std::max(MIN_THUMB_HEIGHT, static_cast<int>(fac * vpH));
+}
+
+void VirtualList::SetScroll(int64_t y)
+{
+	scrollY.set(std::clamp<int64_t>(y, 0, GetMaxScroll()));
+}
+
+void VirtualList::ScrollToRow(size_t row)
+{
+	if (m_rowCount == 0) return;
+	SetScroll(GetRowOffset(std::min(row, m_rowCount - 1)));
+}
+
+void VirtualList::Layout()
+{
+	if (m_estimated && (!heights.get() || heights.get()->GetRowCount() != m_rowCount))
+	{
+		auto index = std::make_shared<RowHeightIndex>();
+		index->Reset(m_rowCount, m_rowHeight);
+		heights.set(index);
+	}
+
+	const Theme& t = GetTheme();
+	int vpH = viewportHeight.get();
+	int64_t scroll = std::clamp<int64_t>(scrollY.get(), 0, GetMaxScroll());
+
+	// visible window plus overscan, viewport height is unknown until the first layout
+	m_firstRow = 0;
+	m_numRows = 0;
+	if (m_rowCount > 0 && m_builder)
+	{
+		size_t first = GetRowAt(scroll);
+		size_t last = (vpH > 0) ? GetRowAt(scroll + vpH - 1) + 1 : first + 1;
+		size_t overscan = static_cast<size_t>(std::max(0, m_overscan));
+
+		first = (first > overscan) ? first - overscan : 0;
+		last = std::min(m_rowCount, last + overscan);
+
+		m_firstRow = first;
+		m_numRows = last - first;
+	}
+
+	ElementInfo viewportInfo{};
+	viewportInfo.appearance = info.appearance;
+	PackStylesToInfo(viewportInfo, id(m_viewportId), w_fill, h_fill, left_right, overflow_hidden);
+
+	SableUI::StartDiv(viewportInfo);
+
+	// rows occupy slots relative to the first materialised row so the element
+	// tree keeps the same shape while scrolling
+	Div(w_fill, h_fit, mt(static_cast<int>(GetRowOffset(m_firstRow) - scroll)))
+	{
+		for (size_t slot = 0; slot < m_numRows; slot++)
+		{
+			size_t row = m_firstRow + slot;
+
+			if (m_estimated)
+			{
+				if (m_slotIds.size() <= slot)
+					m_slotIds.push_back(MakeUniqueElementId());
+
+				Div(id(m_slotIds[slot]), key(row), w_fill, h_fit)
+				{
+					m_builder(row);
+				}
+			}
+			else
+			{
+				Div(key(row), w_fill, h(m_rowHeight), overflow_hidden)
+				{
+					m_builder(row);
+				}
+			}
+		}
+	}
+
+	if (vpH > 0 && GetContentHeight() > vpH)
+	{
+		int64_t maxScroll = GetMaxScroll();
+		int thumbHeight = GetThumbHeight();
+		int trackRange = std::max(0, vpH - thumbHeight - BAR_PADDING * 2);
+		double progress = (maxScroll > 0) ? static_cast<double>(scroll) / static_cast<double>(maxScroll) : 0.0;
+		int topMargin = static_cast<int>(progress * trackRange);
+		Colour bgColour = info.appearance->bg.value_or(t.crust);
+
+		if (barHovered.get() || isDragging.get())
+		{
+			Div(id(m_barId), w_fit, p(BAR_PADDING), h_fill, bg(bgColour))
+			{
+				RectElement(w(6), h(thumbHeight), mt(topMargin), rounded(3), bg(149, 149, 149));
+			}
+		}
+		else
+		{
+			Div(id(m_barId), w_fit, p(BAR_PADDING), h_fill, bg(bgColour))
+			{
+				RectElement(w(2), m(2), h(thumbHeight), mt(topMargin), rounded(1), bg(128, 128, 128));
+			}
+		}
+	}
+
+	SableUI::EndDiv();
+}
+
+void VirtualList::OnUpdate(const UIEventContext& ctx)
+{
+	Element* viewportEl = GetElementById(m_viewportId);
+	if (!viewportEl) return;
+
+	if (ctx.scrollDelta.y != 0 && RectBoundingBox(viewportEl->rect, ctx.mousePos))
+		SetScroll(scrollY.get() - static_cast<int64_t>(ctx.scrollDelta.y * SCROLL_STEP));
+
+	Element* barEl = GetElementById(m_barId);
+	if (!barEl)
+	{
+		isDragging.set(false);
+		return;
+	}
+
+	bool hover = RectBoundingBox(barEl->rect, ctx.mousePos);
+	barHovered.set(hover);
+
+	if (isDragging.get())
+	{
+		if (ctx.mouseReleased.test(SABLE_MOUSE_BUTTON_LEFT))
+		{
+			isDragging.set(false);
+			MarkDirty();
+			return;
+		}
+
+		int trackRange = viewportHeight.get() - GetThumbHeight() - BAR_PADDING * 2;
+		if (trackRange > 0)
+		{
+			double ratio = static_cast<double>(GetMaxScroll()) / trackRange;
+			int mouseDeltaY = ctx.mousePos.y - dragOrigY.get();
+			SetScroll(dragStartScrollY.get() + static_cast<int64_t>(mouseDeltaY * ratio));
+		}
+	}
+	else if (hover && ctx.mousePressed.test(SABLE_MOUSE_BUTTON_LEFT))
+	{
+		isDragging.set(true);
+		dragOrigY.set(ctx.mousePos.y);
+		dragStartScrollY.set(scrollY.get());
+		MarkDirty();
+	}
+}
+
+void VirtualList::OnUpdatePostLayout(const UIEventContext& ctx)
+{
+	if (Element* viewportEl = GetElementById(m_viewportId))
+		viewportHeight.set(viewportEl->rect.h);
+
+	if (!m_estimated || !heights.get())
+		return;
+
+	// feed measured heights back, rows keep their estimate until they are seen.
+	// rect.h is clipped to the viewport, overscan and partly visible rows
+	// would report a cut height, the measured content height is not clipped
+	bool changed = false;
+	for (size_t slot = 0; slot < m_numRows && slot < m_slotIds.size(); slot++)
+	{
+		Element* rowEl = GetElementById(m_slotIds[slot]);
+		if (!rowEl || rowEl->measuredHeight <= 0) continue;
+
+		int rowHeight = rowEl->measuredHeight + rowEl->info.layout->pT + rowEl->info.layout->pB;
+		changed |= heights.get()->SetHeight(m_firstRow + slot, rowHeight);
+	}
+
+	if (changed)
+		MarkDirty();
+}
@@ -13,6 +13,7 @@
 #include <SableUI/utils/memory.h>
 #include <SableUI/utils/utils.h>
 #include <SableUI/core/events.h>
+#include <atomic>
 #include <unordered_set>
 #include <string.h>
 #include <cstring>
@@ -73,6 +74,8 @@ void SableUI::StartDivVirtual(const SableUI::ElementInfo& info, SableUI::BaseCom
 	vnode->info = info;
 	vnode->info.type = ElementType::Div;
 	vnode->childComp = child;
+	InternStyles(vnode->info);
+	vnode->hash = HashElementInfo(vnode->info);
 
 	if (parent) parent->children.push_back(vnode);
 	else s_virtualRoot = vnode;
@@ -92,6 +95,8 @@ void SableUI::AddRectVirtual(const SableUI::ElementInfo& info)
 	auto* vnode = SB_new<VirtualNode>();
 	vnode->info = info;
 	vnode->info.type = ElementType::Rect;
+	InternStyles(vnode->info);
+	vnode->hash = HashElementInfo(vnode->info);
 
 	if (parent) parent->children.push_back(vnode);
 	else s_virtualRoot = vnode;
@@ -104,6 +109,8 @@ void SableUI::AddTextVirtual(const SableString& text, const SableUI::ElementInfo
 	vnode->info = info;
 	vnode->info.type = ElementType::Text;
 	vnode->info.text.content = text;
+	InternStyles(vnode->info);
+	vnode->hash = HashElementInfo(vnode->info);
 
 	if (parent) parent->children.push_back(vnode);
 	else s_virtualRoot = vnode;
@@ -116,6 +123,23 @@ void SableUI::AddImageVirtual(const SableString& path, const SableUI::ElementInf
 	vnode->info = info;
 	vnode->info.type = ElementType::Image;
 	vnode->info.text.content = path;
+	InternStyles(vnode->info);
+	vnode->hash = HashElementInfo(vnode->info);
+
+	if (parent) parent->children.push_back(vnode);
+	else s_virtualRoot = vnode;
+}
+
+void SableUI::AddMemoisedComponentVirtual(const SableUI::ElementInfo& info, SableUI::BaseComponent* child)
+{
+	VirtualNode* parent = s_virtualStack.empty() ? nullptr : s_virtualStack.top();
+	auto* vnode = SB_new<VirtualNode>();
+	vnode->info = info;
+	vnode->info.type = ElementType::Div;
+	vnode->childComp = child;
+	vnode->memoised = true;
+	InternStyles(vnode->info);
+	vnode->hash = HashElementInfo(vnode->info);
 
 	if (parent) parent->children.push_back(vnode);
 	else s_virtualRoot = vnode;
@@ -226,7 +250,7 @@ void SableUI::SetElementBuilderContext(RendererBackend* renderer, Element* rootE
 		s_elementStack = std::stack<Element*>();
 		s_elementStack.push(rootElement);
 
-		if (s_currentComponent)
+		if (s_currentComponent && !rootElement->m_owner)
 		{
 			rootElement->m_owner = s_currentComponent;
 		}
@@ -249,16 +273,24 @@ SableUI::Element* SableUI::GetCurrentElement()
 	return s_elementStack.top();
 }
 
-void SableUI::StartDiv(const ElementInfo& p_info, BaseComponent* child)
+void SableUI::ResolveElementInfo(ElementInfo& info, const Element* parent)
 {
-	if (s_reconciliationMode) return StartDivVirtual(p_info, child);
-	SableUI::ElementInfo info = p_info;
+	if (parent && info.appearance->inheritBg && info.appearance->bg == Colour{ 0, 0, 0, 0 })
+		info.appearance.mut().bg = parent->info.appearance->bg;
 
-	if (info.appearance.inheritBg && info.appearance.bg == Colour{ 0, 0, 0, 0 })
-		info.appearance.bg = s_elementStack.top()->info.appearance.bg;
+	// text fills the available width by default, everything else fits its content
+	if (info.layout->wType == RectType::Undef)
+		info.layout.mut().wType = (info.type == ElementType::Text) ? RectType::Fill : RectType::FitContent;
+	if (info.layout->hType == RectType::Undef)
+		info.layout.mut().hType = RectType::FitContent;
 
-	if (info.layout.wType == RectType::Undef) info.layout.wType = RectType::FitContent;
-	if (info.layout.hType == RectType::Undef) info.layout.hType = RectType::FitContent;
+	if (info.type == ElementType::Text && !info.text.colour.has_value())
+		info.text.colour = GetTheme().text;
+}
+
+void SableUI::StartDiv(const ElementInfo& p_info, BaseComponent* child)
+{
+	if (s_reconciliationMode) return StartDivVirtual(p_info, child);
 
 	if (s_elementStack.empty() || s_rendererStack.top() == nullptr)
 	{
@@ -268,11 +300,15 @@ void SableUI::StartDiv(const ElementInfo& p_info, BaseComponent* child)
 
 	Element* parent = s_elementStack.top();
 
+	SableUI::ElementInfo info = p_info;
 	info.type = ElementType::Div;
+	ResolveElementInfo(info, parent);
+
 	Element* newDiv = SB_new<Element>(s_rendererStack.top(), info);
 
-	newDiv->m_owner = parent->m_owner;
+	newDiv->m_owner = child ? child : parent->m_owner;
 	newDiv->RegisterForHover();
+	newDiv->RegisterId();
 
 	if (child == nullptr)
 	{
@@ -299,16 +335,22 @@ void SableUI::EndDiv()
 	s_elementStack.pop();
 }
 
-void SableUI::AddRect(const ElementInfo& p_info)
+void SableUI::AddMemoisedComponent(const ElementInfo& info, BaseComponent* child)
 {
-	if (s_reconciliationMode) return AddRectVirtual(p_info);
-	SableUI::ElementInfo info = p_info;
+	if (s_reconciliationMode) return AddMemoisedComponentVirtual(info, child);
 
-	if (info.appearance.inheritBg && info.appearance.bg == Colour{ 0, 0, 0, 0 })
-		info.appearance.bg = s_elementStack.top()->info.appearance.bg;
+	if (s_elementStack.empty())
+	{
+		SableUI_Error("Element context not set. Call SetElementBuilderContext() first");
+		return;
+	}
 
-	if (info.layout.wType == RectType::Undef) info.layout.wType = RectType::FitContent;
-	if (info.layout.hType == RectType::Undef) info.layout.hType = RectType::FitContent;
+	s_elementStack.top()->AddChild(SB_new<Child>(child));
+}
+
+void SableUI::AddRect(const ElementInfo& p_info)
+{
+	if (s_reconciliationMode) return AddRectVirtual(p_info);
 
 	if (s_elementStack.empty() || s_rendererStack.top() == nullptr)
 	{
@@ -318,11 +360,15 @@ void SableUI::AddRect(const ElementInfo& p_info)
 
 	Element* parent = s_elementStack.top();
 
+	SableUI::ElementInfo info = p_info;
 	info.type = ElementType::Rect;
+	ResolveElementInfo(info, parent);
+
 	Element* newRect = SB_new<Element>(s_rendererStack.top(), info);
 
 	newRect->m_owner = parent->m_owner;
 	newRect->RegisterForHover();
+	newRect->RegisterId();
 
 	parent->AddChild(newRect);
 }
@@ -330,13 +376,6 @@ void SableUI::AddRect(const ElementInfo& p_info)
 void SableUI::AddImage(const SableString& path, const ElementInfo& p_info)
 {
 	if (s_reconciliationMode) return AddImageVirtual(path, p_info);
-	SableUI::ElementInfo info = p_info;
-
-	if (info.appearance.inheritBg && info.appearance.bg == Colour{ 0, 0, 0, 0 })
-		info.appearance.bg = s_elementStack.top()->info.appearance.bg;
-
-	if (info.layout.wType == RectType::Undef) info.layout.wType = RectType::FitContent;
-	if (info.layout.hType == RectType::Undef) info.layout.hType = RectType::FitContent;
 
 	if (s_elementStack.empty() || s_rendererStack.top() == nullptr)
 	{
@@ -346,11 +385,15 @@ void SableUI::AddImage(const SableString& path, const ElementInfo& p_info)
 
 	Element* parent = s_elementStack.top();
 
+	SableUI::ElementInfo info = p_info;
 	info.type = ElementType::Image;
+	ResolveElementInfo(info, parent);
+
 	Element* newImage = SB_new<Element>(s_rendererStack.top(), info);
 
 	newImage->m_owner = parent->m_owner;
 	newImage->RegisterForHover();
+	newImage->RegisterId();
 
 	newImage->SetImage(path);
 	parent->AddChild(newImage);
@@ -361,16 +404,6 @@ void SableUI::AddText(const SableString& text, const ElementInfo& p_info)
 	if (s_reconciliationMode)
 		return AddTextVirtual(text, p_info);
 
-	ElementInfo info = p_info;
-
-	if (info.appearance.inheritBg && info.appearance.bg == Colour{ 0, 0, 0, 0 })
-		info.appearance.bg = s_elementStack.top()->info.appearance.bg;
-
-	if (info.layout.wType == RectType::Undef)
-		info.layout.wType = RectType::Fill;
-	if (info.layout.hType == RectType::Undef)
-		info.layout.hType = RectType::FitContent;
-
 	if (s_elementStack.empty() || s_rendererStack.top() == nullptr)
 	{
 		SableUI_Error("Element context not set. Call SetElementBuilderContext() first");
@@ -379,14 +412,14 @@ void SableUI::AddText(const SableString& text, const ElementInfo& p_info)
 
 	Element* parent = s_elementStack.top();
 
-	if (info.text.colour.has_value() == false)
-		info.text.colour = GetTheme().text;
-
+	ElementInfo info = p_info;
 	info.type = ElementType::Text;
+	ResolveElementInfo(info, parent);
 
 	Element* e = SB_new<Element>(s_rendererStack.top(), info);
 	e->m_owner = parent->m_owner;
 	e->RegisterForHover();
+	e->RegisterId();
 	e->SetText(text);
 
 	parent->AddChild(e);
@@ -602,14 +635,35 @@ void SableUI::Render()
 	s_app->Render();
 }
 
-static bool s_eventPostedThisFrame = false;
+// posted from the scheduler and worker threads as well as the ui thread
+static std::atomic<bool> s_eventPostedThisFrame = false;
+static thread_local int s_batchDepth = 0;
+static thread_local bool s_batchPosted = false;
+
 void SableUI::PostEmptyEvent()
 {
-	if (!s_eventPostedThisFrame)
+	if (s_batchDepth > 0)
 	{
-		SableUI_Window_PostEmptyEvent_GLFW();
-		s_eventPostedThisFrame = true;
+		s_batchPosted = true;
+		return;
 	}
+
+	if (!s_eventPostedThisFrame.exchange(true))
+		SableUI_Window_PostEmptyEvent_GLFW();
+}
+
+SableUI::UpdateBatch::UpdateBatch()
+{
+	s_batchDepth++;
+}
+
+SableUI::UpdateBatch::~UpdateBatch()
+{
+	if (--s_batchDepth > 0 || !s_batchPosted)
+		return;
+
+	s_batchPosted = false;
+	PostEmptyEvent();
 }
 
 App::App(const char* name, int width, int height, const SableUI::WindowInitInfo& info)
@@ -644,6 +698,9 @@ bool App::PollEvents()
 	auto firedTimersVec = SableUI::EventScheduler::GetInstance().PollFiredTimers();
 	std::unordered_set<SableUI::TimerHandle> firedTimers(firedTimersVec.begin(), firedTimersVec.end());
 
+	// one atlas frame for every window, layers drawn by any of them stay resident
+	SableUI::AdvanceFontAtlasFrame();
+
 	if (!m_mainWindow->Update(firedTimers)) return false;
 
 	for (auto it = m_secondaryWindows.begin(); it != m_secondaryWindows.end();)
@@ -672,6 +729,8 @@ bool App::WaitEvents()
 	auto firedTimersVec = SableUI::EventScheduler::GetInstance().PollFiredTimers();
 	std::unordered_set<SableUI::TimerHandle> firedTimers(firedTimersVec.begin(), firedTimersVec.end());
 
+	SableUI::AdvanceFontAtlasFrame();
+
 	if (!m_mainWindow->Update(firedTimers)) return false;
 
 	for (auto it = m_secondaryWindows.begin(); it != m_secondaryWindows.end();)
@@ -700,6 +759,8 @@ bool App::WaitEventsTimeout(double timeout)
 	auto firedTimersVec = SableUI::EventScheduler::GetInstance().PollFiredTimers();
 	std::unordered_set<SableUI::TimerHandle> firedTimers(firedTimersVec.begin(), firedTimersVec.end());
 
+	SableUI::AdvanceFontAtlasFrame();
+
 	if (!m_mainWindow->Update(firedTimers)) return false;
 
 	for (auto it = m_secondaryWindows.begin(); it != m_secondaryWindows.end();)
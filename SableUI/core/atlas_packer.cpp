@@ -0,0 +1,225 @@
+#include <SableUI/core/atlas_packer.h>
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+
+// ============================================================================
+// SkylinePacker
+// ============================================================================
+SableUI::SkylinePacker::SkylinePacker(int width, int height)
+	: m_width(width), m_height(height)
+{
+	Reset();
+}
+
+void SableUI::SkylinePacker::Reset()
+{
+	m_skyline.clear();
+	m_skyline.push_back({ 0, 0, m_width });
+	m_usedArea = 0;
+}
+
+float SableUI::SkylinePacker::GetOccupancy() const
+{
+	uint64_t area = static_cast<uint64_t>(m_width) * m_height;
+	return area > 0 ? static_cast<float>(m_usedArea) / static_cast<float>(area) : 0.0f;
+}
+
+int SableUI::SkylinePacker::FitAt(size_t index, int width, int height) const
+{
+	int x = m_skyline[index].x;
+	if (x + width > m_width)
+		return -1;
+
+	int y = 0;
+	int remaining = width;
+	for (size_t i = index; remaining > 0; i++)
+	{
+		if (i >= m_skyline.size())
+			return -1;
+
+		y = std::max(y, m_skyline[i].y);
+		if (y + height > m_height)
+			return -1;
+
+		remaining -= m_skyline[i].width;
+	}
+
+	return y;
+}
+
+void SableUI::SkylinePacker::AddLevel(size_t index, int x, int y, int width, int height)
+{
+	m_skyline.insert(m_skyline.begin() + index, { x, y + height, width });
+
+	// nodes now under the new level shrink or go
+	for (size_t i = index + 1; i < m_skyline.size(); i++)
+	{
+		Node& prev = m_skyline[i - 1];
+		Node& node = m_skyline[i];
+
+		if (node.x >= prev.x + prev.width)
+			break;
+
+		int shrink = prev.x + prev.width - node.x;
+		node.x += shrink;
+		node.width -= shrink;
+
+		if (node.width > 0)
+			break;
+
+		m_skyline.erase(m_skyline.begin() + i);
+		i--;
+	}
+
+	// merge neighbours at the same height
+	for (size_t i = 0; i + 1 < m_skyline.size(); i++)
+	{
+		if (m_skyline[i].y == m_skyline[i + 1].y)
+		{
+			m_skyline[i].width += m_skyline[i + 1].width;
+			m_skyline.erase(m_skyline.begin() + i + 1);
+			i--;
+		}
+	}
+}
+
+bool SableUI::SkylinePacker::Insert(int width, int height, int& outX, int& outY)
+{
+	if (width <= 0 || height <= 0 || width > m_width || height > m_height)
+		return false;
+
+	int bestTop = INT_MAX;
+	int bestWidth = INT_MAX;
+	size_t bestIndex = SIZE_MAX;
+	int bestY = 0;
+
+	for (size_t i = 0; i < m_skyline.size(); i++)
+	{
+		int y = FitAt(i, width, height);
+		if (y < 0) continue;
+
+		int top = y + height;
+		if (top < bestTop || (top == bestTop && m_skyline[i].width < bestWidth))
+		{
+			bestTop = top;
+			bestWidth = m_skyline[i].width;
+			bestIndex = i;
+			bestY = y;
+		}
+	}
+
+	if (bestIndex == SIZE_MAX)
+		return false;
+
+	outX = m_skyline[bestIndex].x;
+	outY = bestY;
+
+	AddLevel(bestIndex, outX, outY, width, height);
+	m_usedArea += static_cast<uint64_t>(width) * height;
+	return true;
+}
+
+// ============================================================================
+// AtlasAllocator
+// ============================================================================
+SableUI::AtlasAllocator::AtlasAllocator(int width, int height, int padding, int layerBudget)
+	: m_width(width), m_height(height), m_padding(padding), m_layerBudget(std::max(1, layerBudget))
+{
+}
+
+void SableUI::AtlasAllocator::SetLayerBudget(int layers)
+{
+	m_layerBudget = std::max(1, layers);
+}
+
+void SableUI::AtlasAllocator::Touch(uint16_t layer, uint64_t frame)
+{
+	if (layer < m_layers.size())
+		m_layers[layer].lastUsed = std::max(m_layers[layer].lastUsed, frame);
+}
+
+void SableUI::AtlasAllocator::Clear()
+{
+	m_layers.clear();
+}
+
+bool SableUI::AtlasAllocator::TryLayer(size_t index, uint64_t key, int width, int height, uint64_t frame, AtlasSlot& outSlot)
+{
+	Layer& layer = m_layers[index];
+
+	// padding on the right and bottom of each rect, and once along the top left edge
+	int x = 0, y = 0;
+	if (!layer.packer.Insert(width + m_padding, height + m_padding, x, y))
+		return false;
+
+	outSlot.x = static_cast<uint16_t>(x + m_padding);
+	outSlot.y = static_cast<uint16_t>(y + m_padding);
+	outSlot.layer = static_cast<uint16_t>(index);
+
+	layer.keys.push_back(key);
+	layer.lastUsed = std::max(layer.lastUsed, frame);
+	m_allocations++;
+	return true;
+}
+
+bool SableUI::AtlasAllocator::Allocate(uint64_t key, int width, int height, uint64_t frame,
+	AtlasSlot& outSlot, std::vector<uint64_t>& evicted)
+{
+	if (width + m_padding * 2 > m_width || height + m_padding * 2 > m_height)
+		return false;
+
+	for (size_t i = 0; i < m_layers.size(); i++)
+		if (TryLayer(i, key, width, height, frame, outSlot))
+			return true;
+
+	if (static_cast<int>(m_layers.size()) >= m_layerBudget)
+	{
+		size_t victim = SIZE_MAX;
+		for (size_t i = 0; i < m_layers.size(); i++)
+		{
+			if (m_layers[i].lastUsed >= frame) continue;
+			if (victim == SIZE_MAX || m_layers[i].lastUsed < m_layers[victim].lastUsed)
+				victim = i;
+		}
+
+		if (victim != SIZE_MAX)
+		{
+			Layer& layer = m_layers[victim];
+			evicted.insert(evicted.end(), layer.keys.begin(), layer.keys.end());
+			m_evictedEntries += layer.keys.size();
+			m_reclaimedLayers++;
+
+			layer.keys.clear();
+			layer.packer.Reset();
+			layer.lastUsed = 0;
+
+			return TryLayer(victim, key, width, height, frame, outSlot);
+		}
+
+		// everything on screen this frame, better to grow than to corrupt text
+		m_overBudget++;
+	}
+
+	m_layers.push_back({ SkylinePacker(m_width - m_padding, m_height - m_padding), {}, 0 });
+	return TryLayer(m_layers.size() - 1, key, width, height, frame, outSlot);
+}
+
+SableUI::AtlasStats SableUI::AtlasAllocator::GetStats() const
+{
+	AtlasStats stats;
+	stats.layers = static_cast<int>(m_layers.size());
+	stats.layerBudget = m_layerBudget;
+	stats.allocations = m_allocations;
+	stats.evictedEntries = m_evictedEntries;
+	stats.reclaimedLayers = m_reclaimedLayers;
+	stats.overBudget = m_overBudget;
+
+	uint64_t used = 0;
+	for (const Layer& layer : m_layers)
+		used += layer.packer.GetUsedArea();
+
+	uint64_t total = static_cast<uint64_t>(m_width) * m_height * m_layers.size();
+	stats.occupancy = total > 0 ? static_cast<float>(used) / static_cast<float>(total) : 0.0f;
+	return stats;
+}
@@ -34,17 +34,28 @@ void CommandBuffer::SetBlendState(bool enabled, BlendFactor src, BlendFactor dst
 
 void CommandBuffer::SetScissor(int x, int y, int width, int height)
 {
+	Rect scissor = { x, y, width, height };
+	if (m_state.scissor.has_value() && m_state.scissor.value() == scissor)
+		return;
+
 	Command cmd;
 	cmd.type = CommandType::SetScissor;
 	cmd.data = SetScissorCmd{ x, y, width, height };
 	m_commands.push_back(std::move(cmd));
+
+	m_state.scissor = scissor;
 }
 
 void CommandBuffer::DisableScissor()
 {
+	if (!m_state.scissor.has_value())
+		return;
+
 	Command cmd;
 	cmd.type = CommandType::DisableScissor;
 	m_commands.push_back(std::move(cmd));
+
+	m_state.scissor.reset();
 }
 
 void CommandBuffer::BindGpuObject(uint32_t handle)
@@ -107,6 +118,8 @@ void CommandBuffer::Draw(uint32_t vertexCount, uint32_t instanceCount,
 
 void CommandBuffer::Clear(float r, float g, float b, float a)
 {
+	DisableScissor();
+
 	Command cmd;
 	cmd.type = CommandType::Clear;
 	cmd.data = ClearCmd{ r, g, b, a };
@@ -115,6 +128,8 @@ void CommandBuffer::Clear(float r, float g, float b, float a)
 
 void CommandBuffer::BeginRenderPass(const GpuFramebuffer* framebuffer)
 {
+	DisableScissor();
+
 	Command cmd;
 	cmd.type = CommandType::BeginRenderPass;
 	cmd.data = BeginRenderPassCmd{ framebuffer };
@@ -133,6 +148,8 @@ void CommandBuffer::BlitFramebuffer(uint32_t srcFBO, uint32_t dstFBO,
 	int dstX0, int dstY0, int dstX1, int dstY1,
 	TextureInterpolation filter)
 {
+	DisableScissor();
+
 	Command cmd;
 	cmd.type = CommandType::BlitFramebuffer;
 	cmd.data = BlitFramebufferCmd{ srcFBO, dstFBO, srcX0, srcY0, srcX1, srcY1,
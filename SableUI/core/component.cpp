@@ -1,4 +1,5 @@
 #include <SableUI/core/component.h>
+#include <SableUI/core/dirty_queue.h>
 #include <SableUI/states/floating_panel_base.h>
 #include <SableUI/SableUI.h>
 #include <SableUI/core/element.h>
@@ -8,13 +9,17 @@
 #include <SableUI/utils/memory.h>
 #include <SableUI/utils/utils.h>
 #include <algorithm>
-#include <cstring>
+#include <functional>
 #include <string>
+#include <string_view>
+#include <typeinfo>
 #include <vector>
 
 using namespace SableMemory;
 
 static int s_numComponents = 0;
+static SableUI::ComponentReuseStats s_reuseStats;
+
 SableUI::BaseComponent::BaseComponent(Colour colour)
 {
 	s_numComponents++;
@@ -25,6 +30,9 @@ SableUI::BaseComponent::~BaseComponent()
 {
 	s_numComponents--;
 
+	if (m_dirtyQueue)
+		m_dirtyQueue->Remove(this);
+
 	if (rootElement) SB_delete(rootElement);
 
 	for (BaseComponent* child : m_componentChildren)
@@ -40,7 +48,7 @@ SableUI::BaseComponent::~BaseComponent()
 
 static void RebuildHoverListRecursive(SableUI::Element* el, std::vector<SableUI::Element*>& list)
 {
-	if (el->info.appearance.hasHoverBg)
+	if (el->info.appearance->hasHoverBg)
 		list.push_back(el);
 
 	for (SableUI::Child* child : el->children)
@@ -52,24 +60,54 @@ static void RebuildHoverListRecursive(SableUI::Element* el, std::vector<SableUI:
 	}
 }
 
+static void CollectSpatialEntriesRecursive(SableUI::Element* el, SableUI::SpatialIndex& index,
+	std::vector<SableUI::BaseComponent*>& components, std::vector<SableUI::Element*>& hovered)
+{
+	if (el->HasPointerHandlers() || el->info.appearance->hasHoverBg)
+		index.Insert(el, el->GetHitRect());
+
+	if (el->isHovered)
+		hovered.push_back(el);
+
+	for (SableUI::Child* child : el->children)
+	{
+		if (child->type == SableUI::ChildType::COMPONENT)
+			components.push_back(child->component);
+		else
+			CollectSpatialEntriesRecursive(child->element, index, components, hovered);
+	}
+}
+
 int SableUI::BaseComponent::GetNumInstances()
 {
 	return s_numComponents;
 }
 
+const SableUI::ComponentReuseStats& SableUI::BaseComponent::GetReuseStats()
+{
+	return s_reuseStats;
+}
+
+void SableUI::BaseComponent::ResetReuseStats()
+{
+	s_reuseStats = {};
+}
+
 void SableUI::BaseComponent::LayoutWrapper()
 {
+	// last layout's children are claimed back by AddComponent as they are
+	// declared, whatever is left over was not declared this time
+	m_previousChildren.swap(m_componentChildren);
+	m_componentChildren.clear();
 	m_childCount = 0;
+
 	Layout();
 
-	if (m_componentChildren.size() > static_cast<size_t>(m_childCount))
-	{
-		for (size_t i = m_childCount; i < m_componentChildren.size(); i++)
-			if (m_componentChildren[i])
-				m_garbageChildren.push_back(m_componentChildren[i]);
-	}
+	for (BaseComponent* child : m_previousChildren)
+		if (child)
+			m_garbageChildren.push_back(child);
 
-	m_componentChildren.resize(m_childCount);
+	m_previousChildren.clear();
 }
 
 void SableUI::BaseComponent::BackendInitialisePanel()
@@ -83,9 +121,9 @@ void SableUI::BaseComponent::BackendInitialisePanel()
 
 	ElementInfo info{};
 	info.type = ElementType::Div;
-	info.appearance.bg = t.base;
-	info.layout.wType = RectType::Fill;
-	info.layout.hType = RectType::Fill;
+	info.appearance.mut().bg = t.base;
+	info.layout.mut().wType = RectType::Fill;
+	info.layout.mut().hType = RectType::Fill;
 	rootElement = SB_new<Element>(m_renderer, info);
 	rootElement->m_owner = this;
 
@@ -105,13 +143,13 @@ void SableUI::BaseComponent::BackendInitialiseFloatingPanel(const Rect& rect, co
 
 	ElementInfo info = p_info;
 	info.type = ElementType::Div;
-	if (!info.appearance.bg.has_value())
-		info.appearance.bg = GetTheme().base;
+	if (!info.appearance->bg.has_value())
+		info.appearance.mut().bg = GetTheme().base;
 
-	info.layout.width = rect.w;
-	info.layout.height = rect.h;
-	info.layout.wType = RectType::Fixed;
-	info.layout.hType = RectType::Fixed;
+	info.layout.mut().width = rect.w;
+	info.layout.mut().height = rect.h;
+	info.layout.mut().wType = RectType::Fixed;
+	info.layout.mut().hType = RectType::Fixed;
 	rootElement = SB_new<Element>(m_renderer, info);
 	rootElement->SetRect(rect);
 	rootElement->m_owner = this;
@@ -135,14 +173,61 @@ SableUI::RendererBackend* SableUI::BaseComponent::GetRenderer()
 
 static size_t GetHash(int n, const char* name)
 {
-	size_t h = 0;
+	size_t h = std::hash<std::string_view>()(name);
+	h ^= static_cast<size_t>(n) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+	return h;
+}
 
-	for (int i = 0; i < strlen(name); i++)
-		h = (h << (5 + n)) - h + name[i];
+size_t SableUI::BaseComponent::NextChildHash(const std::string& name, uint64_t key) const
+{
+	// keyed children keep their instance when siblings are inserted or reordered
+	if (key != 0)
+		return GetHash(0, name.c_str()) ^ static_cast<size_t>(key * 0x9e3779b97f4a7c15ULL);
 
-	h ^= (n * 0x9e3779b) ^ (n << 15);
+	return GetHash(m_childCount + 1, name.c_str());
+}
 
-	return h;
+SableUI::BaseComponent* SableUI::BaseComponent::ClaimPreviousChild(size_t hash, const std::type_info& type)
+{
+	// a hash can collide across names, the instance is only reused as the type it was created as
+	auto matches = [&](const BaseComponent* child) {
+		return child && child->m_hash == hash && typeid(*child) == type;
+	};
+
+	// children are usually declared in the same order as last time
+	size_t hint = static_cast<size_t>(m_childCount);
+	BaseComponent* found = nullptr;
+
+	if (hint < m_previousChildren.size() && matches(m_previousChildren[hint]))
+	{
+		found = m_previousChildren[hint];
+		m_previousChildren[hint] = nullptr;
+	}
+	else
+	{
+		for (BaseComponent*& child : m_previousChildren)
+		{
+			if (matches(child))
+			{
+				found = child;
+				child = nullptr;
+				break;
+			}
+		}
+	}
+
+	if (!found)
+	{
+		s_reuseStats.created++;
+		return nullptr;
+	}
+
+	// Init runs on the live instance, its states keep their values through it
+	found->m_holdState = true;
+	found->m_propsChanged = true;
+	s_reuseStats.reused++;
+
+	return AttachComponent(found);
 }
 
 void SableUI::BaseComponent::Render(CommandBuffer& cmd, const GpuFramebuffer* framebuffer, ContextResources& contextResources, int z)
@@ -152,17 +237,47 @@ void SableUI::BaseComponent::Render(CommandBuffer& cmd, const GpuFramebuffer* fr
 
 void SableUI::BaseComponent::BackendInitialiseChild(const std::string& name, BaseComponent* parent, const ElementInfo& info)
 {
-	int n = parent->GetNumChildren();
+	m_holdState = false;
 
-	m_hash = GetHash(n, name.c_str());
+	// created through AddComponent<T>() without a name, fall back to copying
+	// state from the previous instance
+	if (m_hash == 0)
+	{
+		int n = parent->GetNumChildren();
 
-	for (BaseComponent* c : parent->m_garbageChildren)
-		if (c->m_hash == m_hash)
-			CopyStateFrom(*c);
+		if (info.key != 0)
+			m_hash = GetHash(0, name.c_str()) ^ static_cast<size_t>(info.key * 0x9e3779b97f4a7c15ULL);
+		else
+			m_hash = GetHash(n, name.c_str());
 
-	m_renderer = parent->m_renderer;
+		for (BaseComponent* c : parent->m_previousChildren)
+			if (c && c->m_hash == m_hash && typeid(*c) == typeid(*this))
+				CopyStateFrom(*c);
+	}
 
+	m_renderer = parent->m_renderer;
+	m_dirtyQueue = parent->m_dirtyQueue;
+	m_parent = parent;
+	m_depth = parent->m_depth + 1;
 	SetCurrentComponent(parent);
+
+	size_t styleHash = HashElementInfo(info);
+	bool unchanged = m_memoised && !m_propsChanged && !needsRerender
+		&& rootElement && styleHash == m_styleHash;
+	m_styleHash = styleHash;
+
+	if (unchanged)
+	{
+		AddMemoisedComponent(info, this);
+		s_reuseStats.memoSkipped++;
+		return;
+	}
+
+	// the parent's pass carries this layout, a queued rerender is covered by it
+	needsRerender = false;
+	needsRepaint = false;
+	m_hoverElements.clear();
+
 	StartDiv(info, this);
 	LayoutWrapper();
 	EndDiv();
@@ -179,6 +294,10 @@ SableUI::Element* SableUI::BaseComponent::GetRootElement()
 
 void SableUI::BaseComponent::SetRootElement(Element* element)
 {
+	// reused instances are given a fresh root when their parent rebuilds them
+	if (rootElement && rootElement != element)
+		SB_delete(rootElement);
+
 	rootElement = element;
 }
 
@@ -199,38 +318,34 @@ bool SableUI::BaseComponent::Rerender(CommandBuffer& cmd, const GpuFramebuffer*
 	LayoutWrapper();
 	VirtualNode* virtualRoot = SableUI::GetVirtualRootNode();
 
-	if (rootElement->Reconcile(virtualRoot) && hasContentsChanged)
+	PropChange change = rootElement->Reconcile(virtualRoot);
+	if (change != PropChange::None && hasContentsChanged)
 		*hasContentsChanged = true;
 
-	for (BaseComponent* garbage : m_garbageChildren)
-		SB_delete(garbage);
+	// dropped component children are only unlinked, not destroyed with an element
+	if (change == PropChange::Structural)
+		InvalidateSpatialIndex();
 
-	m_garbageChildren.clear();
+	CollectGarbage();
 
 	m_hoverElements.clear();
 	RebuildHoverListRecursive(rootElement, m_hoverElements);
 
-	rootElement->LayoutChildren();
-	rootElement->LayoutChildren();
+	// paint-only patches leave every rect where it was
+	if (change >= PropChange::Layout)
+	{
+		rootElement->LayoutChildren();
+		rootElement->LayoutChildren();
+	}
 
 	for (Element* el : m_hoverElements)
 	{
-		if (el->info.appearance.hasHoverBg)
+		if (el->info.appearance->hasHoverBg)
 		{
 			bool res = RectBoundingBox(el->rect, m_lastEventCtx.mousePos);
 
 			el->isHovered = res;
 			el->wasHovered = false;
-
-			if (res)
-			{
-				el->info.appearance.bg = el->info.appearance.hoverBg;
-			}
-			else
-			{
-				el->info.appearance.bg = el->originalBg;
-			}
-
 			el->SetRect(el->rect);
 		}
 	}
@@ -242,12 +357,21 @@ bool SableUI::BaseComponent::Rerender(CommandBuffer& cmd, const GpuFramebuffer*
 	Render(cmd, framebuffer, contextResources);
 
 	needsRerender = false;
+	needsRepaint = false;
 	return false;
 }
 
 void SableUI::BaseComponent::HandleInput(const UIEventContext& ctx)
 {
-	rootElement->DistributeInputToElements(ctx);
+	RebuildSpatialIndex();
+
+	// only elements under the cursor receive pointer events
+	m_spatialIndex.Query(ctx.mousePos, m_hitElements);
+	for (Element* el : m_hitElements)
+		el->DispatchPointerEvents(ctx);
+
+	for (BaseComponent* child : m_inputChildren)
+		child->HandleInput(ctx);
 	
 	for (FloatingPanelStateBase* panel : m_floatingPanels)
 		if (panel->IsOpen())
@@ -298,9 +422,67 @@ void SableUI::BaseComponent::RegisterFloatingPanel(FloatingPanelStateBase* state
 void SableUI::BaseComponent::MarkDirty()
 {
 	needsRerender = true;
+
+	if (m_dirtyQueue && !m_queued)
+	{
+		m_queued = true;
+		m_dirtyQueue->Push(this);
+	}
+
+	PostEmptyEvent();
+}
+
+void SableUI::BaseComponent::MarkRepaint()
+{
+	// without a queue only a rerender is picked up
+	if (!m_dirtyQueue)
+	{
+		MarkDirty();
+		return;
+	}
+
+	// a pending rerender records everything anyway
+	if (needsRerender || needsRepaint)
+		return;
+
+	needsRepaint = true;
+
+	if (!m_queued)
+	{
+		m_queued = true;
+		m_dirtyQueue->Push(this);
+	}
+
 	PostEmptyEvent();
 }
 
+bool SableUI::BaseComponent::TakeSubtreeUpdated()
+{
+	bool updated = m_subtreeUpdated;
+	m_subtreeUpdated = false;
+	return updated;
+}
+
+bool SableUI::BaseComponent::TakeSubtreeRepainted()
+{
+	bool repainted = m_subtreeRepainted;
+	m_subtreeRepainted = false;
+	return repainted;
+}
+
+void SableUI::BaseComponent::CollectGarbage()
+{
+	for (BaseComponent* garbage : m_garbageChildren)
+		SB_delete(garbage);
+
+	m_garbageChildren.clear();
+
+	// reused children laid out during this pass drop their own leftovers
+	for (BaseComponent* child : m_componentChildren)
+		if (child)
+			child->CollectGarbage();
+}
+
 void SableUI::BaseComponent::CopyStateFrom(const BaseComponent& other)
 {
 	/* Ensure both components have the same number of states,
@@ -327,32 +509,107 @@ SableUI::Element* SableUI::BaseComponent::GetElementById(const SableString& id)
 		return nullptr;
 	}
 
-	return rootElement->GetElementById(id);
+	ElementId atom = FindElementId(id);
+	if (!atom) return nullptr;
+
+	return GetElementById(atom);
+}
+
+SableUI::Element* SableUI::BaseComponent::GetElementById(ElementId id)
+{
+	if (!id) return nullptr;
+
+	// the root is built with the component's own info and never registered
+	if (rootElement && rootElement->GetId() == id)
+		return rootElement;
+
+	auto it = m_idIndex.find(id.value);
+	if (it != m_idIndex.end())
+		return it->second;
+
+	for (BaseComponent* child : m_componentChildren)
+		if (child)
+			if (Element* found = child->GetElementById(id))
+				return found;
+
+	return nullptr;
+}
+
+void SableUI::BaseComponent::RegisterElementId(Element* el)
+{
+	// first registration wins, matching tree order of the old DFS lookup
+	m_idIndex.emplace(el->GetId().value, el);
+}
+
+void SableUI::BaseComponent::UnregisterElementId(Element* el)
+{
+	auto it = m_idIndex.find(el->GetId().value);
+	if (it != m_idIndex.end() && it->second == el)
+		m_idIndex.erase(it);
 }
 
 void SableUI::BaseComponent::RegisterHoverElement(Element* el)
 {
-	if (el->info.appearance.hasHoverBg)
+	if (el->info.appearance->hasHoverBg)
 		m_hoverElements.push_back(el);
 }
 
+const SableUI::SpatialIndex& SableUI::BaseComponent::GetSpatialIndex()
+{
+	RebuildSpatialIndex();
+	return m_spatialIndex;
+}
+
+void SableUI::BaseComponent::RebuildSpatialIndex()
+{
+	if (m_spatialIndex.valid)
+		return;
+
+	m_spatialIndex.Clear();
+	m_inputChildren.clear();
+	m_hoveredElements.clear();
+
+	if (rootElement)
+		CollectSpatialEntriesRecursive(rootElement, m_spatialIndex, m_inputChildren, m_hoveredElements);
+
+	m_spatialIndex.Build();
+}
+
+// hover only swaps the bg of elements already laid out, SetRect() patches
+// their drawable and the panel re-records without a rerender
 void SableUI::BaseComponent::UpdateHoverStyling(const UIEventContext& ctx)
 {
-	for (Element* el : m_hoverElements)
+	RebuildSpatialIndex();
+	m_spatialIndex.Query(ctx.mousePos, m_hitElements);
+
+	// leave
+	for (Element* el : m_hoveredElements)
 	{
 		el->wasHovered = el->isHovered;
-		el->isHovered = RectBoundingBox(el->rect, ctx.mousePos);
 
-		if (el->isHovered != el->wasHovered)
-		{
-			if (el->isHovered)
-				el->info.appearance.bg = el->info.appearance.hoverBg;
-			else
-				el->info.appearance.bg = el->originalBg;
+		if (std::find(m_hitElements.begin(), m_hitElements.end(), el) != m_hitElements.end())
+			continue;
 
-			el->SetRect(el->rect);
-			MarkDirty();
-		}
+		el->isHovered = false;
+		el->SetRect(el->rect);
+		MarkRepaint();
+	}
+
+	// enter
+	m_hoveredElements.clear();
+	for (Element* el : m_hitElements)
+	{
+		if (!el->info.appearance->hasHoverBg)
+			continue;
+
+		m_hoveredElements.push_back(el);
+		if (el->isHovered)
+			continue;
+
+		el->wasHovered = false;
+		el->isHovered = true;
+		el->SetRect(el->rect);
+		MarkRepaint();
 	}
 }
 
@@ -361,19 +618,7 @@ SableUI::BaseComponent* SableUI::BaseComponent::AttachComponent(BaseComponent* c
 	if (!component)
 		return nullptr;
 
-	if (static_cast<size_t>(m_childCount) < m_componentChildren.size())
-	{
-		BaseComponent* existing = m_componentChildren[m_childCount];
-		if (existing)
-			m_garbageChildren.push_back(existing);
-
-		m_componentChildren[m_childCount] = component;
-	}
-	else
-	{
-		m_componentChildren.push_back(component);
-	}
-
+	m_componentChildren.push_back(component);
 	m_childCount++;
 	return component;
 }
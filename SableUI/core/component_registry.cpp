@@ -1,6 +1,8 @@
 #include <SableUI/core/component_registry.h>
 #include <SableUI/core/component.h>
 #include <SableUI/core/panel.h>
+#include <SableUI/core/window.h>
+#include <SableUI/SableUI.h>
 #include <SableUI/utils/memory.h>
 #include <SableUI/utils/console.h>
 #include <string>
@@ -25,7 +27,13 @@ BaseComponent* ComponentRegistry::Create(const std::string& name) const
         return nullptr;
     }
 
-    return it->second();
+    return it->second.create();
+}
+
+const std::type_info* ComponentRegistry::GetType(const std::string& name) const
+{
+    auto it = m_factories.find(name);
+    return it != m_factories.end() ? it->second.type : nullptr;
 }
 
 bool ComponentRegistry::IsRegistered(const std::string& name) const
@@ -53,6 +61,9 @@ BaseComponent* ContentPanel::AttachComponent(const std::string& componentName)
 
     m_component = comp;
     m_component->SetRenderer(m_renderer);
+
+    if (Window* window = GetContext())
+        m_component->SetDirtyQueue(&window->GetDirtyQueue());
     
     return comp;
 }
@@ -71,6 +82,21 @@ BaseComponent* BaseComponent::AddComponent(const std::string& componentName)
     return AttachComponent(component);
 }
 
+BaseComponent* BaseComponent::AddComponent(const std::string& componentName, const ElementInfo& info)
+{
+    size_t hash = NextChildHash(componentName, info.key);
+    const std::type_info* type = ComponentRegistry::GetInstance().GetType(componentName);
+    if (type != nullptr)
+        if (BaseComponent* previous = ClaimPreviousChild(hash, *type))
+            return previous;
+
+    BaseComponent* component = AddComponent(componentName);
+    if (component)
+        component->m_hash = hash;
+
+    return component;
+}
+
 #include <SableUI/components/debug_components.h>
 #include <SableUI/components/button.h>
 #include <SableUI/components/checkbox.h>
@@ -0,0 +1,73 @@
+#include <SableUI/core/dirty_queue.h>
+#include <SableUI/core/component.h>
+#include <algorithm>
+#include <vector>
+
+void SableUI::DirtyQueue::Push(BaseComponent* component)
+{
+	m_pending.push_back(component);
+	m_stats.queued++;
+}
+
+void SableUI::DirtyQueue::Remove(BaseComponent* component)
+{
+	m_pending.erase(std::remove(m_pending.begin(), m_pending.end(), component), m_pending.end());
+
+	// freed by an ancestor's rerender part way through Process()
+	std::replace(m_processing.begin(), m_processing.end(), component, static_cast<BaseComponent*>(nullptr));
+}
+
+bool SableUI::DirtyQueue::Process(CommandBuffer& cmd, const GpuFramebuffer* framebuffer, ContextResources& contextResources)
+{
+	if (m_pending.empty())
+		return false;
+
+	// components dirtied while processing wait for the next frame
+	m_processing.swap(m_pending);
+	m_pending.clear();
+
+	for (BaseComponent* component : m_processing)
+		component->m_queued = false;
+
+	std::stable_sort(m_processing.begin(), m_processing.end(),
+		[](const BaseComponent* a, const BaseComponent* b) { return a->m_depth < b->m_depth; });
+
+	bool anyRerendered = false;
+	for (size_t i = 0; i < m_processing.size(); i++)
+	{
+		BaseComponent* component = m_processing[i];
+		if (!component) continue;
+
+		if (!component->needsRerender)
+		{
+			if (!component->needsRepaint)
+			{
+				m_stats.covered++;
+				continue;
+			}
+
+			// drawables were patched in place, the panel only re-records
+			component->needsRepaint = false;
+			m_stats.repainted++;
+			anyRerendered = true;
+
+			BaseComponent* top = component;
+			while (top->m_parent) top = top->m_parent;
+			top->m_subtreeRepainted = true;
+			continue;
+		}
+
+		component->Rerender(cmd, framebuffer, contextResources);
+		component->needsRerender = false;
+		m_stats.rerendered++;
+		anyRerendered = true;
+
+		// the panel holding the top level component lays out and redraws once
+		BaseComponent* top = component;
+		while (top->m_parent) top = top->m_parent;
+		top->m_subtreeUpdated = true;
+	}
+
+	m_processing.clear();
+	return anyRerendered;
+}
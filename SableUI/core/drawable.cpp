@@ -488,12 +488,16 @@ void SableUI::DrawableText::Update(Rect& rect, bool clipEnabled, const Rect& cli
 
 void DrawableText::RecordCommands(CommandBuffer& cmd, const GpuFramebuffer* framebuffer, ContextResources& contextResources)
 {
+	m_text.PrepareAtlas();
+	if (m_text.m_gpuObject == nullptr) return;
+
 	TextDrawData data{};
 	data.targetSize[0] = static_cast<float>(framebuffer->width);
 	data.targetSize[1] = static_cast<float>(framebuffer->height);
 
 	data.pos[0] = m_rect.x;
 	data.pos[1] = m_rect.y + m_rect.h;
+	data.sdfRange = GetTextSdfRange(m_text.m_fontSize);
 
 	cmd.SetPipeline(PipelineType::Text);
 	cmd.BindTexture(0, GetTextAtlasTexture());
@@ -13,24 +13,71 @@
 #define SABLEUI_SUBSYSTEM "Element"
 
 #include <type_traits>
+#include <cstring>
+#include <variant>
 #include <functional>
 #include <algorithm>
 #include <string>
+#include <unordered_map>
 using namespace  SableMemory;
 
 static inline bool HasBorder(const SableUI::ElementInfo& i)
 {
-    return i.layout.bT || i.layout.bB || i.layout.bL || i.layout.bR;
+    return i.layout->bT || i.layout->bB || i.layout->bL || i.layout->bR;
 }
 
 static inline bool HasVisibleBackground(const SableUI::ElementInfo& i)
 {
-    return i.appearance.bg.has_value() && i.appearance.bg.value().a > 0;
+    return i.appearance->bg.has_value() && i.appearance->bg.value().a > 0;
 }
 
 static int n_elements = 0;
 static int n_vElements = 0;
 
+// bumped whenever an element moves, resizes or is destroyed
+static uint64_t s_layoutEpoch = 0;
+
+static SableUI::ReconcileStats s_reconcileStats;
+
+// ============================================================================
+// Element ids
+// ============================================================================
+static std::unordered_map<SableString, uint32_t> s_idAtoms;
+static uint32_t s_nextIdAtom = 1;
+static uint32_t s_nextUniqueIdAtom = 0x80000000u;
+
+SableUI::ElementId SableUI::InternElementId(const SableString& id)
+{
+    if (id.empty()) return {};
+
+    auto it = s_idAtoms.find(id);
+    if (it != s_idAtoms.end())
+        return { it->second };
+
+    uint32_t atom = s_nextIdAtom++;
+    s_idAtoms.emplace(id, atom);
+    return { atom };
+}
+
+SableUI::ElementId SableUI::FindElementId(const SableString& id)
+{
+    auto it = s_idAtoms.find(id);
+    if (it == s_idAtoms.end())
+        return {};
+
+    return { it->second };
+}
+
+SableUI::ElementId SableUI::MakeUniqueElementId()
+{
+    return { s_nextUniqueIdAtom++ };
+}
+
+static inline SableUI::ElementId ResolveId(const SableUI::ElementInfo& info)
+{
+    return info.internedId ? info.internedId : SableUI::InternElementId(info.id);
+}
+
 SableUI::Child::~Child()
 {
     if (type == ChildType::ELEMENT)
@@ -55,10 +102,6 @@ SableUI::Element::Element(RendererBackend* renderer, const ElementInfo& p_info)
 {
     n_elements++;
     SetInfo(p_info);
-
-    if (info.appearance.hasHoverBg)
-        originalBg = info.appearance.bg;
-
     Init(renderer);
 }
 
@@ -66,221 +109,194 @@ void SableUI::Element::Init(RendererBackend* renderer)
 {
     this->renderer = renderer;
 
-    if (drawable != nullptr) SableUI_Runtime_Error("Drawable already created, redundant Init() calls");
+    if (!std::holds_alternative<std::monostate>(drawable)) SableUI_Runtime_Error("Drawable already created, redundant Init() calls");
 
     switch (info.type)
     {
     case ElementType::Rect:
-        drawable = SB_new<DrawableRect>();
+    case ElementType::Div:
+        if (HasBorder(info) || HasVisibleBackground(info))
+            drawable.emplace<DrawableRect>();
         break;
 
     case ElementType::Image:
-        drawable = SB_new<DrawableImage>();
+        drawable.emplace<DrawableImage>();
         break;
 
     case ElementType::Text:
-        drawable = SB_new<DrawableText>();
-        break;
-
-    case ElementType::Div:
-        drawable = SB_new<DrawableRect>();
+        drawable.emplace<DrawableText>();
         break;
 
     default:
         SableUI_Runtime_Error("Unknown ElementType");
-        drawable = nullptr;
         break;
     }
 }
 
+std::optional<SableUI::Colour> SableUI::Element::GetDisplayedBg() const
+{
+    if (isHovered && info.appearance->hasHoverBg)
+        return info.appearance->hoverBg;
+
+    return info.appearance->bg;
+}
+
+void SableUI::Element::UpdateRectDrawable()
+{
+    DrawableRect* drRect = std::get_if<DrawableRect>(&drawable);
+    std::optional<Colour> bg = GetDisplayedBg();
+
+    if (!drRect)
+    {
+        // appearance may have changed since Init(), e.g. a hover background
+        if (!HasBorder(info) && !(bg.has_value() && bg->a > 0))
+            return;
+
+        drRect = &drawable.emplace<DrawableRect>();
+    }
+
+    drRect->Update(
+        rect,
+        bg,
+        info.appearance->rTL,
+        info.appearance->rTR,
+        info.appearance->rBL,
+        info.appearance->rBR,
+        info.appearance->borderColour,
+        info.layout->bT,
+        info.layout->bB,
+        info.layout->bL,
+        info.layout->bR,
+        clipEnabled,
+        clipRect
+    );
+}
+
 void SableUI::Element::SetRect(const Rect& r)
 {
+    if (this->rect != r)
+    {
+        s_layoutEpoch++;
+        if (m_owner) m_owner->InvalidateSpatialIndex();
+    }
+
     this->rect = r;
 
     switch (info.type)
     {
     case ElementType::Rect:
-        if (DrawableRect* drRect = dynamic_cast<DrawableRect*>(drawable))
-        {
-            drRect->Update(
-                rect, 
-                info.appearance.bg, 
-                info.appearance.rTL, 
-                info.appearance.rTR, 
-                info.appearance.rBL, 
-                info.appearance.rBR,
-                info.appearance.borderColour,
-                info.layout.bT,
-                info.layout.bB,
-                info.layout.bL,
-                info.layout.bR,
-                clipEnabled, 
-                clipRect
-            );
-        }
-        else
-            SableUI_Error("Dynamic cast failed");
+    case ElementType::Div:
+        UpdateRectDrawable();
         break;
 
     case ElementType::Image:
-        if (DrawableImage* drImage = dynamic_cast<DrawableImage*>(drawable))
-        {
-            drImage->Update(
-                rect,
-                info.appearance.rTL,
-                info.appearance.rTR,
-                info.appearance.rBL,
-                info.appearance.rBR,
-                info.appearance.borderColour,
-                info.layout.bT,
-                info.layout.bB,
-                info.layout.bL,
-                info.layout.bR,
-                clipEnabled,
-                clipRect
-            );
-
-        }
-        else
-            SableUI_Error("Dynamic cast failed");
+        std::get<DrawableImage>(drawable).Update(
+            rect,
+            info.appearance->rTL,
+            info.appearance->rTR,
+            info.appearance->rBL,
+            info.appearance->rBR,
+            info.appearance->borderColour,
+            info.layout->bT,
+            info.layout->bB,
+            info.layout->bL,
+            info.layout->bR,
+            clipEnabled,
+            clipRect
+        );
         break;
 
     case ElementType::Text:
-        if (DrawableText* drText = dynamic_cast<DrawableText*>(drawable))
-        {
-            rect.h = drText->m_text.UpdateMaxWidth(rect.w);
-            info.layout.height = rect.h;
-            drText->Update(rect, clipEnabled, clipRect);
-        }
-        else
-            SableUI_Error("Dynamic cast failed");
-        break;
-
-    case ElementType::Div:
-        if (DrawableRect* drRect = dynamic_cast<DrawableRect*>(drawable))
-        {
-            drRect->Update(
-                rect,
-                info.appearance.bg,
-                info.appearance.rTL,
-                info.appearance.rTR,
-                info.appearance.rBL,
-                info.appearance.rBR,
-                info.appearance.borderColour,
-                info.layout.bT,
-                info.layout.bB,
-                info.layout.bL,
-                info.layout.bR,
-                clipEnabled,
-                clipRect
-            );
-        }
-        else
-            SableUI_Error("Dynamic cast failed");
+    {
+        DrawableText& drText = std::get<DrawableText>(drawable);
+        rect.h = drText.m_text.UpdateMaxWidth(rect.w);
+        measuredHeight = rect.h;
+        drText.Update(rect, clipEnabled, clipRect);
         break;
+    }
 
     default:
         SableUI_Error("Unknown ElementType");
         break;
     }
+
+    // repaints set the rect again without laying out the children, keep
+    // their bounds. a layout recomputes these once the children are placed
+    UpdateSubtreeBounds();
 }
 
 void SableUI::Element::SetInfo(const ElementInfo& info)
 {
     this->info = info;
+    this->info.internedId = ResolveId(info);
+    InternStyles(this->info);
+}
+
+static inline bool RectContains(const SableUI::Rect& outer, const SableUI::Rect& inner)
+{
+    return inner.x >= outer.x && inner.y >= outer.y &&
+        inner.x + inner.w <= outer.x + outer.w &&
+        inner.y + inner.h <= outer.y + outer.h;
 }
 
 void SableUI::Element::Render(CommandBuffer& cmd, const GpuFramebuffer* framebuffer, ContextResources& contextResources, int z)
 {
-    if (clipEnabled)
-    {
-        if (!rect.intersect(clipRect))
-        {
-            if (info.type == ElementType::Div)
-            {
-                for (Child* child : children)
-                {
-                    Element* childElement = (Element*)*child;
-                    childElement->Render(cmd, framebuffer, contextResources, z + 1);
-                }
-            }
-            return;
-        };
-    }
+    // whole subtree is outside the clip
+    if (clipEnabled && !subtreeBounds.intersect(clipRect))
+        return;
+
+    // scissor only when something in the subtree crosses the clip edge,
+    // nested clip rects are always inside the active scissor so most elements emit nothing
+    std::optional<Rect> prevScissor = cmd.GetScissor();
+    const bool scissored = clipEnabled && !RectContains(clipRect, subtreeBounds);
+
+    if (scissored)
+        cmd.SetScissor(clipRect.x, framebuffer->height - (clipRect.y + clipRect.h), clipRect.w, clipRect.h);
+
+    const bool selfVisible = !clipEnabled || rect.intersect(clipRect);
 
     switch (info.type)
     {
     case ElementType::Rect:
+    case ElementType::Div:
     {
-        if (DrawableRect* drRect = dynamic_cast<DrawableRect*>(drawable))
+        DrawableRect* drRect = std::get_if<DrawableRect>(&drawable);
+        if (selfVisible && drRect)
         {
             const bool hasBorder = HasBorder(info);
             const bool hasBg = HasVisibleBackground(info);
 
             if (hasBorder || hasBg)
             {
-                drawable->setZ(z);
+                drRect->setZ(z);
                 drRect->RecordCommands(cmd, framebuffer, contextResources);
             }
         }
-        else
+
+        if (info.type == ElementType::Div)
         {
-            SableUI_Error("Dynamic cast failed");
+            for (Child* child : children)
+            {
+                Element* childElement = (Element*)*child;
+                childElement->Render(cmd, framebuffer, contextResources, z + 1);
+            }
         }
         break;
     }
 
     case ElementType::Image:
     {
-        if (DrawableImage* drImage = dynamic_cast<DrawableImage*>(drawable))
-        {
-            drawable->setZ(z);
-            drImage->RecordCommands(cmd, framebuffer, contextResources);
-        }
-        else
-        {
-            SableUI_Error("Dynamic cast failed");
-        }
+        DrawableImage& drImage = std::get<DrawableImage>(drawable);
+        drImage.setZ(z);
+        drImage.RecordCommands(cmd, framebuffer, contextResources);
         break;
     }
 
     case ElementType::Text:
     {
-        if (DrawableText* drText = dynamic_cast<DrawableText*>(drawable))
-        {
-            drawable->setZ(z);
-            drText->RecordCommands(cmd, framebuffer, contextResources);
-        }
-        else
-        {
-            SableUI_Error("Dynamic cast failed");
-        }
-        break;
-    }
-
-    case ElementType::Div:
-    {
-        if (DrawableRect* drRect = dynamic_cast<DrawableRect*>(drawable))
-        {
-            const bool hasBorder = HasBorder(info);
-            const bool hasBg = HasVisibleBackground(info);
-
-            if (hasBorder || hasBg)
-            {
-                drawable->setZ(z);
-                drRect->RecordCommands(cmd, framebuffer, contextResources);
-            }
-        }
-        else
-        {
-			SableUI_Error("Dynamic cast failed");
-        }
-
-        for (Child* child : children)
-        {
-            Element* childElement = (Element*)*child;
-            childElement->Render(cmd, framebuffer, contextResources, z + 1);
-        }
+        DrawableText& drText = std::get<DrawableText>(drawable);
+        drText.setZ(z);
+        drText.RecordCommands(cmd, framebuffer, contextResources);
         break;
     }
 
@@ -288,6 +304,14 @@ void SableUI::Element::Render(CommandBuffer& cmd, const GpuFramebuffer* framebuf
         SableUI_Error("Unknown ElementType");
         break;
     }
+
+    if (scissored)
+    {
+        if (prevScissor.has_value())
+            cmd.SetScissor(prevScissor->x, prevScissor->y, prevScissor->w, prevScissor->h);
+        else
+            cmd.DisableScissor();
+    }
 }
 
 void SableUI::Element::AddChild(Element* child)
@@ -295,6 +319,7 @@ void SableUI::Element::AddChild(Element* child)
     if (info.type != ElementType::Div) { SableUI_Error("Cannot add child to element not of type div"); return; };
 
     children.emplace_back(SB_new<Child>(child));
+    if (m_owner) m_owner->InvalidateSpatialIndex();
 }
 
 void SableUI::Element::AddChild(Child* child)
@@ -302,15 +327,16 @@ void SableUI::Element::AddChild(Child* child)
     if (info.type != ElementType::Div) { SableUI_Error("Cannot add child to element not of type div"); return; };
 
     children.emplace_back(child);
+    if (m_owner) m_owner->InvalidateSpatialIndex();
 }
 
 void SableUI::Element::SetImage(const std::string& path)
 {
     if (info.type != ElementType::Image) SableUI_Error("Cannot set image on element not of type image");
 
-    if (DrawableImage* drImage = dynamic_cast<DrawableImage*>(drawable))
+    if (DrawableImage* drImage = std::get_if<DrawableImage>(&drawable))
     {
-        drImage->m_texture.LoadTextureOptimised(path, info.layout.width, info.layout.height);
+        drImage->m_texture.LoadTextureOptimised(path, info.layout->width, info.layout->height);
         info.text.content = path;
 
         if (m_owner)
@@ -318,7 +344,7 @@ void SableUI::Element::SetImage(const std::string& path)
     }
     else
     {
-        SableUI_Error("Dynamic cast failed");
+        SableUI_Error("Element has no image drawable");
     }
 }
 
@@ -326,7 +352,7 @@ void SableUI::Element::SetText(const SableString& text)
 {
     if (info.type != ElementType::Text) SableUI_Error("Cannot set text on element not of type text");
 
-    if (DrawableText* drText = dynamic_cast<DrawableText*>(drawable))
+    if (DrawableText* drText = std::get_if<DrawableText>(&drawable))
     {
         info.text.content = text;
         if (info.text.colour.has_value())
@@ -338,39 +364,45 @@ void SableUI::Element::SetText(const SableString& text)
             SableUI_Warn("Text colour not set, using default");
             drText->m_text.m_colour = GetTheme().text;
         }
-        drText->m_text.SetContent(renderer, text, drawable->m_rect.w,
-            info.text.fontSize, info.layout.maxH, info.text.lineHeight, info.text.justification.value_or(TextJustification::Left));
+        drText->m_text.SetContent(renderer, text, drText->m_rect.w,
+            info.text.fontSize, info.layout->maxH, info.text.lineHeight, info.text.justification.value_or(TextJustification::Left));
     }
     else
     {
-        SableUI_Error("Dynamic cast failed");
+        SableUI_Error("Element has no text drawable");
     }
 }
 
+SableUI::_Text* SableUI::Element::GetText()
+{
+    DrawableText* drText = std::get_if<DrawableText>(&drawable);
+    return drText ? &drText->m_text : nullptr;
+}
+
 int SableUI::Element::GetMinWidth()
 {
-    int calculatedMinWidth = info.layout.minW;
+    int calculatedMinWidth = info.layout->minW;
 
-    if (info.appearance.clipChildren)
-        return calculatedMinWidth + info.layout.pL + info.layout.pR + info.layout.bL + info.layout.bR;
+    if (info.appearance->clipChildren)
+        return calculatedMinWidth + info.layout->pL + info.layout->pR + info.layout->bL + info.layout->bR;
 
-    if (info.layout.wType == RectType::Fixed)
+    if (info.layout->wType == RectType::Fixed)
     {
-        return std::max(calculatedMinWidth, info.layout.width) +
-            info.layout.pL + info.layout.pR + info.layout.bL + info.layout.bR;
+        return std::max(calculatedMinWidth, info.layout->width) +
+            info.layout->pL + info.layout->pR + info.layout->bL + info.layout->bR;
     }
 
     if (info.type == ElementType::Div)
     {
-        bool isVerticalFlow = (info.layout.layoutDirection == LayoutDirection::UpDown
-            || info.layout.layoutDirection == LayoutDirection::DownUp);
+        bool isVerticalFlow = (info.layout->layoutDirection == LayoutDirection::UpDown
+            || info.layout->layoutDirection == LayoutDirection::DownUp);
         if (isVerticalFlow)
         {
             for (Child* child : children)
             {
                 Element* childElement = (Element*)*child;
                 int childTotalWidth = childElement->GetMinWidth() +
-                    childElement->info.layout.mL + childElement->info.layout.mR;
+                    childElement->info.layout->mL + childElement->info.layout->mR;
                 calculatedMinWidth = std::max(calculatedMinWidth, childTotalWidth);
             }
         }
@@ -380,50 +412,50 @@ int SableUI::Element::GetMinWidth()
             {
                 Element* childElement = (Element*)*child;
                 int childTotalWidth = childElement->GetMinWidth() +
-                    childElement->info.layout.mL + childElement->info.layout.mR;
+                    childElement->info.layout->mL + childElement->info.layout->mR;
                 calculatedMinWidth += childTotalWidth;
             }
         }
     }
     else if (info.type == ElementType::Text)
     {
-        if (DrawableText* drText = dynamic_cast<DrawableText*>(drawable))
+        if (DrawableText* drText = std::get_if<DrawableText>(&drawable))
         {
             calculatedMinWidth = std::max(calculatedMinWidth, drText->m_text.GetMinWidth(info.text.wrap));
         }
     }
     else
     {
-        calculatedMinWidth = std::max(calculatedMinWidth, info.layout.width);
+        calculatedMinWidth = std::max(calculatedMinWidth, info.layout->width);
     }
 
-    return calculatedMinWidth + info.layout.pL + info.layout.pR + info.layout.bL + info.layout.bR;
+    return calculatedMinWidth + info.layout->pL + info.layout->pR + info.layout->bL + info.layout->bR;
 }
 
 int SableUI::Element::GetMinHeight()
 {
-    int calculatedMinHeight = info.layout.minH;
+    int calculatedMinHeight = info.layout->minH;
 
-    if (info.appearance.clipChildren)
-        return calculatedMinHeight + info.layout.pT + info.layout.pB + info.layout.bT + info.layout.bB;
+    if (info.appearance->clipChildren)
+        return calculatedMinHeight + info.layout->pT + info.layout->pB + info.layout->bT + info.layout->bB;
 
-    if (info.layout.hType == RectType::Fixed)
+    if (info.layout->hType == RectType::Fixed)
     {
-        return std::max(calculatedMinHeight, info.layout.height) +
-            info.layout.pT + info.layout.pB + info.layout.bT + info.layout.bB;
+        return std::max(calculatedMinHeight, info.layout->height) +
+            info.layout->pT + info.layout->pB + info.layout->bT + info.layout->bB;
     }
 
     if (info.type == ElementType::Div)
     {
-        bool isVerticalFlow = (info.layout.layoutDirection == LayoutDirection::UpDown
-            || info.layout.layoutDirection == LayoutDirection::DownUp);
+        bool isVerticalFlow = (info.layout->layoutDirection == LayoutDirection::UpDown
+            || info.layout->layoutDirection == LayoutDirection::DownUp);
         if (isVerticalFlow)
         {
             for (Child* child : children)
             {
                 Element* childElement = (Element*)*child;
                 int childTotalHeight = childElement->GetMinHeight() +
-                    childElement->info.layout.mT + childElement->info.layout.mB;
+                    childElement->info.layout->mT + childElement->info.layout->mB;
                 calculatedMinHeight += childTotalHeight;
             }
         }
@@ -433,7 +465,7 @@ int SableUI::Element::GetMinHeight()
             {
                 Element* childElement = (Element*)*child;
                 int childTotalHeight = childElement->GetMinHeight() +
-                    childElement->info.layout.mT + childElement->info.layout.mB;
+                    childElement->info.layout->mT + childElement->info.layout->mB;
                 calculatedMinHeight = std::max(calculatedMinHeight, childTotalHeight);
             }
         }
@@ -446,7 +478,7 @@ int SableUI::Element::GetMinHeight()
         }
         else
         {
-            if (DrawableText* drText = dynamic_cast<DrawableText*>(drawable))
+            if (DrawableText* drText = std::get_if<DrawableText>(&drawable))
             {
                 calculatedMinHeight = std::max(calculatedMinHeight, drText->m_text.GetUnwrappedHeight());
             }
@@ -454,10 +486,10 @@ int SableUI::Element::GetMinHeight()
     }
     else
     {
-        calculatedMinHeight = std::max(calculatedMinHeight, info.layout.height);
+        calculatedMinHeight = std::max(calculatedMinHeight, info.layout->height);
     }
 
-    return calculatedMinHeight + info.layout.pT + info.layout.pB + info.layout.bT + info.layout.bB;
+    return calculatedMinHeight + info.layout->pT + info.layout->pB + info.layout->bT + info.layout->bB;
 }
 
 void SableUI::Element::LayoutChildren()
@@ -465,16 +497,19 @@ void SableUI::Element::LayoutChildren()
     if (info.type != ElementType::Div) return;
     if (children.empty()) return;
 
-    if (info.layout.pos.x != -1 || info.layout.pos.y != -1)
+    s_layoutEpoch++;
+    if (m_owner) m_owner->InvalidateSpatialIndex();
+
+    if (info.layout->pos.x != -1 || info.layout->pos.y != -1)
     {
-        rect.x = info.layout.pos.x;
-        rect.y = info.layout.pos.y;
+        rect.x = info.layout->pos.x;
+        rect.y = info.layout->pos.y;
     }
 
-    bool isVerticalFlow = (info.layout.layoutDirection == LayoutDirection::UpDown
-        || info.layout.layoutDirection == LayoutDirection::DownUp);
-    bool isReverseFlow = (info.layout.layoutDirection == LayoutDirection::DownUp
-        || info.layout.layoutDirection == LayoutDirection::RightLeft);
+    bool isVerticalFlow = (info.layout->layoutDirection == LayoutDirection::UpDown
+        || info.layout->layoutDirection == LayoutDirection::DownUp);
+    bool isReverseFlow = (info.layout->layoutDirection == LayoutDirection::DownUp
+        || info.layout->layoutDirection == LayoutDirection::RightLeft);
 
     size_t numChildren = children.size();
 
@@ -492,18 +527,19 @@ void SableUI::Element::LayoutChildren()
             childElement->SetRect({ rect.x, rect.y, 0, 0 });
             childElement->LayoutChildren();
         }
+        UpdateSubtreeBounds();
         return;
     }
 
     // NEW: Calculate content area (after padding AND border)
     // Border is applied INSIDE the padding
     ivec2 contentAreaPosition = {
-        rect.x + info.layout.pL + info.layout.bL,
-        rect.y + info.layout.pT + info.layout.bT
+        rect.x + info.layout->pL + info.layout->bL,
+        rect.y + info.layout->pT + info.layout->bT
     };
     ivec2 contentAreaSize = {
-        std::max(0, containerSize.x - info.layout.pL - info.layout.pR - info.layout.bL - info.layout.bR),
-        std::max(0, containerSize.y - info.layout.pT - info.layout.pB - info.layout.bT - info.layout.bB)
+        std::max(0, containerSize.x - info.layout->pL - info.layout->pR - info.layout->bL - info.layout->bR),
+        std::max(0, containerSize.y - info.layout->pT - info.layout->pB - info.layout->bT - info.layout->bB)
     };
 
     if (contentAreaSize.x <= 0 || contentAreaSize.y <= 0)
@@ -514,6 +550,7 @@ void SableUI::Element::LayoutChildren()
             childElement->SetRect({ contentAreaPosition.x, contentAreaPosition.y, 0, 0 });
             childElement->LayoutChildren();
         }
+        UpdateSubtreeBounds();
         return;
     }
 
@@ -529,7 +566,7 @@ void SableUI::Element::LayoutChildren()
         Rect currentConstraint = { 0, 0, 0, 0 };
         bool hasConstraint = false;
 
-        if (this->info.appearance.clipChildren)
+        if (this->info.appearance->clipChildren)
         {
             currentConstraint = { rect.x, rect.y, rect.w, rect.h };
             hasConstraint = true;
@@ -556,44 +593,44 @@ void SableUI::Element::LayoutChildren()
 
         if (isVerticalFlow)
         {
-            totalMarginMainAxis += childElement->info.layout.mT + childElement->info.layout.mB;
+            totalMarginMainAxis += childElement->info.layout->mT + childElement->info.layout->mB;
 
-            if (childElement->info.layout.hType == RectType::Fixed)
+            if (childElement->info.layout->hType == RectType::Fixed)
             {
-                totalFixedMainAxis += std::min(std::max(childElement->info.layout.height, childElement->info.layout.minH),
-                    childElement->info.layout.maxH > 0 ? childElement->info.layout.maxH : childElement->info.layout.height);
+                totalFixedMainAxis += std::min(std::max(childElement->info.layout->height, childElement->info.layout->minH),
+                    childElement->info.layout->maxH > 0 ? childElement->info.layout->maxH : childElement->info.layout->height);
             }
-            else if (childElement->info.layout.hType == RectType::FitContent)
+            else if (childElement->info.layout->hType == RectType::FitContent)
             {
                 int minHeight = childElement->GetMinHeight();
                 totalFixedMainAxis += std::min(std::max(0, minHeight),
-                    childElement->info.layout.maxH > 0 ? childElement->info.layout.maxH : minHeight);
+                    childElement->info.layout->maxH > 0 ? childElement->info.layout->maxH : minHeight);
             }
-            else if (childElement->info.layout.hType == RectType::Fill)
+            else if (childElement->info.layout->hType == RectType::Fill)
             {
                 fillMainAxisCount++;
-                totalPaddingOfFillElementsMainAxis += childElement->info.layout.pT + childElement->info.layout.pB;
+                totalPaddingOfFillElementsMainAxis += childElement->info.layout->pT + childElement->info.layout->pB;
             }
         }
         else
         {
-            totalMarginMainAxis += childElement->info.layout.mL + childElement->info.layout.mR;
+            totalMarginMainAxis += childElement->info.layout->mL + childElement->info.layout->mR;
 
-            if (childElement->info.layout.wType == RectType::Fixed)
+            if (childElement->info.layout->wType == RectType::Fixed)
             {
-                totalFixedMainAxis += std::min(std::max(childElement->info.layout.width, childElement->info.layout.minW),
-                    childElement->info.layout.maxW > 0 ? childElement->info.layout.maxW : childElement->info.layout.width);
+                totalFixedMainAxis += std::min(std::max(childElement->info.layout->width, childElement->info.layout->minW),
+                    childElement->info.layout->maxW > 0 ? childElement->info.layout->maxW : childElement->info.layout->width);
             }
-            else if (childElement->info.layout.wType == RectType::FitContent)
+            else if (childElement->info.layout->wType == RectType::FitContent)
             {
                 int minWidth = childElement->GetMinWidth();
                 totalFixedMainAxis += std::min(std::max(0, minWidth),
-                    childElement->info.layout.maxW > 0 ? childElement->info.layout.maxW : minWidth);
+                    childElement->info.layout->maxW > 0 ? childElement->info.layout->maxW : minWidth);
             }
-            else if (childElement->info.layout.wType == RectType::Fill)
+            else if (childElement->info.layout->wType == RectType::Fill)
             {
                 fillMainAxisCount++;
-                totalPaddingOfFillElementsMainAxis += childElement->info.layout.pL + childElement->info.layout.pR;
+                totalPaddingOfFillElementsMainAxis += childElement->info.layout->pL + childElement->info.layout->pR;
             }
         }
     }
@@ -614,20 +651,20 @@ void SableUI::Element::LayoutChildren()
     {
         Element* childElement = (Element*)*child;
 
-        int childMarginWidth = childElement->info.layout.mL + childElement->info.layout.mR;
-        int childMarginHeight = childElement->info.layout.mT + childElement->info.layout.mB;
+        int childMarginWidth = childElement->info.layout->mL + childElement->info.layout->mR;
+        int childMarginHeight = childElement->info.layout->mT + childElement->info.layout->mB;
 
         int childContentWidth, childContentHeight;
 
         // Rest of the layout logic remains the same...
         if (isVerticalFlow)
         {
-            if (childElement->info.layout.wType == RectType::Fixed)
+            if (childElement->info.layout->wType == RectType::Fixed)
             {
-                childContentWidth = childElement->info.layout.width;
+                childContentWidth = childElement->info.layout->width;
             }
             else if (childElement->info.type == ElementType::Text
-                || childElement->info.layout.wType == RectType::FitContent)
+                || childElement->info.layout->wType == RectType::FitContent)
             {
                 childContentWidth = std::max(0, contentAreaSize.x - childMarginWidth);
             }
@@ -638,27 +675,22 @@ void SableUI::Element::LayoutChildren()
 
             if (childElement->info.type == ElementType::Text)
             {
-                if (DrawableText* drText = dynamic_cast<DrawableText*>(childElement->drawable))
+                if (DrawableText* drText = std::get_if<DrawableText>(&childElement->drawable))
                 {
-                    int newHeight = drText->m_text.UpdateMaxWidth(childContentWidth);
-                    if (newHeight != childElement->info.layout.height)
-                    {
-                        childElement->info.layout.height = newHeight;
-                    }
-                    childContentHeight = newHeight;
+                    childContentHeight = drText->m_text.UpdateMaxWidth(childContentWidth);
                 }
                 else
                 {
-                    childContentHeight = childElement->info.layout.height;
+                    childContentHeight = childElement->info.layout->height;
                 }
             }
-            else if (childElement->info.layout.hType == RectType::Fixed)
+            else if (childElement->info.layout->hType == RectType::Fixed)
             {
-                childContentHeight = childElement->info.layout.height;
+                childContentHeight = childElement->info.layout->height;
             }
-            else if (childElement->info.layout.hType == RectType::FitContent)
+            else if (childElement->info.layout->hType == RectType::FitContent)
             {
-                childContentHeight = std::max(0, childElement->GetMinHeight() - childElement->info.layout.pT - childElement->info.layout.pB);
+                childContentHeight = std::max(0, childElement->GetMinHeight() - childElement->info.layout->pT - childElement->info.layout->pB);
             }
             else
             {
@@ -669,36 +701,36 @@ void SableUI::Element::LayoutChildren()
                     distributedRemainder++;
                 }
             }
-            childContentHeight = std::max(childContentHeight, childElement->info.layout.minH);
-            childContentHeight = (childElement->info.layout.maxH > 0) ?
-                std::min(childContentHeight, childElement->info.layout.maxH) : childContentHeight;
+            childContentHeight = std::max(childContentHeight, childElement->info.layout->minH);
+            childContentHeight = (childElement->info.layout->maxH > 0) ?
+                std::min(childContentHeight, childElement->info.layout->maxH) : childContentHeight;
 
-            if (childElement->info.layout.wType == RectType::Fixed)
+            if (childElement->info.layout->wType == RectType::Fixed)
             {
-                childContentWidth = childElement->info.layout.width;
+                childContentWidth = childElement->info.layout->width;
             }
-            else if (childElement->info.layout.wType == RectType::FitContent)
+            else if (childElement->info.layout->wType == RectType::FitContent)
             {
-                childContentWidth = std::max(0, childElement->GetMinWidth() - childElement->info.layout.pL - childElement->info.layout.pR);
+                childContentWidth = std::max(0, childElement->GetMinWidth() - childElement->info.layout->pL - childElement->info.layout->pR);
             }
             else
             {
                 childContentWidth = std::max(0, contentAreaSize.x - childMarginWidth);
             }
 
-            childContentWidth = std::max(childContentWidth, childElement->info.layout.minW);
-            childContentWidth = (childElement->info.layout.maxW > 0) ?
-                std::min(childContentWidth, childElement->info.layout.maxW) : childContentWidth;
+            childContentWidth = std::max(childContentWidth, childElement->info.layout->minW);
+            childContentWidth = (childElement->info.layout->maxW > 0) ?
+                std::min(childContentWidth, childElement->info.layout->maxW) : childContentWidth;
         }
         else
         {
-            if (childElement->info.layout.wType == RectType::Fixed)
+            if (childElement->info.layout->wType == RectType::Fixed)
             {
-                childContentWidth = childElement->info.layout.width;
+                childContentWidth = childElement->info.layout->width;
             }
-            else if (childElement->info.layout.wType == RectType::FitContent)
+            else if (childElement->info.layout->wType == RectType::FitContent)
             {
-                childContentWidth = std::max(0, childElement->GetMinWidth() - childElement->info.layout.pL - childElement->info.layout.pR);
+                childContentWidth = std::max(0, childElement->GetMinWidth() - childElement->info.layout->pL - childElement->info.layout->pR);
             }
             else
             {
@@ -710,13 +742,13 @@ void SableUI::Element::LayoutChildren()
                 }
             }
 
-            if (childElement->info.layout.hType == RectType::Fixed)
+            if (childElement->info.layout->hType == RectType::Fixed)
             {
-                childContentHeight = childElement->info.layout.height;
+                childContentHeight = childElement->info.layout->height;
             }
-            else if (childElement->info.layout.hType == RectType::FitContent)
+            else if (childElement->info.layout->hType == RectType::FitContent)
             {
-                childContentHeight = std::max(0, childElement->GetMinHeight() - childElement->info.layout.pT - childElement->info.layout.pB);
+                childContentHeight = std::max(0, childElement->GetMinHeight() - childElement->info.layout->pT - childElement->info.layout->pB);
             }
             else
             {
@@ -729,21 +761,16 @@ void SableUI::Element::LayoutChildren()
 
         if (childElement->info.type == ElementType::Text && isVerticalFlow)
         {
-            if (DrawableText* drText = dynamic_cast<DrawableText*>(childElement->drawable))
+            if (DrawableText* drText = std::get_if<DrawableText>(&childElement->drawable))
             {
-                int newHeight = drText->m_text.UpdateMaxWidth(childContentWidth);
-                if (newHeight != childElement->info.layout.height)
-                {
-                    childElement->info.layout.height = newHeight;
-                }
-                childContentHeight = newHeight;
+                childContentHeight = drText->m_text.UpdateMaxWidth(childContentWidth);
             }
         }
 
         childElement->measuredHeight = childContentHeight;
 
-        childContentWidth += childElement->info.layout.pL + childElement->info.layout.pR;
-        childContentHeight += childElement->info.layout.pT + childElement->info.layout.pB;
+        childContentWidth += childElement->info.layout->pL + childElement->info.layout->pR;
+        childContentHeight += childElement->info.layout->pT + childElement->info.layout->pB;
 
         int childTotalWidth = childContentWidth + childMarginWidth;
         int childTotalHeight = childContentHeight + childMarginHeight;
@@ -755,57 +782,57 @@ void SableUI::Element::LayoutChildren()
             if (isVerticalFlow)
             {
                 cursor.y -= childTotalHeight;
-                childX = cursor.x + childElement->info.layout.mL;
-                childY = cursor.y + childElement->info.layout.mT;
+                childX = cursor.x + childElement->info.layout->mL;
+                childY = cursor.y + childElement->info.layout->mT;
             }
             else
             {
                 cursor.x -= childTotalWidth;
-                childX = cursor.x + childElement->info.layout.mL;
-                childY = cursor.y + childElement->info.layout.mT;
+                childX = cursor.x + childElement->info.layout->mL;
+                childY = cursor.y + childElement->info.layout->mT;
             }
         }
         else
         {
             if (isVerticalFlow)
             {
-                childX = cursor.x + childElement->info.layout.mL;
-                childY = cursor.y + childElement->info.layout.mT;
+                childX = cursor.x + childElement->info.layout->mL;
+                childY = cursor.y + childElement->info.layout->mT;
                 cursor.y += childTotalHeight;
             }
             else
             {
-                childX = cursor.x + childElement->info.layout.mL;
-                childY = cursor.y + childElement->info.layout.mT;
+                childX = cursor.x + childElement->info.layout->mL;
+                childY = cursor.y + childElement->info.layout->mT;
                 cursor.x += childTotalWidth;
             }
         }
 
         if (isVerticalFlow)
         {
-            if (childElement->info.layout.centerX)
+            if (childElement->info.layout->centerX)
             {
                 int available = contentAreaSize.x - childTotalWidth;
                 if (available > 0)
-                    childX = contentAreaPosition.x + available / 2 + childElement->info.layout.mL;
+                    childX = contentAreaPosition.x + available / 2 + childElement->info.layout->mL;
             }
         }
         else
         {
-            if (childElement->info.layout.centerY)
+            if (childElement->info.layout->centerY)
             {
                 int available = contentAreaSize.y - childTotalHeight;
                 if (available > 0)
-                    childY = contentAreaPosition.y + available / 2 + childElement->info.layout.mT;
+                    childY = contentAreaPosition.y + available / 2 + childElement->info.layout->mT;
             }
         }
 
         if (children.size() == 1)
         {
-            if (childElement->info.layout.centerX)
-                childX = contentAreaPosition.x + (contentAreaSize.x - childTotalWidth) / 2 + childElement->info.layout.mL;
-            if (childElement->info.layout.centerY)
-                childY = contentAreaPosition.y + (contentAreaSize.y - childTotalHeight) / 2 + childElement->info.layout.mT;
+            if (childElement->info.layout->centerX)
+                childX = contentAreaPosition.x + (contentAreaSize.x - childTotalWidth) / 2 + childElement->info.layout->mL;
+            if (childElement->info.layout->centerY)
+                childY = contentAreaPosition.y + (contentAreaSize.y - childTotalHeight) / 2 + childElement->info.layout->mT;
         }
 
         Rect childFinalRect = {
@@ -818,144 +845,535 @@ void SableUI::Element::LayoutChildren()
         childElement->SetRect(childFinalRect);
         childElement->LayoutChildren();
     }
+
+    UpdateSubtreeBounds();
+}
+
+void SableUI::Element::UpdateSubtreeBounds()
+{
+    int minX = rect.x, minY = rect.y;
+    int maxX = rect.x + rect.w, maxY = rect.y + rect.h;
+
+    for (Child* child : children)
+    {
+        Element* childElement = (Element*)*child;
+        if (!childElement) continue;
+
+        const Rect& b = childElement->subtreeBounds;
+        if (b.w <= 0 || b.h <= 0) continue;
+
+        minX = std::min(minX, b.x);
+        minY = std::min(minY, b.y);
+        maxX = std::max(maxX, b.x + b.w);
+        maxY = std::max(maxY, b.y + b.h);
+    }
+
+    subtreeBounds = { minX, minY, maxX - minX, maxY - minY };
 }
 
 void SableUI::Element::RegisterForHover()
 {
-    if (info.appearance.hasHoverBg && m_owner)
+    if (info.appearance->hasHoverBg && m_owner)
         m_owner->RegisterHoverElement(this);
 }
 
+void SableUI::Element::RegisterId()
+{
+    if (info.internedId && m_owner)
+        m_owner->RegisterElementId(this);
+}
+
+void SableUI::Element::SyncId(const ElementInfo& other)
+{
+    ElementId newId = ResolveId(other);
+    if (newId == info.internedId) return;
+
+    if (info.internedId && m_owner)
+        m_owner->UnregisterElementId(this);
+
+    info.id = other.id;
+    info.internedId = newId;
+    RegisterId();
+}
+
 SableUI::ElementInfo SableUI::Element::GetInfo() const
 {
     return info;
 }
 
-static inline void hash_combine(std::size_t& seed, std::size_t v) {
+#include <SableUI/SableUI.h>
+static inline void HashCombine(size_t& seed, size_t v)
+{
     seed ^= v + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
 }
 
-#include <SableUI/SableUI.h>
-static size_t ComputeHash(const SableUI::ElementInfo& info)
+static inline size_t HashColour(const std::optional<SableUI::Colour>& c)
+{
+    if (!c.has_value()) return 0x51ed27;
+    return (static_cast<size_t>(c->r) << 24) | (c->g << 16) | (c->b << 8) | c->a;
+}
+
+static inline size_t HashFloat(float f)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+size_t SableUI::HashStyle(const LayoutProps& l)
+{
+    size_t h = 1469598103934665603ULL;
+
+    HashCombine(h, (static_cast<size_t>(l.wType) << 16) | (static_cast<size_t>(l.hType) << 8) | static_cast<size_t>(l.layoutDirection));
+    HashCombine(h, (static_cast<size_t>(static_cast<uint32_t>(l.width)) << 32) | static_cast<uint32_t>(l.height));
+    HashCombine(h, (static_cast<size_t>(static_cast<uint32_t>(l.minW)) << 32) | static_cast<uint32_t>(l.minH));
+    HashCombine(h, (static_cast<size_t>(static_cast<uint32_t>(l.maxW)) << 32) | static_cast<uint32_t>(l.maxH));
+    for (int v : { l.pT, l.pB, l.pL, l.pR, l.mT, l.mB, l.mL, l.mR, l.bT, l.bB, l.bL, l.bR })
+        HashCombine(h, static_cast<uint32_t>(v));
+    HashCombine(h, (static_cast<size_t>(static_cast<uint32_t>(l.pos.x)) << 32) | static_cast<uint32_t>(l.pos.y));
+    HashCombine(h, (l.centerX ? 1 : 0) | (l.centerY ? 2 : 0));
+
+    return h;
+}
+
+size_t SableUI::HashStyle(const AppearanceProps& a)
+{
+    size_t h = 1469598103934665603ULL;
+
+    HashCombine(h, (a.hasHoverBg ? 1 : 0) | (a.inheritBg ? 2 : 0) | (a.disabled ? 4 : 0)
+        | (a.clipChildren ? 8 : 0) | (static_cast<size_t>(a.size) << 8));
+    HashCombine(h, HashColour(a.bg));
+    HashCombine(h, HashColour(a.hoverBg));
+    HashCombine(h, HashColour(a.borderColour));
+    HashCombine(h, HashFloat(a.rTL));
+    HashCombine(h, HashFloat(a.rTR));
+    HashCombine(h, HashFloat(a.rBL));
+    HashCombine(h, HashFloat(a.rBR));
+
+    return h;
+}
+
+void SableUI::InternStyles(ElementInfo& info)
+{
+    info.layout.Intern();
+    info.appearance.Intern();
+}
+
+size_t SableUI::HashElementInfo(const ElementInfo& info)
 {
     size_t h = 1469598103934665603ULL;
+    const TextProps& t = info.text;
+
+    HashCombine(h, (static_cast<size_t>(info.type) << 32) | info.internedId.value);
+    HashCombine(h, info.key);
+    if (!info.id.empty()) HashCombine(h, info.id.Hash());
+
+    // style records cache their own hash
+    HashCombine(h, info.layout.Hash());
+    HashCombine(h, info.appearance.Hash());
+
+    // unset text colour resolves to the theme, so a theme switch still diffs
+    if (info.type == ElementType::Text && !t.colour.has_value())
+        HashCombine(h, HashColour(GetTheme().text));
+    else
+        HashCombine(h, HashColour(t.colour));
 
-    hash_combine(h, std::hash<int>()((int)info.type));
-    if (info.text.content.size() != 0)
+    if (!t.content.empty()) HashCombine(h, t.content.Hash());
+    HashCombine(h, (static_cast<size_t>(t.fontSize) << 32) | HashFloat(t.lineHeight));
+    HashCombine(h, t.justification.has_value() ? static_cast<size_t>(t.justification.value()) + 1 : 0);
+    HashCombine(h, t.wrap ? 1 : 0);
+
+    return (h != 0) ? h : 1;
+}
+
+static inline bool LayoutPropsEqual(const SableUI::LayoutProps& a, const SableUI::LayoutProps& b)
+{
+    return a.wType == b.wType && a.hType == b.hType && a.layoutDirection == b.layoutDirection
+        && a.width == b.width && a.height == b.height
+        && a.minW == b.minW && a.maxW == b.maxW && a.minH == b.minH && a.maxH == b.maxH
+        && a.pT == b.pT && a.pB == b.pB && a.pL == b.pL && a.pR == b.pR
+        && a.mT == b.mT && a.mB == b.mB && a.mL == b.mL && a.mR == b.mR
+        && a.bT == b.bT && a.bB == b.bB && a.bL == b.bL && a.bR == b.bR
+        && a.centerX == b.centerX && a.centerY == b.centerY && a.pos == b.pos;
+}
+
+static SableUI::PropChange ClassifyChange(const SableUI::Element& el, const SableUI::ElementInfo& next)
+{
+    using namespace SableUI;
+    const ElementInfo& cur = el.info;
+
+    if (cur.type != next.type)
+        return PropChange::Structural;
+
+    // images load their texture on creation
+    if (cur.type == ElementType::Image && !(cur.text.content == next.text.content))
+        return PropChange::Structural;
+
+    // interned records compare by pointer before falling back to the props
+    bool sameLayout = cur.layout.SameRecord(next.layout)
+        || LayoutPropsEqual(*cur.layout, *next.layout);
+    bool sameAppearance = cur.appearance.SameRecord(next.appearance);
+
+    if (!sameLayout
+        || cur.appearance->clipChildren != next.appearance->clipChildren
+        || cur.text.fontSize != next.text.fontSize
+        || cur.text.lineHeight != next.text.lineHeight
+        || cur.text.wrap != next.text.wrap
+        || cur.text.justification != next.text.justification
+        || !(cur.text.content == next.text.content))
+        return PropChange::Layout;
+
+    bool appearanceChanged = !sameAppearance && (cur.appearance->bg != next.appearance->bg
+        || cur.appearance->hasHoverBg != next.appearance->hasHoverBg
+        || !(cur.appearance->hoverBg == next.appearance->hoverBg)
+        || cur.appearance->borderColour != next.appearance->borderColour
+        || cur.appearance->rTL != next.appearance->rTL || cur.appearance->rTR != next.appearance->rTR
+        || cur.appearance->rBL != next.appearance->rBL || cur.appearance->rBR != next.appearance->rBR);
+
+    // text colour lives outside the appearance record, a shared record says nothing about it
+    if (appearanceChanged || cur.text.colour != next.text.colour)
+        return PropChange::Paint;
+
+    return PropChange::None;
+}
+
+static bool CanReuse(SableUI::Child* childWrapper, const SableUI::VirtualNode* childVn)
+{
+    bool isComponent = (childWrapper->type == SableUI::ChildType::COMPONENT);
+    bool wantsComponent = (childVn->childComp != nullptr);
+
+    if (isComponent != wantsComponent)
+        return false;
+
+    return !isComponent || childWrapper->component == childVn->childComp;
+}
+
+static void CountChange(SableUI::PropChange change)
+{
+    switch (change)
     {
-        std::string s = (std::string)(info.text.content);
-        hash_combine(h, std::hash<std::string>()(s));
+    case SableUI::PropChange::None:         s_reconcileStats.unchanged++; break;
+    case SableUI::PropChange::Paint:        s_reconcileStats.paintPatches++; break;
+    case SableUI::PropChange::Layout:       s_reconcileStats.layoutPatches++; break;
+    case SableUI::PropChange::Structural:   break;
     }
+}
+
+// handlers are not diffed, always take the latest closures
+static bool IsHitTestable(const SableUI::ElementInfo& i)
+{
+    return i.onClickFunc || i.onSecondaryClickFunc || i.onDoubleClickFunc || i.appearance->hasHoverBg;
+}
 
-    hash_combine(h, ((int)info.layout.wType << 8) | (int)info.layout.hType);
+// handlers are patched without a layout, the owner's hit-test index is
+// dropped here when an element enters or leaves it
+static void CopyHandlers(SableUI::Element& dst, const SableUI::ElementInfo& src)
+{
+    bool wasHitTestable = IsHitTestable(dst.info);
+
+    dst.info.onClickFunc = src.onClickFunc;
+    dst.info.onSecondaryClickFunc = src.onSecondaryClickFunc;
+    dst.info.onDoubleClickFunc = src.onDoubleClickFunc;
+
+    if (dst.m_owner && wasHitTestable != IsHitTestable(dst.info))
+        dst.m_owner->InvalidateSpatialIndex();
+}
+
+SableUI::PropChange SableUI::Element::PatchInfo(const ElementInfo& next)
+{
+    bool wasHitTestable = IsHitTestable(info);
+    CopyHandlers(*this, next);
+    info.key = next.key;
+
+    PropChange change = ClassifyChange(*this, next);
+    if (change == PropChange::None || change == PropChange::Structural)
+        return change;
+
+    // ids are synced separately so the owner's id index stays consistent
+    ElementInfo patched = next;
+    patched.id = info.id;
+    patched.internedId = info.internedId;
+
+    info = std::move(patched);
+    InternStyles(info);
+
+    if (m_owner && wasHitTestable != IsHitTestable(info))
+        m_owner->InvalidateSpatialIndex();
 
-    hash_combine(h, (info.layout.width << 16) | info.layout.height);
-    hash_combine(h, (info.layout.minW << 16) | info.layout.minH);
-    hash_combine(h, (info.layout.maxW << 16) | info.layout.maxH);
+    // text colour is baked into the glyph vertices
+    if (info.type == ElementType::Text)
+        SetText(info.text.content);
 
-    hash_combine(h, (info.layout.mT << 24) | (info.layout.mR << 16) |
-        (info.layout.mB << 8) | info.layout.mL);
+    SetRect(rect);
+    return change;
+}
+
+static void StoreSource(SableUI::Element& el, const SableUI::VirtualNode& vn)
+{
+    el.sourceHash = vn.hash;
+    el.sourceLayout = vn.info.layout;
+    el.sourceAppearance = vn.info.appearance;
+    el.sourceText = vn.info.text;
+}
+
+// the props sourceHash covers, styles are interned so equal records are the same record
+static bool SameSource(const SableUI::Element& el, const SableUI::VirtualNode& vn)
+{
+    const SableUI::ElementInfo& next = vn.info;
+    const SableUI::TextProps& a = el.sourceText;
+    const SableUI::TextProps& b = next.text;
+
+    if (el.sourceHash != vn.hash || el.info.type != next.type || el.info.key != next.key)
+        return false;
 
-    hash_combine(h, (info.layout.pT << 24) | (info.layout.pR << 16) |
-        (info.layout.pB << 8) | info.layout.pL);
+    if (next.internedId ? next.internedId != el.info.internedId : !(next.id == el.info.id))
+        return false;
 
-    hash_combine(h, (info.text.fontSize << 16) |
-        (static_cast<int>(info.text.lineHeight * 1000) & 0xFFFF));
+    if (!el.sourceLayout.SameRecord(next.layout) || !el.sourceAppearance.SameRecord(next.appearance))
+        return false;
 
-    if (info.text.colour.has_value())
+    return a.fontSize == b.fontSize && a.lineHeight == b.lineHeight && a.wrap == b.wrap
+        && a.colour == b.colour && a.justification == b.justification
+        && a.content.size() == b.content.size()
+        && (a.content.begin() == b.content.begin() || a.content == b.content);
+}
+
+SableUI::Child* SableUI::Element::BuildChild(VirtualNode* vnode)
+{
+    // builders append to this->children, take the new child back off the end
+    size_t count = this->children.size();
+
+    SetElementBuilderContext(this->renderer, this, false);
+    BuildSingleElementFromVirtual(vnode);
+
+    if (this->children.size() == count)
+    {
+        SableUI_Error("Failed to build child of type %d", static_cast<int>(vnode->info.type));
+        return nullptr;
+    }
+
+    Child* child = this->children.back();
+    this->children.pop_back();
+    StoreSource(*(Element*)*child, *vnode);
+    s_reconcileStats.created++;
+    return child;
+}
+
+SableUI::PropChange SableUI::Element::PatchChild(Element* childEl, VirtualNode* childVn, bool parentPatched)
+{
+    // same source props under an unpatched parent, nothing to resolve or diff
+    if (!parentPatched && SameSource(*childEl, *childVn))
     {
-        const SableUI::Colour& c = info.text.colour.value();
-		hash_combine(h, (c.r << 24) | (c.g << 16) |
-			(c.b << 8) | c.a);
+        CopyHandlers(*childEl, childVn->info);
+        return PropChange::None;
     }
 
-    hash_combine(h, ((int)info.text.justification.value_or(SableUI::TextJustification::Left) << 16) |
-        (info.text.wrap ? 1 : 0));
+    ElementInfo resolved = childVn->info;
+    ResolveElementInfo(resolved, this);
 
-    hash_combine(h, ((int)info.layout.layoutDirection << 24) |
-        (info.layout.centerX ? (1 << 16) : 0) |
-        (info.layout.centerY ? (1 << 8) : 0));
+    PropChange change = childEl->PatchInfo(resolved);
+    if (change == PropChange::Structural)
+        return change;
 
-    hash_combine(h, info.appearance.rTL);
-    hash_combine(h, info.appearance.rTR);
-    hash_combine(h, info.appearance.rBL);
-    hash_combine(h, info.appearance.rBR);
+    StoreSource(*childEl, *childVn);
+    childEl->SyncId(childVn->info);
+    return change;
+}
 
-    if (info.text.colour.has_value())
+static bool HasKeyedChildren(const SableUI::VirtualNode* vnode)
+{
+    for (const SableUI::VirtualNode* child : vnode->children)
+        if (child->info.key != 0)
+            return true;
+
+    return false;
+}
+
+// length of the longest increasing run of old indices, these children keep
+// their relative order and everything else counts as a move
+static size_t LongestIncreasingSubsequence(const std::vector<size_t>& seq)
+{
+    std::vector<size_t> tails;
+    for (size_t v : seq)
     {
-        const SableUI::Colour& c = info.text.colour.value();
-		hash_combine(h, (c.r << 24) | (c.g << 16) |
-			(c.b << 8) | c.a);
+        auto it = std::lower_bound(tails.begin(), tails.end(), v);
+        if (it == tails.end()) tails.push_back(v);
+        else *it = v;
     }
 
-    return h;
+    return tails.size();
 }
 
-bool SableUI::Element::Reconcile(VirtualNode* vnode)
+SableUI::PropChange SableUI::Element::Reconcile(VirtualNode* vnode, bool parentPatched)
 {
-    if (this->children.size() != vnode->children.size())
+    if (HasKeyedChildren(vnode))
+        return ReconcileKeyed(vnode, parentPatched);
+
+    PropChange result = PropChange::None;
+
+    // unkeyed children match by position, extra old children are freed and
+    // missing ones built on the end
+    while (this->children.size() > vnode->children.size())
+    {
+        SB_delete(this->children.back());
+        this->children.pop_back();
+        s_reconcileStats.removed++;
+        result = PropChange::Structural;
+    }
+
+    size_t reusable = this->children.size();
+
+    for (size_t i = 0; i < reusable; i++)
     {
-        for (Child* child : this->children)
-            SB_delete(child);
-        this->children.clear();
+        VirtualNode* childVn = vnode->children[i];
+        Element* childEl = (Element*)*this->children[i];
+        PropChange change = CanReuse(this->children[i], childVn)
+            ? PatchChild(childEl, childVn, parentPatched) : PropChange::Structural;
 
-        SetElementBuilderContext(this->renderer, this, false);
-        BuildRealSubtreeFromVirtual(vnode);
+        if (change == PropChange::Structural)
+        {
+            // the old child goes first so its ids are free for the replacement
+            SB_delete(this->children[i]);
+            s_reconcileStats.removed++;
+            // a child that builds nothing is dropped below, keeping the
+            // rest lined up with their virtual nodes
+            this->children[i] = BuildChild(childVn);
+            result = PropChange::Structural;
+            continue;
+        }
 
-        return true;
+        CountChange(change);
+        result = std::max(result, change);
+        if (!childVn->memoised)
+            result = std::max(result, childEl->Reconcile(childVn, change != PropChange::None));
     }
 
-    for (size_t i = 0; i < this->children.size(); i++)
+    // built after every replaced child is freed, an id moving here is not still taken
+    for (size_t i = reusable; i < vnode->children.size(); i++)
     {
-        Child* childWrapper = this->children[i];
+        if (Child* child = BuildChild(vnode->children[i]))
+            this->children.push_back(child);
+        result = PropChange::Structural;
+    }
 
-        Element* childEl = (Element*)*childWrapper;
-        VirtualNode* childVn = vnode->children[i];
+    this->children.erase(std::remove(this->children.begin(), this->children.end(), nullptr),
+        this->children.end());
+
+    return result;
+}
+
+SableUI::PropChange SableUI::Element::ReconcileKeyed(VirtualNode* vnode, bool parentPatched)
+{
+    std::vector<Child*> oldChildren;
+    oldChildren.swap(this->children);
+
+    std::unordered_map<uint64_t, size_t> keyed;
+    std::vector<size_t> unkeyed;
+    for (size_t i = 0; i < oldChildren.size(); i++)
+    {
+        uint64_t key = ((Element*)*oldChildren[i])->info.key;
+        if (key != 0) keyed.emplace(key, i);
+        else unkeyed.push_back(i);
+    }
 
-        std::size_t childElHash = ComputeHash(childEl->info);
-        std::size_t childVnHash = ComputeHash(childVn->info);
+    constexpr size_t NONE = static_cast<size_t>(-1);
+    std::vector<size_t> sources(vnode->children.size(), NONE);
+    std::vector<bool> used(oldChildren.size(), false);
+    size_t nextUnkeyed = 0;
 
-        bool componentMismatch = false;
-        bool isComponent = (childWrapper->type == ChildType::COMPONENT);
-        bool wantsComponent = (childVn->childComp != nullptr);
+    // keyed children match by key, unkeyed ones by their order among unkeyed siblings
+    for (size_t j = 0; j < vnode->children.size(); j++)
+    {
+        VirtualNode* childVn = vnode->children[j];
+        size_t i = NONE;
 
-        if (isComponent != wantsComponent)
+        if (childVn->info.key != 0)
         {
-            componentMismatch = true;
+            auto it = keyed.find(childVn->info.key);
+            if (it != keyed.end()) i = it->second;
         }
-        else if (isComponent)
+        else if (nextUnkeyed < unkeyed.size())
         {
-            if (childWrapper->component != childVn->childComp)
-            {
-                componentMismatch = true;
-            }
+            i = unkeyed[nextUnkeyed++];
         }
 
-        if (childElHash != childVnHash || componentMismatch)
+        if (i == NONE || used[i] || !CanReuse(oldChildren[i], childVn))
+            continue;
+
+        sources[j] = i;
+        used[i] = true;
+    }
+
+    PropChange result = PropChange::None;
+    std::vector<Child*> next(vnode->children.size(), nullptr);
+    std::vector<PropChange> changes(vnode->children.size(), PropChange::Structural);
+
+    for (size_t j = 0; j < vnode->children.size(); j++)
+    {
+        if (sources[j] == NONE) continue;
+
+        Child* childWrapper = oldChildren[sources[j]];
+        changes[j] = PatchChild((Element*)*childWrapper, vnode->children[j], parentPatched);
+
+        // structural changes are rebuilt below, the old child is freed with the rest
+        if (changes[j] == PropChange::Structural)
         {
-            for (Child* child : this->children)
-                SB_delete(child);
-            this->children.clear();
+            used[sources[j]] = false;
+            sources[j] = NONE;
+            continue;
+        }
 
-            SetElementBuilderContext(this->renderer, this, false);
-            BuildRealSubtreeFromVirtual(vnode);
+        next[j] = childWrapper;
+        CountChange(changes[j]);
+    }
 
-            return true;
+    for (size_t i = 0; i < oldChildren.size(); i++)
+    {
+        if (used[i]) continue;
+
+        SB_delete(oldChildren[i]);
+        s_reconcileStats.removed++;
+        result = PropChange::Structural;
+    }
+
+    std::vector<size_t> kept;
+    kept.reserve(vnode->children.size());
+
+    for (size_t j = 0; j < vnode->children.size(); j++)
+    {
+        if (sources[j] != NONE)
+        {
+            kept.push_back(sources[j]);
+            continue;
         }
+
+        next[j] = BuildChild(vnode->children[j]);
+        result = PropChange::Structural;
     }
 
-    bool anyChildChanged = false;
-    for (size_t i = 0; i < this->children.size(); i++)
+    // the child list is a vector of pointers so the new order is applied in
+    // one pass, the LIS gives the minimal number of moves for the stats
+    size_t moved = kept.size() - LongestIncreasingSubsequence(kept);
+    s_reconcileStats.moved += moved;
+    if (moved > 0)
+        result = std::max(result, PropChange::Layout);
+
+    this->children.clear();
+    for (Child* child : next)
+        if (child) this->children.push_back(child);
+
+    for (size_t j = 0; j < vnode->children.size(); j++)
     {
-        Element* childEl = (Element*)*this->children[i];
-        VirtualNode* childVn = vnode->children[i];
+        if (sources[j] == NONE) continue;
+
+        result = std::max(result, changes[j]);
+        if (vnode->children[j]->memoised) continue;
 
-        bool childChanged = childEl->Reconcile(childVn);
-        if (childChanged)
-            anyChildChanged = true;
+        Element* childEl = (Element*)*next[j];
+        result = std::max(result, childEl->Reconcile(vnode->children[j], changes[j] != PropChange::None));
     }
 
-    return anyChildChanged;
+    return result;
 }
 
 void SableUI::Element::BuildRealSubtreeFromVirtual(VirtualNode* vnode)
@@ -972,6 +1390,12 @@ void SableUI::Element::BuildSingleElementFromVirtual(VirtualNode* vnode)
 {
     if (!vnode) return;
 
+    if (vnode->memoised)
+    {
+        AddMemoisedComponent(vnode->info, vnode->childComp);
+        return;
+    }
+
     switch (vnode->info.type)
     {
     case ElementType::Div:
@@ -1011,16 +1435,7 @@ void SableUI::Element::BuildSingleElementFromVirtual(VirtualNode* vnode)
 void SableUI::Element::DistributeInputToElements(const UIEventContext& ctx)
 {
     if (RectBoundingBox(rect, ctx.mousePos))
-    {
-        if (ctx.mouseReleased[SABLE_MOUSE_BUTTON_LEFT] && info.onClickFunc)
-            info.onClickFunc();
-
-        if (ctx.mouseReleased[SABLE_MOUSE_BUTTON_RIGHT] && info.onSecondaryClickFunc)
-            info.onSecondaryClickFunc();
-
-        if (ctx.mouseDoubleClicked[SABLE_MOUSE_BUTTON_LEFT] && info.onDoubleClickFunc)
-            info.onDoubleClickFunc();
-    }
+        DispatchPointerEvents(ctx);
 
     for (Child* child : children)
     {
@@ -1031,6 +1446,28 @@ void SableUI::Element::DistributeInputToElements(const UIEventContext& ctx)
     }
 }
 
+void SableUI::Element::DispatchPointerEvents(const UIEventContext& ctx)
+{
+    if (ctx.mouseReleased[SABLE_MOUSE_BUTTON_LEFT] && info.onClickFunc)
+        info.onClickFunc();
+
+    if (ctx.mouseReleased[SABLE_MOUSE_BUTTON_RIGHT] && info.onSecondaryClickFunc)
+        info.onSecondaryClickFunc();
+
+    if (ctx.mouseDoubleClicked[SABLE_MOUSE_BUTTON_LEFT] && info.onDoubleClickFunc)
+        info.onDoubleClickFunc();
+}
+
+bool SableUI::Element::HasPointerHandlers() const
+{
+    return info.onClickFunc || info.onSecondaryClickFunc || info.onDoubleClickFunc;
+}
+
+SableUI::Rect SableUI::Element::GetHitRect() const
+{
+    return clipEnabled ? rect.getIntersection(clipRect) : rect;
+}
+
 bool SableUI::Element::CheckElementTreeForChanges(CommandBuffer& cmd, const GpuFramebuffer* fbo, ContextResources& ctx)
 {
     bool anyChanged = false;
@@ -1048,9 +1485,22 @@ bool SableUI::Element::CheckElementTreeForChanges(CommandBuffer& cmd, const GpuF
 
 SableUI::Element* SableUI::Element::GetElementById(const SableString& id)
 {
-    if (this->info.id == id)
+    // looking up never interns, an id no element was given has no atom
+    ElementId atom = FindElementId(id);
+    if (!atom) return nullptr;
+
+    return GetElementById(atom);
+}
+
+SableUI::Element* SableUI::Element::GetElementById(ElementId id)
+{
+    if (info.internedId == id)
         return this;
 
+    // the owner indexes every id under its root, only a subtree below it is walked
+    if (m_owner && m_owner->IsRootElement(this))
+        return m_owner->GetElementById(id);
+
     for (Child* child : children)
     {
         Element* childElement = (Element*)*child;
@@ -1067,12 +1517,17 @@ SableUI::Element* SableUI::Element::GetElementById(const SableString& id)
 SableUI::Element::~Element()
 {
     n_elements--;
+    s_layoutEpoch++;
+
+    if (m_owner)
+        m_owner->InvalidateSpatialIndex();
+
+    if (info.internedId && m_owner)
+        m_owner->UnregisterElementId(this);
 
     if (info.type == ElementType::Image && m_owner)
-        if (DrawableImage* drImage = dynamic_cast<DrawableImage*>(drawable))
+        if (DrawableImage* drImage = std::get_if<DrawableImage>(&drawable))
             drImage->DeregisterTextureDependancy(m_owner);
-    
-    SB_delete(drawable);
 
     for (Child* child : children) SB_delete(child);
     children.clear();
@@ -1095,6 +1550,21 @@ int SableUI::Element::GetNumInstances()
     return n_elements;
 }
 
+uint64_t SableUI::Element::GetLayoutEpoch()
+{
+    return s_layoutEpoch;
+}
+
+const SableUI::ReconcileStats& SableUI::Element::GetReconcileStats()
+{
+    return s_reconcileStats;
+}
+
+void SableUI::Element::ResetReconcileStats()
+{
+    s_reconcileStats = ReconcileStats{};
+}
+
 int SableUI::VirtualNode::GetNumInstances()
 {
 	return n_vElements;
@@ -110,30 +110,36 @@ void SableUI::EventScheduler::ThreadMain()
 			continue;
 		}
 
-		TimerHandle handle = nextIt->first;
-		auto& timer = nextIt->second;
-		bool shouldRemove = !timer.repeating;
+		// every timer that is due fires in this pass and wakes the ui thread once
+		UpdateBatch batch;
+		std::lock_guard firedLock(m_firedMutex);
 
+		for (auto it = m_timers.begin(); it != m_timers.end();)
 		{
-			std::lock_guard firedLock(m_firedMutex);
-			m_firedTimers.push_back(handle);
-		}
+			auto& timer = it->second;
+			if (timer.nextFire > now)
+			{
+				it++;
+				continue;
+			}
 
-		PostEmptyEvent();
+			m_firedTimers.push_back(it->first);
+			PostEmptyEvent();
+
+			if (!timer.repeating)
+			{
+				it = m_timers.erase(it);
+				continue;
+			}
 
-		if (timer.repeating)
-		{
 			timer.nextFire += timer.period;
 
 			if (timer.nextFire < now - timer.period)
 			{
 				timer.nextFire = now + timer.period;
 			}
-		}
 
-		if (shouldRemove)
-		{
-			m_timers.erase(nextIt);
+			it++;
 		}
 	}
 }
\ No newline at end of file
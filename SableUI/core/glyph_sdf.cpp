@@ -0,0 +1,41 @@
+#include <SableUI/core/glyph_sdf.h>
+#include <algorithm>
+#include <cmath>
+
+float SableUI::GetSdfPixelRange(int fontSize)
+{
+	// a full field unit spans 255 / 128 spreads, scaled down to the drawn size
+	float scale = static_cast<float>(fontSize) / static_cast<float>(SDF_REFERENCE_SIZE);
+	return (255.0f / 128.0f) * static_cast<float>(SDF_SPREAD) * scale;
+}
+
+float SableUI::SdfToCoverage(float fieldValue, float pixelRange)
+{
+	return std::clamp((fieldValue - SDF_EDGE_VALUE) * pixelRange + 0.5f, 0.0f, 1.0f);
+}
+
+float SableUI::SampleSdfCoverage(const uint8_t* field, int width, int height,
+	float x, float y, float pixelRange)
+{
+	if (field == nullptr || width <= 0 || height <= 0)
+		return 0.0f;
+
+	float fx = x - 0.5f;
+	float fy = y - 0.5f;
+	int x0 = static_cast<int>(std::floor(fx));
+	int y0 = static_cast<int>(std::floor(fy));
+	float tx = fx - static_cast<float>(x0);
+	float ty = fy - static_cast<float>(y0);
+
+	auto texel = [&](int px, int py) {
+		px = std::clamp(px, 0, width - 1);
+		py = std::clamp(py, 0, height - 1);
+		return static_cast<float>(field[py * width + px]) / 255.0f;
+	};
+
+	float top = texel(x0, y0) * (1.0f - tx) + texel(x0 + 1, y0) * tx;
+	float bottom = texel(x0, y0 + 1) * (1.0f - tx) + texel(x0 + 1, y0 + 1) * tx;
+	float value = top * (1.0f - ty) + bottom * ty;
+
+	return SdfToCoverage(value, pixelRange);
+}
@@ -589,7 +589,9 @@ bool SableUI::ContentPanel::UpdateComponents(CommandBuffer& cmd, const GpuFrameb
 	if (!m_component)
 		return false;
 
-	bool changed = m_component->CheckAndUpdate(cmd, framebuffer, contextResources);
+	// dirty components were already rerendered by the window's dirty queue
+	bool changed = m_component->TakeSubtreeUpdated();
+	bool repainted = m_component->TakeSubtreeRepainted();
 
 	if (changed)
 	{
@@ -597,7 +599,8 @@ bool SableUI::ContentPanel::UpdateComponents(CommandBuffer& cmd, const GpuFrameb
 		Update(cmd, framebuffer, contextResources);
 	}
 
-	return changed;
+	// paint-only changes are re-recorded by the window with everything else
+	return changed || repainted;
 }
 
 void SableUI::ContentPanel::PostLayoutUpdate(const UIEventContext& ctx)
@@ -19,7 +19,7 @@ bool SableUI::ScrollData::operator!=(const ScrollData& other) const
 
 void SableUI::ScrollUpdateHandler_Phase1(BaseComponent* comp, ScrollContext& ctx, const UIEventContext& eventCtx)
 {
-    Element* viewportEl = comp->GetElementById(ctx.GetViewportID());
+    Element* viewportEl = comp->GetElementById(ctx.viewportID);
     if (!viewportEl) return;
 
     if (RectBoundingBox(viewportEl->rect, eventCtx.mousePos))
@@ -47,7 +47,7 @@ void SableUI::ScrollUpdateHandler_Phase1(BaseComponent* comp, ScrollContext& ctx
         }
     }
 
-    Element* barEl = comp->GetElementById(ctx.GetBarID());
+    Element* barEl = comp->GetElementById(ctx.barID);
     if (barEl)
     {
         bool hover = RectBoundingBox(barEl->rect, eventCtx.mousePos);
@@ -107,8 +107,8 @@ void SableUI::ScrollUpdateHandler_Phase1(BaseComponent* comp, ScrollContext& ctx
 
 void SableUI::ScrollUpdateHandler_Phase2(BaseComponent* comp, ScrollContext& ctx)
 {
-    Element* viewportEl = comp->GetElementById(ctx.GetViewportID());
-    Element* contentEl = comp->GetElementById(ctx.GetContentID());
+    Element* viewportEl = comp->GetElementById(ctx.viewportID);
+    Element* contentEl = comp->GetElementById(ctx.contentID);
 
     if (!viewportEl || !contentEl) return;
 
@@ -149,14 +149,14 @@ SableUI::ScrollViewScope::ScrollViewScope(ScrollContext& context, const ElementI
     : ctx(context)
 {
     const Theme& t = GetTheme();
-    bgColour = info.appearance.bg.value_or(t.crust);
+    bgColour = info.appearance->bg.value_or(t.crust);
 
     // viewport
-    SableUI::StartDiv(PackStyles(id(ctx.GetViewportID()), w_fill, h_fill, left_right, overflow_hidden));
+    SableUI::StartDiv(PackStyles(id(ctx.viewportID), w_fill, h_fill, left_right, overflow_hidden));
 
     // content
     ElementInfo contentInfo = info;
-    PackStylesToInfo(contentInfo, id(ctx.GetContentID()), w_fill, h_fit, mt(-static_cast<int>(ctx.scrollPos.y)));
+    PackStylesToInfo(contentInfo, id(ctx.contentID), w_fill, h_fit, mt(-static_cast<int>(ctx.scrollPos.y)));
     SableUI::StartDiv(contentInfo);
 }
 
@@ -179,14 +179,14 @@ SableUI::ScrollViewScope::~ScrollViewScope()
 
             if (ctx.barHovered)
             {
-                Div(id(ctx.GetBarID()), w_fit, p(padding), h_fill, bg(bgColour))
+                Div(id(ctx.barID), w_fit, p(padding), h_fill, bg(bgColour))
                 {
                     RectElement(w(6), h(static_cast<int>(thumbHeight)), mt(static_cast<int>(topMargin)), rounded(3), bg(149, 149, 149));
                 }
             }
             else
             {
-                Div(id(ctx.GetBarID()), w_fit, p(padding), h_fill, bg(bgColour))
+                Div(id(ctx.barID), w_fit, p(padding), h_fill, bg(bgColour))
                 {
                     RectElement(w(2), m(2), h(static_cast<int>(thumbHeight)), mt(static_cast<int>(topMargin)), rounded(1), bg(128, 128, 128));
                 }
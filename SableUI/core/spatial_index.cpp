@@ -0,0 +1,137 @@
+#include <SableUI/core/spatial_index.h>
+#include <SableUI/utils/utils.h>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+constexpr int MIN_CELL_SIZE = 64;
+constexpr int MAX_GRID_CELLS = 4096;
+
+void SableUI::SpatialIndex::Clear()
+{
+	m_entries.clear();
+	m_cellStart.clear();
+	m_cellItems.clear();
+	m_bounds = { 0, 0, 0, 0 };
+	m_cols = 0;
+	m_rows = 0;
+	valid = false;
+}
+
+void SableUI::SpatialIndex::Insert(Element* element, const Rect& rect)
+{
+	if (rect.w <= 0 || rect.h <= 0) return;
+
+	m_entries.push_back({ element, rect });
+}
+
+void SableUI::SpatialIndex::Build()
+{
+	m_cellStart.clear();
+	m_cellItems.clear();
+	valid = true;
+
+	if (m_entries.empty())
+	{
+		m_bounds = { 0, 0, 0, 0 };
+		m_cols = m_rows = 0;
+		return;
+	}
+
+	int minX = m_entries[0].rect.x, minY = m_entries[0].rect.y;
+	int maxX = minX + m_entries[0].rect.w, maxY = minY + m_entries[0].rect.h;
+
+	for (const Entry& e : m_entries)
+	{
+		minX = std::min(minX, e.rect.x);
+		minY = std::min(minY, e.rect.y);
+		maxX = std::max(maxX, e.rect.x + e.rect.w);
+		maxY = std::max(maxY, e.rect.y + e.rect.h);
+	}
+
+	m_bounds = { minX, minY, maxX - minX, maxY - minY };
+
+	// grow cells until the grid fits the budget
+	m_cellSize = MIN_CELL_SIZE;
+	while (true)
+	{
+		m_cols = (m_bounds.w + m_cellSize - 1) / m_cellSize;
+		m_rows = (m_bounds.h + m_cellSize - 1) / m_cellSize;
+		if (m_cols * m_rows <= MAX_GRID_CELLS) break;
+		m_cellSize *= 2;
+	}
+
+	m_cols = std::max(m_cols, 1);
+	m_rows = std::max(m_rows, 1);
+
+	// counting sort entries into cells, keeps insertion order within a cell
+	m_cellStart.assign(static_cast<size_t>(m_cols) * m_rows + 1, 0);
+
+	auto forEachCell = [&](const Rect& r, auto&& fn) {
+		int x0 = (r.x - m_bounds.x) / m_cellSize;
+		int y0 = (r.y - m_bounds.y) / m_cellSize;
+		int x1 = (r.x + r.w - 1 - m_bounds.x) / m_cellSize;
+		int y1 = (r.y + r.h - 1 - m_bounds.y) / m_cellSize;
+
+		for (int cy = y0; cy <= y1; cy++)
+			for (int cx = x0; cx <= x1; cx++)
+				fn(static_cast<size_t>(cy) * m_cols + cx);
+	};
+
+	for (const Entry& e : m_entries)
+		forEachCell(e.rect, [&](size_t cell) { m_cellStart[cell + 1]++; });
+
+	for (size_t i = 1; i < m_cellStart.size(); i++)
+		m_cellStart[i] += m_cellStart[i - 1];
+
+	m_cellItems.resize(m_cellStart.back());
+	std::vector<uint32_t> cursor(m_cellStart.begin(), m_cellStart.end() - 1);
+
+	for (uint32_t i = 0; i < static_cast<uint32_t>(m_entries.size()); i++)
+		forEachCell(m_entries[i].rect, [&](size_t cell) { m_cellItems[cursor[cell]++] = i; });
+}
+
+bool SableUI::SpatialIndex::CellOf(ivec2 point, int& cx, int& cy) const
+{
+	if (!valid || m_cols == 0 || !RectBoundingBox(m_bounds, point))
+		return false;
+
+	cx = (point.x - m_bounds.x) / m_cellSize;
+	cy = (point.y - m_bounds.y) / m_cellSize;
+	return true;
+}
+
+void SableUI::SpatialIndex::Query(ivec2 point, std::vector<Element*>& out) const
+{
+	out.clear();
+	m_lastQueryTests = 0;
+
+	int cx, cy;
+	if (!CellOf(point, cx, cy)) return;
+
+	size_t cell = static_cast<size_t>(cy) * m_cols + cx;
+	for (uint32_t i = m_cellStart[cell]; i < m_cellStart[cell + 1]; i++)
+	{
+		const Entry& e = m_entries[m_cellItems[i]];
+		m_lastQueryTests++;
+
+		if (RectBoundingBox(e.rect, point))
+			out.push_back(e.element);
+	}
+}
+
+bool SableUI::SpatialIndex::Contains(ivec2 point, const Element* element) const
+{
+	int cx, cy;
+	if (!CellOf(point, cx, cy)) return false;
+
+	size_t cell = static_cast<size_t>(cy) * m_cols + cx;
+	for (uint32_t i = m_cellStart[cell]; i < m_cellStart[cell + 1]; i++)
+	{
+		const Entry& e = m_entries[m_cellItems[i]];
+		if (e.element == element && RectBoundingBox(e.rect, point))
+			return true;
+	}
+
+	return false;
+}
@@ -21,6 +21,12 @@
 #include <cstdint>
 #include <exception>
 #include <mutex>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <unordered_map>
+#include <list>
+#include <string_view>
 
 #include <freetype/config/ftheader.h>
 #include <freetype/fttypes.h>
@@ -31,6 +37,8 @@
 #include <SableUI/utils/utils.h>
 #include <SableUI/utils/console.h>
 #include <SableUI/core/text_cache.h>
+#include <SableUI/core/atlas_packer.h>
+#include <SableUI/core/glyph_sdf.h>
 #undef SABLEUI_SUBSYSTEM
 #define SABLEUI_SUBSYSTEM "Font Manager"
 
@@ -40,11 +48,22 @@ constexpr int ATLAS_PADDING = 2;
 constexpr int MIN_ATLAS_DEPTH = 1;
 constexpr int MAX_ATLAS_GAP = 0;
 constexpr const char* FONT_CACHE_PREFIX = "f-";
-constexpr uint32_t ATLAS_CACHE_FILE_VERSION = 2;
+constexpr int DEFAULT_ATLAS_LAYER_BUDGET = 16;
+constexpr uint32_t ATLAS_CACHE_FILE_VERSION = 4;
 constexpr const char* FONT_PACK_CACHE_PREFIX = "fp-";
 constexpr uint32_t FONT_PACK_CACHE_FILE_VERSION = 1;
 constexpr char32_t MAX_CONTIGUOUS_CHARS = 128;
 constexpr int FONT_PACK_DECAY = 10;
+constexpr size_t MAX_RASTER_WORKERS = 4;
+constexpr int SDF_GLYPH_KEY_SIZE = 0; // font size of the table entries holding sdf glyphs
+constexpr size_t SHAPED_LINE_BUDGET = 8 * 1024 * 1024; // bytes of shaped lines kept once no text holds them
+
+// FT_RENDER_MODE_SDF arrived in FreeType 2.11
+#if FREETYPE_MAJOR > 2 || (FREETYPE_MAJOR == 2 && FREETYPE_MINOR >= 11)
+#define SABLEUI_FT_HAS_SDF 1
+#else
+#define SABLEUI_FT_HAS_SDF 0
+#endif
 
 static SableUI::vec2 s_dpi = { 96.0f, 96.0f };
 void SableUI::SetFontDPI(const vec2& dpi)
@@ -58,6 +77,12 @@ struct TextVertex {
 	SableUI::Colour colour;
 };
 
+// layers past 63 share the top bit, touching it touches all of them
+static inline uint64_t AtlasLayerBit(uint16_t layer)
+{
+	return 1ull << std::min<uint16_t>(layer, 63);
+}
+
 static inline bool IsNonPrintableChar(char32_t c)
 {
 	if (c == U'\n') return false;
@@ -185,6 +210,10 @@ struct Character {
 	SableUI::vec2 bearing = SableUI::vec2(0);
 	float advance = 0;
 	uint16_t layer = 0;
+
+	// advance is known once the range is measured, the rest once rasterised
+	uint16_t font = 0; // index into FontManager::fontPaths
+	bool rasterised = false;
 };
 
 struct Atlas {
@@ -203,6 +232,75 @@ enum class FontType : uint8_t {
 	LightItalic
 };
 
+// style a style tag switches to, false for any other char
+static bool GetStyleTagType(char32_t c, FontType& outType)
+{
+	switch (static_cast<SableUI::StyleTag>(c))
+	{
+	case SableUI::StyleTag::BoldStart:        outType = FontType::Bold;         return true;
+	case SableUI::StyleTag::BoldEnd:          outType = FontType::Regular;      return true;
+	case SableUI::StyleTag::ItalicStart:      outType = FontType::Italic;       return true;
+	case SableUI::StyleTag::ItalicEnd:        outType = FontType::Regular;      return true;
+	case SableUI::StyleTag::BoldItalicStart:  outType = FontType::BoldItalic;   return true;
+	case SableUI::StyleTag::BoldItalicEnd:    outType = FontType::Regular;      return true;
+	case SableUI::StyleTag::LightStart:       outType = FontType::Light;        return true;
+	case SableUI::StyleTag::LightEnd:         outType = FontType::Regular;      return true;
+	case SableUI::StyleTag::LightItalicStart: outType = FontType::LightItalic;  return true;
+	case SableUI::StyleTag::LightItalicEnd:   outType = FontType::Regular;      return true;
+	default: return false;
+	}
+}
+
+/* a token is a span [begin, end) of a source string, a word, a run of
+ * spaces or a newline. style tags inside a word keep it whole, fontType is
+ * the style at begin and the tags are applied wherever the span is walked.
+ * non printable chars inside a span are skipped the same way */
+struct TextToken {
+	uint32_t begin = 0;
+	uint32_t end = 0;
+	float width = 0.0f;
+	bool isSpace = false;
+	bool isNewline = false;
+	FontType fontType = FontType::Regular;
+};
+
+/* one hard line, up to and including its newline, tokenised once at one
+ * font size from the style it starts in. positions are relative to the line */
+struct ShapedLine {
+	std::u32string text;
+	int fontSize = 0;
+	FontType startStyle = FontType::Regular;
+	FontType endStyle = FontType::Regular;
+	std::vector<TextToken> runs;
+	std::vector<float> advances;	// per char, 0 for newlines, style tags and non printables
+	float widestWord = 0.0f;
+	float width = 0.0f;				// up to the newline
+	size_t hash = 0;
+	size_t bytes = 0;
+
+	bool EndsParagraph() const { return !text.empty() && text.back() == U'\n'; }
+};
+
+/* a text as its shaped lines, wrapping it at any width is a pass over their
+ * runs. lines only break before a word or after a newline */
+struct SableUI::ShapedParagraph {
+	// a line's measurements are copied in so the whole paragraph's are a pass over this
+	struct Line {
+		uint32_t begin = 0;
+		uint32_t end = 0;
+		float widestWord = 0.0f;
+		float width = 0.0f;
+		std::shared_ptr<const ShapedLine> shaped;
+	};
+
+	SableString text;				// shares the content's buffer, compared against on the next edit
+	int fontSize = 0;
+	std::vector<Line> lines;
+	float widestWord = 0.0f;		// narrowest width the text wraps to without overflowing
+	float widestLine = 0.0f;		// widest line between hard breaks
+	int hardLines = 1;
+};
+
 struct char_t {
 	char32_t c = 0;
 	int fontSize = 0;
@@ -215,6 +313,114 @@ struct char_t {
 	}
 };
 
+struct DrawnLine;
+
+/* Glyph metrics keyed by (codepoint, size, style). Open addressing with
+ * linear probing over a power of two table, a lookup is one multiply and
+ * usually a single probe, with no allocation or string work per glyph */
+class GlyphTable {
+public:
+	const Character* Find(const char_t& key) const
+	{
+		return const_cast<GlyphTable*>(this)->Find(PackKey(key));
+	}
+
+	Character* Find(uint64_t packed)
+	{
+		if (m_slots.empty()) return nullptr;
+
+		size_t mask = m_slots.size() - 1;
+
+		for (size_t i = HashKey(packed) & mask;; i = (i + 1) & mask)
+		{
+			Slot& slot = m_slots[i];
+			if (slot.key == packed) return &slot.value;
+			if (slot.key == 0) return nullptr;
+		}
+	}
+
+	Character& operator[](const char_t& key)
+	{
+		// keep the load factor at or under 1/2
+		if ((m_count + 1) * 2 > m_slots.size())
+			Rehash(m_slots.empty() ? 1024 : m_slots.size() * 2);
+
+		uint64_t packed = PackKey(key);
+		size_t mask = m_slots.size() - 1;
+
+		for (size_t i = HashKey(packed) & mask;; i = (i + 1) & mask)
+		{
+			Slot& slot = m_slots[i];
+			if (slot.key == packed) return slot.value;
+
+			if (slot.key == 0)
+			{
+				slot.key = packed;
+				slot.value = Character{};
+				m_count++;
+				return slot.value;
+			}
+		}
+	}
+
+	template <typename F>
+	void ForEach(F&& fn)
+	{
+		for (Slot& slot : m_slots)
+			if (slot.key != 0) fn(slot.value);
+	}
+
+	void Clear()
+	{
+		m_slots.clear();
+		m_count = 0;
+	}
+
+	size_t Size() const { return m_count; }
+
+	static uint64_t PackKey(const char_t& key)
+	{
+		return (1ull << 63)
+			| (static_cast<uint64_t>(key.fontType) << 53)
+			| (static_cast<uint64_t>(static_cast<uint32_t>(key.fontSize) & 0xFFFFFFu) << 29)
+			| static_cast<uint64_t>(key.c & 0x1FFFFFu);
+	}
+
+private:
+	struct Slot {
+		uint64_t key = 0; // 0 is empty, packed keys always set the top bit
+		Character value;
+	};
+
+	static size_t HashKey(uint64_t packed)
+	{
+		packed ^= packed >> 29;
+		packed *= 0x9e3779b97f4a7c15ull;
+		return static_cast<size_t>(packed ^ (packed >> 32));
+	}
+
+	void Rehash(size_t capacity)
+	{
+		std::vector<Slot> old = std::move(m_slots);
+		m_slots.assign(capacity, Slot{});
+
+		size_t mask = capacity - 1;
+		for (const Slot& slot : old)
+		{
+			if (slot.key == 0) continue;
+
+			size_t i = HashKey(slot.key) & mask;
+			while (m_slots[i].key != 0)
+				i = (i + 1) & mask;
+
+			m_slots[i] = slot;
+		}
+	}
+
+	std::vector<Slot> m_slots;
+	size_t m_count = 0;
+};
+
 // ============================================================================
 // Data
 // ============================================================================
@@ -342,6 +548,224 @@ static const std::vector<FontPackHint> FONT_PACK_HINTS_LIGHT_ITALIC = {
 	{"NotoSans-LightItalic.ttf", 0x1E00, 0x1EFF, 1},
 };
 
+// ============================================================================
+// Glyph rasterisation
+// ============================================================================
+enum class GlyphLoad : uint8_t {
+	Metrics,	// advance only
+	Bitmap,		// hinted coverage
+	SDF			// unhinted distance field
+};
+
+struct RasterisedGlyph {
+	bool valid = false;
+	SableUI::u16vec2 size = SableUI::u16vec2(0);
+	SableUI::vec2 bearing = SableUI::vec2(0);
+	long advance = 0; // 26.6 fixed point
+	std::vector<uint8_t> bitmap; // size.x * size.y, rows tightly packed
+};
+
+/* Loads a list of codepoints across worker threads, the calling thread
+ * takes part too. Every thread has its own FT_Face per font file, faces are
+ * only created and destroyed under the library mutex as FreeType requires.
+ * Results land at a fixed index per codepoint so packing afterwards sees the
+ * same input whichever thread rendered a glyph. */
+class GlyphRasterPool {
+public:
+	void Start(FT_Library library, std::mutex* libraryMutex);
+	void Stop();
+
+	// out[i] holds the glyph for codepoints[i], invalid if the font lacks it
+	void Rasterise(const std::string& fontPath, int fontSize,
+		const std::vector<char32_t>& codepoints, GlyphLoad load, std::vector<RasterisedGlyph>& out);
+
+private:
+	void WorkerMain(size_t slot);
+	void RunJob(size_t slot);
+	FT_Face GetFace(size_t slot, const std::string& fontPath);
+
+	FT_Library m_library = nullptr;
+	std::mutex* m_libraryMutex = nullptr;
+
+	std::vector<std::thread> m_workers;
+	// slot 0 is the calling thread, slot n is worker n - 1
+	std::vector<std::unordered_map<std::string, FT_Face>> m_faces;
+
+	std::mutex m_mutex;
+	std::condition_variable m_wakeCV;
+	std::condition_variable m_doneCV;
+	uint64_t m_generation = 0;
+	size_t m_busy = 0;
+	bool m_stopping = false;
+
+	const std::string* m_jobPath = nullptr;
+	int m_jobFontSize = 0;
+	const char32_t* m_jobCodepoints = nullptr;
+	size_t m_jobCount = 0;
+	GlyphLoad m_jobLoad = GlyphLoad::Metrics;
+	std::vector<RasterisedGlyph>* m_jobOut = nullptr;
+	std::atomic<size_t> m_jobNext{ 0 };
+};
+
+void GlyphRasterPool::Start(FT_Library library, std::mutex* libraryMutex)
+{
+	m_library = library;
+	m_libraryMutex = libraryMutex;
+	m_stopping = false;
+
+	unsigned int hw = std::thread::hardware_concurrency();
+	size_t workerCount = std::min<size_t>(MAX_RASTER_WORKERS, hw > 1 ? hw - 1 : 0);
+
+	m_faces.resize(workerCount + 1);
+	for (size_t i = 0; i < workerCount; i++)
+		m_workers.emplace_back(&GlyphRasterPool::WorkerMain, this, i + 1);
+
+	SableUI_Log("Glyph rasterisation using %zu worker thread(s)", workerCount);
+}
+
+void GlyphRasterPool::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopping = true;
+	}
+	m_wakeCV.notify_all();
+
+	for (std::thread& worker : m_workers)
+		worker.join();
+
+	m_workers.clear();
+
+	std::lock_guard<std::mutex> lock(*m_libraryMutex);
+	for (auto& faces : m_faces)
+		for (auto& [path, face] : faces)
+			FT_Done_Face(face);
+
+	m_faces.clear();
+}
+
+void GlyphRasterPool::Rasterise(const std::string& fontPath, int fontSize,
+	const std::vector<char32_t>& codepoints, GlyphLoad load, std::vector<RasterisedGlyph>& out)
+{
+	out.clear();
+	if (codepoints.empty()) return;
+
+	out.resize(codepoints.size());
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_jobPath = &fontPath;
+		m_jobFontSize = fontSize;
+		m_jobCodepoints = codepoints.data();
+		m_jobCount = out.size();
+		m_jobLoad = load;
+		m_jobOut = &out;
+		m_jobNext = 0;
+		m_busy = m_workers.size();
+		m_generation++;
+	}
+	m_wakeCV.notify_all();
+
+	RunJob(0);
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_doneCV.wait(lock, [this]() { return m_busy == 0; });
+	m_jobOut = nullptr;
+	m_jobCodepoints = nullptr;
+}
+
+void GlyphRasterPool::WorkerMain(size_t slot)
+{
+	uint64_t seenGeneration = 0;
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wakeCV.wait(lock, [&]() { return m_stopping || m_generation != seenGeneration; });
+
+			if (m_stopping) return;
+			seenGeneration = m_generation;
+		}
+
+		RunJob(slot);
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_busy--;
+		}
+		m_doneCV.notify_one();
+	}
+}
+
+void GlyphRasterPool::RunJob(size_t slot)
+{
+	FT_Face face = GetFace(slot, *m_jobPath);
+	if (!face) return;
+
+	FT_Set_Pixel_Sizes(face, 0, m_jobFontSize);
+
+	// hinting decides the advance, rendering does not change it. fields are
+	// scaled to every size, snapping them to the reference grid only distorts
+	FT_Int32 loadFlags = FT_LOAD_TARGET_LIGHT | FT_LOAD_FORCE_AUTOHINT;
+	if (m_jobLoad == GlyphLoad::Bitmap) loadFlags |= FT_LOAD_RENDER;
+	if (m_jobLoad == GlyphLoad::SDF) loadFlags = FT_LOAD_NO_HINTING;
+
+	for (size_t i = m_jobNext.fetch_add(1); i < m_jobCount; i = m_jobNext.fetch_add(1))
+	{
+		FT_UInt glyphIndex = FT_Get_Char_Index(face, m_jobCodepoints[i]);
+		if (glyphIndex == 0 || FT_Load_Glyph(face, glyphIndex, loadFlags))
+			continue;
+
+#if SABLEUI_FT_HAS_SDF
+		if (m_jobLoad == GlyphLoad::SDF && FT_Render_Glyph(face->glyph, FT_RENDER_MODE_SDF))
+			continue;
+#endif
+
+		FT_GlyphSlot glyph = face->glyph;
+		RasterisedGlyph& out = (*m_jobOut)[i];
+
+		out.valid = true;
+		out.advance = glyph->advance.x;
+		if (m_jobLoad == GlyphLoad::Metrics) continue;
+
+		out.size = { static_cast<uint16_t>(glyph->bitmap.width), static_cast<uint16_t>(glyph->bitmap.rows) };
+		out.bearing = SableUI::vec2(static_cast<float>(glyph->bitmap_left), static_cast<float>(glyph->bitmap_top));
+
+		if (out.size.x == 0 || out.size.y == 0 || !glyph->bitmap.buffer)
+			continue;
+
+		out.bitmap.resize(static_cast<size_t>(out.size.x) * out.size.y);
+		for (int y = 0; y < out.size.y; y++)
+		{
+			const uint8_t* srcRow = glyph->bitmap.buffer + static_cast<ptrdiff_t>(y) * glyph->bitmap.pitch;
+			std::memcpy(out.bitmap.data() + static_cast<size_t>(y) * out.size.x, srcRow, out.size.x);
+		}
+	}
+}
+
+FT_Face GlyphRasterPool::GetFace(size_t slot, const std::string& fontPath)
+{
+	auto& faces = m_faces[slot];
+
+	auto it = faces.find(fontPath);
+	if (it != faces.end())
+		return it->second;
+
+	FT_Face face = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(*m_libraryMutex);
+		if (FT_New_Face(m_library, fontPath.c_str(), 0, &face))
+		{
+			SableUI_Error("Could not load font: %s", fontPath.c_str());
+			return nullptr;
+		}
+	}
+
+	faces[fontPath] = face;
+	return face;
+}
+
 // ============================================================================
 // FontManager
 // ============================================================================
@@ -363,8 +787,10 @@ public:
 		std::vector<TextVertex>& outVertices,
 		std::vector<uint32_t>& outIndices,
 		int& outHeight,
-		int& outActualLineWidth);
-	int GetMinWidth(SableUI::_Text* text, bool wrapped);
+		int& outActualLineWidth,
+		uint64_t& outAtlasLayers);
+	// height and widest line as GetTextVertexData lays them out, metrics only, nothing is rasterised
+	void MeasureTextLayout(const SableUI::_Text* text, int& outHeight, int& outActualLineWidth);
 
 	void InitFreeType();
 	void ShutdownFreeType();
@@ -373,8 +799,36 @@ public:
 	void ResizeTextureArray(int newDepth);
 	const SableUI::GpuTexture2DArray* GetTextAtlasTexture() const { return &atlasTextureArray; }
 
-	std::map<char_t, Character> characters;
+	void SetAtlasLayerBudget(int layers);
+	SableUI::AtlasStats GetAtlasStats() const { return atlasAllocator.GetStats(); }
+	uint64_t GetAtlasGeneration() const { return atlasGeneration; }
+	void AdvanceAtlasFrame() { atlasFrame++; }
+	void TouchAtlasLayers(uint64_t layers);
+
+	SableUI::GlyphRenderMode renderMode = SableUI::GlyphRenderMode::Bitmap;
+	void SetRenderMode(SableUI::GlyphRenderMode mode);
+
+	GlyphTable characters;
 	bool FindFontRangeForChar(char32_t c, SableUI::FontRange& outRange);
+	// metrics only, loads the glyph's range on a miss, nullptr if no font covers it
+	const Character* GetGlyph(const char_t& key);
+	float GetAdvance(char32_t c, int fontSize, FontType fontType);
+	// next token at or after pos, style tags passed over are applied to style. false at the end
+	bool NextToken(const char32_t* text, uint32_t length, uint32_t& pos, int fontSize,
+		FontType& style, TextToken& outToken, float* outAdvances = nullptr);
+
+	// text tokenised and measured at fontSize a hard line at a time, each line is shaped on its
+	// first request only. lines of previous an edit did not touch are reused without a lookup
+	std::shared_ptr<const SableUI::ShapedParagraph> GetParagraph(const SableString& text, int fontSize,
+		const SableUI::ShapedParagraph* previous = nullptr);
+	SableUI::ParagraphCacheStats GetParagraphStats() const;
+	// rasterises and packs any of these glyphs not already in the atlas
+	void RasteriseGlyphs(const std::vector<char_t>& keys);
+	// the lines drawn after wrapping and truncation, the last one cut to fit its ellipsis
+	void LayoutDrawnLines(const SableUI::_Text* text, std::vector<DrawnLine>& outLines);
+
+	std::vector<std::string> fontPaths; // Character::font indexes this
+	uint16_t InternFontPath(const std::string& fontPath);
 
 	std::vector<Atlas> atlases;
 	std::vector<SableUI::FontPack> cachedFontPacks;
@@ -385,34 +839,57 @@ public:
 
 	SableUI::GpuTexture2DArray atlasTextureArray;
 	int atlasDepth = MIN_ATLAS_DEPTH;
-	SableUI::u16vec2 atlasCursor = { ATLAS_PADDING, ATLAS_PADDING };
+
+	/* glyphs are packed one by one when first drawn, the allocator reclaims
+	 * the least recently used layer once the budget is full. each layer keeps
+	 * a cpu copy and the band of rows touched since the last upload */
+	struct AtlasLayerPixels {
+		std::vector<uint8_t> pixels;
+		int dirtyMinY = ATLAS_HEIGHT;
+		int dirtyMaxY = 0;
+	};
+
+	SableUI::AtlasAllocator atlasAllocator{ ATLAS_WIDTH, ATLAS_HEIGHT, ATLAS_PADDING, DEFAULT_ATLAS_LAYER_BUDGET };
+	std::vector<AtlasLayerPixels> atlasLayers;
+	std::vector<uint64_t> evictedGlyphs;
+	uint64_t atlasFrame = 1;
+	uint64_t atlasGeneration = 0; // bumped whenever glyphs are evicted
 
 	std::set<std::tuple<SableUI::FontRange, int, FontType>> loadedAtlasKeys;
 
 	FontRangeHash GetAtlasHash(const SableUI::FontRange& range, int fontSize);
-	FT_Face GetFontForChar(char32_t c, int fontSize, const std::string& fontPathForAtlas,
-		std::map<std::string, FT_Face>& currentLoadedFaces) const;
-	void RenderGlyphs(Atlas& atlas);
+	void LoadRangeMetrics(Atlas& atlas);
 	void LoadFontRange(Atlas& atlas, const SableUI::FontRange& range);
 
-	void SerialiseAtlas(const Atlas& atlas, uint8_t* pixels, int width, int height,
-		const std::map<char32_t, Character>& charsToSerialise, int initialYOffset);
+	void SerialiseAtlas(const Atlas& atlas, const std::vector<RasterisedGlyph>& glyphs);
 	bool DeserialiseAtlas(const std::string& filename, Atlas& outAtlas);
 
 	bool SerialiseFontPack(const SableUI::FontPack& pack);
 	bool DeserialiseFontPack(const std::string& fontFilename, SableUI::FontPack& outPack);
 	std::string GetFontPackCacheFilename(const std::string& fontFilename);
 
-	void UploadAtlasToGPU(int height, int initialY, uint8_t* pixels);
+	void PlaceGlyph(Character& character, uint64_t packedKey, const RasterisedGlyph& glyph);
+	void DropEvictedGlyphs();
+	void FlushAtlasUploads();
 
 private:
 	FontManager() : isInitialized(false) {}
 
-	std::unordered_map<std::string, FT_Face> m_cachedFaces;
-	std::mutex m_faceCacheMutex;
+	GlyphRasterPool m_rasterPool;
+	std::mutex m_libraryMutex; // guards FT_New_Face and FT_Done_Face
 
 	std::chrono::steady_clock::time_point lastDecayCheck;
 	FontType currentFontType = FontType::Regular;
+
+	// most recently used first, indexed by content hash. lines sharing a hash are told apart by comparing the text
+	using ShapedLineList = std::list<std::shared_ptr<const ShapedLine>>;
+	ShapedLineList m_lineOrder;
+	std::unordered_multimap<size_t, ShapedLineList::iterator> m_lineIndex;
+	size_t m_lineBytes = 0;
+	uint64_t m_paragraphHits = 0;
+	uint64_t m_paragraphMisses = 0;
+	std::shared_ptr<const ShapedLine> GetShapedLine(const char32_t* text, uint32_t length, int fontSize, FontType style);
+	void TrimShapedLines();
 	std::string GetCurrentFontDirectory() const;
 	const std::vector<FontPackHint>& GetCurrentFontPackHints();
 	std::string GetPrimaryFontFilename() const;
@@ -442,9 +919,12 @@ bool FontManager::Initialise()
 	atlasTextureArray.Init(ATLAS_WIDTH, ATLAS_HEIGHT, MIN_ATLAS_DEPTH);
 
 	atlasDepth = MIN_ATLAS_DEPTH;
+	atlasAllocator.Clear();
+	atlasLayers.clear();
 	fontManager = &GetInstance();
 
 	InitFreeType();
+	m_rasterPool.Start(ft_library, &m_libraryMutex);
 
 	// Only load the primary font pack on initialization
 	LoadFontPackByFilename("fonts/Regular", "NotoSans-Regular.ttf");
@@ -459,20 +939,20 @@ void FontManager::Shutdown()
 {
 	if (!isInitialized) return;
 
-	{
-		std::lock_guard<std::mutex> lock(m_faceCacheMutex);
-		for (auto& [path, face] : m_cachedFaces)
-		{
-			if (face)
-				FT_Done_Face(face);
-		}
-		m_cachedFaces.clear();
-	}
+	m_rasterPool.Stop();
 
 	atlases.clear();
-	characters.clear();
+	characters.Clear();
+	fontPaths.clear();
 	cachedFontPacks.clear();
 	loadedAtlasKeys.clear();
+	atlasAllocator.Clear();
+	atlasLayers.clear();
+	evictedGlyphs.clear();
+	atlasGeneration++;
+	m_lineIndex.clear();
+	m_lineOrder.clear();
+	m_lineBytes = 0;
 
 	ShutdownFreeType();
 	SableUI_Log("FontManager shut down");
@@ -487,6 +967,11 @@ void FontManager::InitFreeType()
 	FT_Bool no_stem_darkening = false;
 	FT_Property_Set(ft_library, "cff", "no-stem-darkening", &no_stem_darkening);
 	FT_Property_Set(ft_library, "autofitter", "no-stem-darkening", &no_stem_darkening);
+#if SABLEUI_FT_HAS_SDF
+	FT_Int spread = SableUI::SDF_SPREAD;
+	FT_Property_Set(ft_library, "sdf", "spread", &spread);
+	FT_Property_Set(ft_library, "bsdf", "spread", &spread);
+#endif
 	FreeTypeRunning = true;
 }
 
@@ -541,20 +1026,7 @@ std::string FontManager::GetPrimaryFontFilename() const
 
 bool FontManager::SetStyleChar(char32_t c)
 {
-	switch (static_cast<SableUI::StyleTag>(c))
-	{
-	case SableUI::StyleTag::BoldStart:        currentFontType = FontType::Bold;         return true;
-	case SableUI::StyleTag::BoldEnd:          currentFontType = FontType::Regular;      return true;
-	case SableUI::StyleTag::ItalicStart:      currentFontType = FontType::Italic;       return true;
-	case SableUI::StyleTag::ItalicEnd:        currentFontType = FontType::Regular;      return true;
-	case SableUI::StyleTag::BoldItalicStart:  currentFontType = FontType::BoldItalic;   return true;
-	case SableUI::StyleTag::BoldItalicEnd:    currentFontType = FontType::Regular;      return true;
-	case SableUI::StyleTag::LightStart:       currentFontType = FontType::Light;        return true;
-	case SableUI::StyleTag::LightEnd:         currentFontType = FontType::Regular;      return true;
-	case SableUI::StyleTag::LightItalicStart: currentFontType = FontType::LightItalic;  return true;
-	case SableUI::StyleTag::LightItalicEnd:   currentFontType = FontType::Regular;      return true;
-	default: return false;
-	}
+	return GetStyleTagType(c, currentFontType);
 }
 
 bool FontManager::LoadFontPackByFilename(const std::string& fontDir, const std::string& filename)
@@ -822,6 +1294,7 @@ void FontManager::ResizeTextureArray(int newDepth)
 	}
 
 	SableUI::GpuTexture2DArray newAtlasTextureArray;
+	newAtlasTextureArray.SetLinearFiltering(renderMode == SableUI::GlyphRenderMode::SDF);
 	newAtlasTextureArray.Init(ATLAS_WIDTH, ATLAS_HEIGHT, newDepth);
 	newAtlasTextureArray.CopyImageSubData(atlasTextureArray, 0, 0, 0, 0, 0, 0,
 		ATLAS_WIDTH, ATLAS_HEIGHT, atlasDepth);
@@ -832,293 +1305,296 @@ void FontManager::ResizeTextureArray(int newDepth)
 	atlasTextureArray.Unbind();
 } // newAtlasTextureArray will be destroyed
 
-FontRangeHash FontManager::GetAtlasHash(const SableUI::FontRange& range, int fontSize)
+void FontManager::SetAtlasLayerBudget(int layers)
 {
-	// inspired from djb2 hash
-	FontRangeHash h;
-	unsigned long long hashValue = 5381;
-
-	hashValue = ((hashValue << 5) + hashValue) + fontSize;
-	hashValue = ((hashValue << 5) + hashValue) + range.start;
-	hashValue = ((hashValue << 5) + hashValue) + range.end;
-	hashValue = ((hashValue << 5) + hashValue) + ATLAS_PADDING;
+	atlasAllocator.SetLayerBudget(layers);
+}
 
-	for (char c : range.fontPath)
+void FontManager::SetRenderMode(SableUI::GlyphRenderMode mode)
+{
+#if !SABLEUI_FT_HAS_SDF
+	if (mode == SableUI::GlyphRenderMode::SDF)
 	{
-		hashValue = ((hashValue << 5) + hashValue) + c;
+		SableUI_Warn("SDF glyphs need FreeType 2.11 or newer, keeping bitmap glyphs");
+		return;
 	}
+#endif
 
-	std::stringstream ss;
-	ss << std::hex << hashValue;
-	std::string hexHash = ss.str();
+	if (mode == renderMode) return;
+	renderMode = mode;
 
-	size_t len = std::min(hexHash.length(), sizeof(h.data) - 1);
-	memcpy(h.data, hexHash.c_str(), len);
-	h.data[len] = '\0'; // terminate c-style string
-	return h;
+	// every rasterised glyph belongs to the old mode, metrics are shared
+	characters.ForEach([](Character& character) {
+		character.rasterised = false;
+		character.pos = SableUI::u16vec2(0);
+		character.layer = 0;
+	});
+
+	atlasAllocator.Clear();
+	atlasLayers.clear();
+	evictedGlyphs.clear();
+	atlasTextureArray.SetLinearFiltering(mode == SableUI::GlyphRenderMode::SDF);
+	atlasGeneration++;
 }
 
-FT_Face FontManager::GetFontForChar(char32_t c, int fontSize, const std::string& fontPathForAtlas,
-	std::map<std::string, FT_Face>& currentLoadedFaces) const
+void FontManager::TouchAtlasLayers(uint64_t layers)
 {
-	if (fontPathForAtlas.empty())
+	int layerCount = atlasAllocator.GetLayerCount();
+	for (int i = 0; i < layerCount && layers != 0; i++)
 	{
-		SableUI_Error("GetFontForChar: Empty font path provided for char U+%04X",
-			static_cast<unsigned int>(c));
-		return nullptr;
+		if (layers & AtlasLayerBit(static_cast<uint16_t>(i)))
+			atlasAllocator.Touch(static_cast<uint16_t>(i), atlasFrame);
+
+		if (i < 63) layers &= ~(1ull << i);
 	}
+}
+
+void FontManager::PlaceGlyph(Character& character, uint64_t packedKey, const RasterisedGlyph& glyph)
+{
+	character.rasterised = true;
+	character.size = glyph.valid ? glyph.size : SableUI::u16vec2(0);
+	character.bearing = glyph.bearing;
+
+	if (character.size.x == 0 || character.size.y == 0)
+		return;
 
-	auto it = currentLoadedFaces.find(fontPathForAtlas);
-	if (it != currentLoadedFaces.end())
+	SableUI::AtlasSlot slot;
+	size_t evictedBefore = evictedGlyphs.size();
+	if (!atlasAllocator.Allocate(packedKey, character.size.x, character.size.y, atlasFrame, slot, evictedGlyphs))
 	{
-		if (it->second->size->metrics.x_ppem != fontSize)
-		{
-			FT_Set_Pixel_Sizes(it->second, 0, fontSize);
-		}
-		return it->second;
+		SableUI_Error("Glyph U+%04X (%ix%i) does not fit in an atlas layer",
+			static_cast<unsigned int>(packedKey & 0x1FFFFFu), character.size.x, character.size.y);
+		character.size = SableUI::u16vec2(0);
+		return;
 	}
 
+	if (slot.layer >= atlasLayers.size())
+		atlasLayers.resize(slot.layer + 1);
+
+	AtlasLayerPixels& layer = atlasLayers[slot.layer];
+	if (layer.pixels.empty() || evictedGlyphs.size() > evictedBefore)
 	{
-		std::lock_guard<std::mutex> lock(const_cast<FontManager*>(this)->m_faceCacheMutex);
-		auto globalIt = const_cast<FontManager*>(this)->m_cachedFaces.find(fontPathForAtlas);
-		if (globalIt != const_cast<FontManager*>(this)->m_cachedFaces.end())
-		{
-			FT_Set_Pixel_Sizes(globalIt->second, 0, fontSize);
-			currentLoadedFaces[fontPathForAtlas] = globalIt->second;
-			return globalIt->second;
-		}
+		// new or reclaimed layer, old glyphs must not bleed into the padding
+		layer.pixels.assign(static_cast<size_t>(ATLAS_WIDTH) * ATLAS_HEIGHT, 0);
+		layer.dirtyMinY = 0;
+		layer.dirtyMaxY = ATLAS_HEIGHT;
 	}
 
-	FT_Face face;
-	if (FT_New_Face(ft_library, fontPathForAtlas.c_str(), 0, &face))
+	if (!glyph.bitmap.empty())
 	{
-		SableUI_Error("Could not load font: %s for char U+%04X",
-			fontPathForAtlas.c_str(), static_cast<unsigned int>(c));
-		return nullptr;
+		for (int y = 0; y < character.size.y; y++)
+		{
+			size_t rowStart = static_cast<size_t>(slot.y + y) * ATLAS_WIDTH + slot.x;
+			std::memcpy(layer.pixels.data() + rowStart,
+				glyph.bitmap.data() + static_cast<size_t>(y) * character.size.x, character.size.x);
+		}
 	}
 
-	FT_Set_Pixel_Sizes(face, 0, fontSize);
+	layer.dirtyMinY = std::min<int>(layer.dirtyMinY, slot.y);
+	layer.dirtyMaxY = std::max<int>(layer.dirtyMaxY, slot.y + character.size.y);
 
-	{
-		std::lock_guard<std::mutex> lock(const_cast<FontManager*>(this)->m_faceCacheMutex);
-		const_cast<FontManager*>(this)->m_cachedFaces[fontPathForAtlas] = face;
-	}
+	character.pos = SableUI::u16vec2(slot.x, slot.y);
+	character.layer = slot.layer;
 
-	currentLoadedFaces[fontPathForAtlas] = face;
-	SableUI_Log("Loaded and cached font: %s (size %i)", fontPathForAtlas.c_str(), fontSize);
-	return face;
+	DropEvictedGlyphs();
 }
 
-void FontManager::RenderGlyphs(Atlas& atlas)
+void FontManager::DropEvictedGlyphs()
 {
-	SableUI_Log("Rendering glyphs for range: U+%04X - U+%04X (size %i) from %s",
-		static_cast<unsigned int>(atlas.range.start),
-		static_cast<unsigned int>(atlas.range.end),
-		atlas.fontSize,
-		atlas.range.fontPath.c_str());
-
-	std::map<std::string, FT_Face> facesForCurrentRender;
-
-	int initialAtlasYForRenderPass = atlasCursor.y;
-
-	// first pass, get bounds of all glyphs to calculate height of atlas
-	SableUI::uvec2 tempCursor = { ATLAS_PADDING, atlasCursor.y };
-	uint16_t currentRowHeight = 0;
-	int maxGlobalYReached = atlasCursor.y;
+	if (evictedGlyphs.empty()) return;
 
-	for (char32_t c = atlas.range.start; c <= atlas.range.end; c++)
+	// metrics stay, the bitmap is rasterised again next time it is drawn
+	for (uint64_t packed : evictedGlyphs)
 	{
-		FT_Face face = GetFontForChar(c, static_cast<int>(atlas.fontSize), atlas.range.fontPath, facesForCurrentRender);
-		if (!face) continue;
+		if (Character* character = characters.Find(packed))
+		{
+			character->rasterised = false;
+			character->pos = SableUI::u16vec2(0);
+			character->layer = 0;
+		}
+	}
 
-		FT_Set_Pixel_Sizes(face, 0, static_cast<int>(atlas.fontSize));
+	evictedGlyphs.clear();
+	atlasGeneration++;
+}
 
-		FT_UInt glyphIndex = FT_Get_Char_Index(face, c);
-		if (glyphIndex == 0 || FT_Load_Glyph(face, glyphIndex, FT_LOAD_RENDER | FT_LOAD_TARGET_LIGHT | FT_LOAD_FORCE_AUTOHINT)) continue;
+void FontManager::RasteriseGlyphs(const std::vector<char_t>& keys)
+{
+	struct PendingGlyph {
+		uint16_t font;
+		int fontSize;
+		char32_t c;
+		uint64_t packed;
+	};
 
-		FT_GlyphSlot glyph = face->glyph;
-		FT_Render_Glyph(glyph, FT_RENDER_MODE_NORMAL);
+	bool sdf = renderMode == SableUI::GlyphRenderMode::SDF;
 
-		SableUI::u16vec2 size = { (uint16_t)glyph->bitmap.width, (uint16_t)glyph->bitmap.rows };
+	std::vector<PendingGlyph> pending;
+	for (const char_t& key : keys)
+	{
+		const Character* glyph = characters.Find(key);
+		if (glyph == nullptr) continue;
 
-		if (size.x == 0 || size.y == 0)
+		// every size shares the one field rendered at the reference size
+		char_t drawnKey = key;
+		if (sdf)
 		{
-			tempCursor.x += (glyph->advance.x >> 6) + ATLAS_PADDING;
-			maxGlobalYReached = std::max(maxGlobalYReached, (int)tempCursor.y + (int)currentRowHeight);
-			continue;
-		}
+			drawnKey.fontSize = SDF_GLYPH_KEY_SIZE;
+			uint16_t font = glyph->font;
 
-		int currentLayer = tempCursor.y / ATLAS_HEIGHT;
-		int potentialEndGlobalY = tempCursor.y + size.y;
-		int currentLayerEndGlobalY = (currentLayer + 1) * ATLAS_HEIGHT;
-
-		if (tempCursor.x + size.x + ATLAS_PADDING > ATLAS_WIDTH)
-		{
-			tempCursor.x = ATLAS_PADDING;
-			tempCursor.y += currentRowHeight + ATLAS_PADDING;
-			currentRowHeight = 0;
+			Character& field = characters[drawnKey];
+			field.font = font;
+			glyph = &field;
 		}
 
-		if (potentialEndGlobalY > currentLayerEndGlobalY)
+		// stamp resident glyphs first so placing the rest cannot reclaim them
+		if (glyph->rasterised)
 		{
-			tempCursor.x = ATLAS_PADDING;
-			tempCursor.y = (currentLayer + 1) * ATLAS_HEIGHT + ATLAS_PADDING;
-			currentRowHeight = 0;
+			if (glyph->size.x > 0 && glyph->size.y > 0)
+				atlasAllocator.Touch(glyph->layer, atlasFrame);
+			continue;
 		}
 
-		currentRowHeight = std::max(currentRowHeight, size.y);
-		tempCursor.x += size.x + ATLAS_PADDING;
-
-		maxGlobalYReached = std::max(maxGlobalYReached, (int)tempCursor.y + (int)currentRowHeight);
+		int rasterSize = sdf ? SableUI::SDF_REFERENCE_SIZE : key.fontSize;
+		pending.push_back({ glyph->font, rasterSize, key.c, GlyphTable::PackKey(drawnKey) });
 	}
 
-	int requiredHeightForPass = maxGlobalYReached - initialAtlasYForRenderPass;
-	if (requiredHeightForPass < 0) requiredHeightForPass = 0;
+	if (pending.empty()) return;
 
-	if (requiredHeightForPass == 0 && (atlas.range.start <= atlas.range.end))
+	std::sort(pending.begin(), pending.end(), [](const PendingGlyph& a, const PendingGlyph& b) {
+		return std::tie(a.font, a.fontSize, a.packed) < std::tie(b.font, b.fontSize, b.packed);
+	});
+	pending.erase(std::unique(pending.begin(), pending.end(), [](const PendingGlyph& a, const PendingGlyph& b) {
+		return a.packed == b.packed;
+	}), pending.end());
+
+	// one pool job per font file and size
+	std::vector<char32_t> codepoints;
+	std::vector<RasterisedGlyph> glyphs;
+	for (size_t begin = 0; begin < pending.size();)
 	{
-		if (atlas.fontSize > 0)
+		size_t end = begin;
+		codepoints.clear();
+		while (end < pending.size() && pending[end].font == pending[begin].font
+			&& pending[end].fontSize == pending[begin].fontSize)
 		{
-			requiredHeightForPass = atlas.fontSize + ATLAS_PADDING;
+			codepoints.push_back(pending[end].c);
+			end++;
 		}
-		else
+
+		m_rasterPool.Rasterise(fontPaths[pending[begin].font], pending[begin].fontSize, codepoints,
+			sdf ? GlyphLoad::SDF : GlyphLoad::Bitmap, glyphs);
+
+		for (size_t i = 0; i < glyphs.size(); i++)
 		{
-			requiredHeightForPass = ATLAS_PADDING + 1;
+			if (Character* character = characters.Find(pending[begin + i].packed))
+				PlaceGlyph(*character, pending[begin + i].packed, glyphs[i]);
 		}
+
+		begin = end;
 	}
 
+	FlushAtlasUploads();
+}
+
+uint16_t FontManager::InternFontPath(const std::string& fontPath)
+{
+	for (size_t i = 0; i < fontPaths.size(); i++)
+		if (fontPaths[i] == fontPath)
+			return static_cast<uint16_t>(i);
 
-	int proposedEndGlobalY = initialAtlasYForRenderPass + requiredHeightForPass;
-	int newDepth = static_cast<int>(std::ceil(static_cast<float>(proposedEndGlobalY) / ATLAS_HEIGHT));
+	fontPaths.push_back(fontPath);
+	return static_cast<uint16_t>(fontPaths.size() - 1);
+}
 
-	if (newDepth > atlasDepth)
+void FontManager::FlushAtlasUploads()
+{
+	int layerCount = static_cast<int>(atlasLayers.size());
+	if (layerCount > atlasDepth)
 	{
+		// grow geometrically up to the budget so a burst of new ranges is one copy, not many
+		int newDepth = std::max(layerCount, std::min(atlasDepth * 2, atlasAllocator.GetLayerBudget()));
 		ResizeTextureArray(newDepth);
 	}
 
-	auto atlasPixels = new uint8_t[static_cast<size_t>(ATLAS_WIDTH) * requiredHeightForPass * 1];
-	std::memset(atlasPixels, 0, static_cast<size_t>(ATLAS_WIDTH) * requiredHeightForPass * 1);
-
-	currentRowHeight = 0;
-	atlasCursor.x = ATLAS_PADDING;
-	atlasCursor.y = initialAtlasYForRenderPass;
-
-	std::map<char32_t, Character> charsForSerialization;
+	atlasTextureArray.Bind();
 
-	/* second pass, render glyphs and fill the cpu-side buffer */
-	for (char32_t c = atlas.range.start; c <= atlas.range.end; c++)
+	for (int i = 0; i < layerCount; i++)
 	{
-		FT_Face face = GetFontForChar(c, atlas.fontSize, atlas.range.fontPath, facesForCurrentRender);
-		if (!face) continue;
+		AtlasLayerPixels& layer = atlasLayers[i];
+		if (layer.dirtyMinY >= layer.dirtyMaxY) continue;
 
-		FT_Set_Pixel_Sizes(face, 0, static_cast<int>(atlas.fontSize));
+		// whole rows, so the default unpack alignment holds for any glyph width
+		const uint8_t* rows = layer.pixels.data() + static_cast<size_t>(layer.dirtyMinY) * ATLAS_WIDTH;
+		atlasTextureArray.SubImage(0, layer.dirtyMinY, i, ATLAS_WIDTH, layer.dirtyMaxY - layer.dirtyMinY, 1, rows);
 
-		FT_UInt glyphIndex = FT_Get_Char_Index(face, c);
-		if (glyphIndex == 0 || FT_Load_Glyph(face, glyphIndex, FT_LOAD_RENDER | FT_LOAD_TARGET_LIGHT | FT_LOAD_FORCE_AUTOHINT)) continue;
+		layer.dirtyMinY = ATLAS_HEIGHT;
+		layer.dirtyMaxY = 0;
+	}
 
-		FT_Render_Glyph(face->glyph, FT_RENDER_MODE_NORMAL);
+	atlasTextureArray.Unbind();
+}
 
-		FT_GlyphSlot glyph = face->glyph;
-		int displayWidth = glyph->bitmap.width;
-		SableUI::u16vec2 size = { static_cast<uint16_t>(displayWidth), (uint16_t)glyph->bitmap.rows };
+FontRangeHash FontManager::GetAtlasHash(const SableUI::FontRange& range, int fontSize)
+{
+	// inspired from djb2 hash
+	FontRangeHash h;
+	unsigned long long hashValue = 5381;
 
-		if (size.x == 0 || size.y == 0)
-		{
-			Character emptyChar = Character(
-				atlasCursor,
-				size,
-				SableUI::vec2(static_cast<float>(glyph->bitmap_left), static_cast<float>(glyph->bitmap_top)),
-				static_cast<float>(glyph->advance.x) / 64.0f,
-				static_cast<uint16_t>(atlasCursor.y / ATLAS_HEIGHT)
-			);
-
-			char_t ct = { c, atlas.fontSize, currentFontType };
-			characters[ct] = emptyChar;
-			charsForSerialization[c] = emptyChar;
-
-			atlasCursor.x += (glyph->advance.x >> 6) + ATLAS_PADDING;
-			continue;
-		}
+	hashValue = ((hashValue << 5) + hashValue) + fontSize;
+	hashValue = ((hashValue << 5) + hashValue) + range.start;
+	hashValue = ((hashValue << 5) + hashValue) + range.end;
+	hashValue = ((hashValue << 5) + hashValue) + ATLAS_PADDING;
 
-		int currentLayer = atlasCursor.y / ATLAS_HEIGHT;
-		int potentialEndGlobalY = atlasCursor.y + size.y;
-		int currentLayerEndGlobalY = (currentLayer + 1) * ATLAS_HEIGHT;
-
-		if (atlasCursor.x + size.x + ATLAS_PADDING > ATLAS_WIDTH)
-		{
-			atlasCursor.x = ATLAS_PADDING;
-			atlasCursor.y += currentRowHeight + ATLAS_PADDING;
-			currentRowHeight = 0;
-		}
+	for (char c : range.fontPath)
+	{
+		hashValue = ((hashValue << 5) + hashValue) + c;
+	}
 
-		if (potentialEndGlobalY > currentLayerEndGlobalY)
-		{
-			atlasCursor.x = ATLAS_PADDING;
-			atlasCursor.y = (currentLayer + 1) * ATLAS_HEIGHT + ATLAS_PADDING;
-			currentRowHeight = 0;
-		}
+	std::stringstream ss;
+	ss << std::hex << hashValue;
+	std::string hexHash = ss.str();
 
-		currentRowHeight = std::max(currentRowHeight, size.y);
+	size_t len = std::min(hexHash.length(), sizeof(h.data) - 1);
+	memcpy(h.data, hexHash.c_str(), len);
+	h.data[len] = '\0'; // terminate c-style string
+	return h;
+}
 
-		int yOffsetInAtlasPixels = (atlasCursor.y - initialAtlasYForRenderPass);
+void FontManager::LoadRangeMetrics(Atlas& atlas)
+{
+	SableUI_Log("Loading glyph metrics for range: U+%04X - U+%04X (size %i) from %s",
+		static_cast<unsigned int>(atlas.range.start),
+		static_cast<unsigned int>(atlas.range.end),
+		atlas.fontSize,
+		atlas.range.fontPath.c_str());
 
-		if ((yOffsetInAtlasPixels + size.y) > requiredHeightForPass || yOffsetInAtlasPixels < 0)
-		{
-			SableUI_Error("Atlas overflow during glyph rendering (glyph too tall/misplaced for remaining space)! Char: U+%04X. Corrupt?",
-				static_cast<unsigned int>(c));
-
-			char_t ct = { c, atlas.fontSize, currentFontType };
-			characters[ct] = Character(
-				atlasCursor,
-				size,
-				SableUI::vec2(static_cast<float>(glyph->bitmap_left), static_cast<float>(glyph->bitmap_top)),
-				static_cast<float>(glyph->advance.x) / 64.0f,
-				static_cast<uint16_t>(atlasCursor.y / ATLAS_HEIGHT)
-			);
-			charsForSerialization[c] = characters[ct];
-			atlasCursor.x += (glyph->advance.x >> 6) + ATLAS_PADDING;
-			continue;
-		}
+	if (atlas.range.fontPath.empty())
+	{
+		SableUI_Error("LoadRangeMetrics: Empty font path provided for range U+%04X - U+%04X",
+			static_cast<unsigned int>(atlas.range.start), static_cast<unsigned int>(atlas.range.end));
+		return;
+	}
 
-		for (int y = 0; y < size.y; y++)
-		{
-			uint8_t* srcRow = glyph->bitmap.buffer + static_cast<size_t>(y) * glyph->bitmap.pitch;
-			for (int dx = 0; dx < displayWidth; dx++)
-			{
-				size_t destX = atlasCursor.x + static_cast<size_t>(dx);
-				size_t pixelIndexInAtlasPixels = (static_cast<size_t>(yOffsetInAtlasPixels + y) * ATLAS_WIDTH + destX) * 1;
+	// advances only, bitmaps wait until a glyph is drawn
+	std::vector<char32_t> codepoints;
+	for (char32_t c = atlas.range.start; c <= atlas.range.end; c++)
+		codepoints.push_back(c);
 
-				if (pixelIndexInAtlasPixels < static_cast<size_t>(ATLAS_WIDTH) * requiredHeightForPass * 1)
-				{
-					if (glyph->bitmap.buffer)
-					{
-						atlasPixels[pixelIndexInAtlasPixels] = srcRow[dx];
-					}
-				}
-			}
-		}
+	std::vector<RasterisedGlyph> glyphs;
+	m_rasterPool.Rasterise(atlas.range.fontPath, atlas.fontSize, codepoints, GlyphLoad::Metrics, glyphs);
 
-		char_t ct = { c, atlas.fontSize, currentFontType };
-		characters[ct] = Character(
-			atlasCursor,
-			size,
-			SableUI::vec2(static_cast<float>(glyph->bitmap_left), static_cast<float>(glyph->bitmap_top)),
-			static_cast<float>(glyph->advance.x) / 64.0f,
-			static_cast<uint16_t>(atlasCursor.y / ATLAS_HEIGHT)
-		);
-		charsForSerialization[c] = characters[ct];
+	uint16_t font = InternFontPath(atlas.range.fontPath);
+	for (size_t i = 0; i < glyphs.size(); i++)
+	{
+		if (!glyphs[i].valid) continue;
 
-		atlasCursor.x += size.x + ATLAS_PADDING;
+		Character& character = characters[{ codepoints[i], atlas.fontSize, currentFontType }];
+		character.advance = static_cast<float>(glyphs[i].advance) / 64.0f;
+		character.font = font;
 	}
 
-	UploadAtlasToGPU(requiredHeightForPass, initialAtlasYForRenderPass, atlasPixels);
-
-	SerialiseAtlas(atlas, atlasPixels, ATLAS_WIDTH, requiredHeightForPass,
-		charsForSerialization, initialAtlasYForRenderPass);
-
-	delete[] atlasPixels;
-
-	atlasCursor.y = initialAtlasYForRenderPass + requiredHeightForPass + ATLAS_PADDING;
+	SerialiseAtlas(atlas, glyphs);
 }
 
 std::string FontManager::GetFontPackCacheFilename(const std::string& fontFilename)
@@ -1283,35 +1759,7 @@ bool FontManager::DeserialiseFontPack(const std::string& fontFilename, SableUI::
 	}
 }
 
-void FontManager::UploadAtlasToGPU(int height, int initialY, uint8_t* pixels)
-{
-	atlasTextureArray.Bind();
-
-	int currentUploadY = 0;
-	while (currentUploadY < height)
-	{
-		int globalYForChunk = initialY + currentUploadY;
-
-		int targetLayer = globalYForChunk / ATLAS_HEIGHT;
-		int yOffsetInTargetLayer = globalYForChunk % ATLAS_HEIGHT;
-
-		int heightToUpload = std::min(ATLAS_HEIGHT - yOffsetInTargetLayer, height - currentUploadY);
-
-		if (heightToUpload <= 0) break;
-
-		const uint8_t* chunkPixels = pixels + (static_cast<size_t>(currentUploadY) *
-			ATLAS_WIDTH * 1);
-
-		atlasTextureArray.SubImage(0, yOffsetInTargetLayer, targetLayer, ATLAS_WIDTH, heightToUpload, 1, chunkPixels);
-
-		currentUploadY += heightToUpload;
-	}
-
-	atlasTextureArray.Unbind();
-}
-
-void FontManager::SerialiseAtlas(const Atlas& atlas, uint8_t* pixels, int width, int height,
-	const std::map<char32_t, Character>& charsToSerialise, int initialYOffset)
+void FontManager::SerialiseAtlas(const Atlas& atlas, const std::vector<RasterisedGlyph>& glyphs)
 {
 	FontRangeHash atlasHash = GetAtlasHash(atlas.range, atlas.fontSize);
 	std::string directory = "cache/";
@@ -1336,42 +1784,29 @@ void FontManager::SerialiseAtlas(const Atlas& atlas, uint8_t* pixels, int width,
 
 	/* header */
 	file.write(reinterpret_cast<const char*>(&ATLAS_CACHE_FILE_VERSION), sizeof(uint32_t));
-	file.write(reinterpret_cast<const char*>(&atlas.fontSize), sizeof(float));
+	file.write(reinterpret_cast<const char*>(&atlas.fontSize), sizeof(int));
 	file.write(reinterpret_cast<const char*>(&atlas.range.start), sizeof(char32_t));
 	file.write(reinterpret_cast<const char*>(&atlas.range.end), sizeof(char32_t));
 	size_t path_len = atlas.range.fontPath.length();
 	file.write(reinterpret_cast<const char*>(&path_len), sizeof(size_t));
 	file.write(atlas.range.fontPath.c_str(), path_len);
 
-	file.write(reinterpret_cast<const char*>(&width), sizeof(int));
-	file.write(reinterpret_cast<const char*>(&height), sizeof(int));
-	file.write(reinterpret_cast<const char*>(&initialYOffset), sizeof(int));
+	/* main content, metrics only, glyphs are rasterised when first drawn */
+	size_t num_chars = 0;
+	for (const RasterisedGlyph& glyph : glyphs)
+		if (glyph.valid) num_chars++;
 
-	/* main content */
-	size_t bytesPerPixel = 1;
-	size_t pxArraySize = static_cast<size_t>(width) * height * bytesPerPixel;
-	file.write(reinterpret_cast<const char*>(pixels), pxArraySize * sizeof(uint8_t));
-
-	size_t num_chars = charsToSerialise.size();
 	file.write(reinterpret_cast<const char*>(&num_chars), sizeof(size_t));
-	for (const auto& pair : charsToSerialise)
+	for (size_t i = 0; i < glyphs.size(); i++)
 	{
-		char32_t char_code = pair.first;
-		Character character = pair.second;
-
-		character.pos.y = character.pos.y - initialYOffset;
-		character.layer = character.pos.y / ATLAS_HEIGHT;
+		const RasterisedGlyph& glyph = glyphs[i];
+		if (!glyph.valid) continue;
 
+		char32_t char_code = atlas.range.start + static_cast<char32_t>(i);
+		float advance = static_cast<float>(glyph.advance) / 64.0f;
 
 		file.write(reinterpret_cast<const char*>(&char_code), sizeof(char32_t));
-		file.write(reinterpret_cast<const char*>(&character.pos.x), sizeof(uint16_t));
-		file.write(reinterpret_cast<const char*>(&character.pos.y), sizeof(uint16_t));
-		file.write(reinterpret_cast<const char*>(&character.size.x), sizeof(uint16_t));
-		file.write(reinterpret_cast<const char*>(&character.size.y), sizeof(uint16_t));
-		file.write(reinterpret_cast<const char*>(&character.bearing.x), sizeof(float));
-		file.write(reinterpret_cast<const char*>(&character.bearing.y), sizeof(float));
-		file.write(reinterpret_cast<const char*>(&character.advance), sizeof(float));
-		file.write(reinterpret_cast<const char*>(&character.layer), sizeof(uint16_t));
+		file.write(reinterpret_cast<const char*>(&advance), sizeof(float));
 	}
 
 	file.close();
@@ -1409,69 +1844,29 @@ bool FontManager::DeserialiseAtlas(const std::string& filename, Atlas& outAtlas)
 		outAtlas.range.fontPath.resize(path_len);
 		file.read(outAtlas.range.fontPath.data(), path_len);
 
-		int cachedWidth{};
-		int cachedHeight{};
-		file.read(reinterpret_cast<char*>(&cachedWidth), sizeof(int));
-		file.read(reinterpret_cast<char*>(&cachedHeight), sizeof(int));
-		int originalInitialYOffset{};
-		file.read(reinterpret_cast<char*>(&originalInitialYOffset), sizeof(int));
-
-
-		if (cachedWidth != ATLAS_WIDTH)
-		{
-			SableUI_Warn("Cached atlas width mismatch for %s. Expected %i, got %i. Regenerating.",
-				filename.c_str(), ATLAS_WIDTH, cachedWidth);
-			file.close();
-			return false;
-		}
-
 		/* main content */
-		size_t bytesPerPixel = 1;
-		size_t pxArraySize = static_cast<size_t>(cachedWidth) * cachedHeight * bytesPerPixel;
-		std::unique_ptr<uint8_t[]> pixels_buffer = std::make_unique<uint8_t[]>(pxArraySize);
-		file.read(reinterpret_cast<char*>(pixels_buffer.get()), pxArraySize * sizeof(uint8_t));
-
-		if (!file)
-		{
-			SableUI_Error("Error reading pixel m_data from cache file: %s", filename.c_str());
-			file.close();
-			return false;
-		}
-
-		int initialAtlasYForDeserialisedPass = atlasCursor.y;
-
-		int proposedEndGlobalY = initialAtlasYForDeserialisedPass + cachedHeight;
-		int requiredDepthForDeserialization = static_cast<int>(std::ceil(static_cast<float>(proposedEndGlobalY) / ATLAS_HEIGHT));
-
-		if (requiredDepthForDeserialization > atlasDepth)
-			ResizeTextureArray(requiredDepthForDeserialization);
-
-		UploadAtlasToGPU(cachedHeight, initialAtlasYForDeserialisedPass, pixels_buffer.get());
-
-		atlasCursor.y += cachedHeight + ATLAS_PADDING;
-
 		size_t num_chars{};
 		file.read(reinterpret_cast<char*>(&num_chars), sizeof(size_t));
 
+		uint16_t font = InternFontPath(outAtlas.range.fontPath);
 		for (size_t i = 0; i < num_chars; i++)
 		{
 			char32_t charCode{};
-			Character character{};
+			float advance{};
 			file.read(reinterpret_cast<char*>(&charCode), sizeof(char32_t));
-			file.read(reinterpret_cast<char*>(&character.pos.x), sizeof(uint16_t));
-			file.read(reinterpret_cast<char*>(&character.pos.y), sizeof(uint16_t));
-			file.read(reinterpret_cast<char*>(&character.size.x), sizeof(uint16_t));
-			file.read(reinterpret_cast<char*>(&character.size.y), sizeof(uint16_t));
-			file.read(reinterpret_cast<char*>(&character.bearing.x), sizeof(float));
-			file.read(reinterpret_cast<char*>(&character.bearing.y), sizeof(float));
-			file.read(reinterpret_cast<char*>(&character.advance), sizeof(float));
-			file.read(reinterpret_cast<char*>(&character.layer), sizeof(uint16_t));
-
-			character.pos.y = character.pos.y + initialAtlasYForDeserialisedPass;
-			character.layer = static_cast<uint16_t>(character.pos.y / ATLAS_HEIGHT);
-
-			char_t key = { charCode, outAtlas.fontSize, currentFontType };
-			characters[key] = character;
+			file.read(reinterpret_cast<char*>(&advance), sizeof(float));
+
+			if (!file)
+			{
+				SableUI_Error("Error reading glyph metrics from cache file: %s", filename.c_str());
+				file.close();
+				std::filesystem::remove(filename);
+				return false;
+			}
+
+			Character& character = characters[{ charCode, outAtlas.fontSize, currentFontType }];
+			character.advance = advance;
+			character.font = font;
 		}
 
 		file.close();
@@ -1522,445 +1917,776 @@ void FontManager::LoadFontRange(Atlas& atlas, const SableUI::FontRange& range)
 
 	if (!loadedFromCache)
 	{
-		RenderGlyphs(atlas);
+		LoadRangeMetrics(atlas);
 	}
 
 	atlases.emplace_back(atlas);
 	loadedAtlasKeys.insert(currentAtlasKey);
 }
 
-// ============================================================================
-// Font Rendering
-// ============================================================================
-struct TextToken {
-	SableString content;
-	float width = 0.0f;
-	bool isSpace = false;
-	bool isNewline = false;
-	std::vector<Character> charDataList;
-};
-
-void FontManager::GetTextVertexData(
-	const SableUI::_Text* text,
-	std::vector<TextVertex>& outVertices,
-	std::vector<uint32_t>& outIndices,
-	int& outHeight,
-	int& outActualLineWidth)
+const Character* FontManager::GetGlyph(const char_t& key)
 {
-	SableUI::TextJustification currentJustification = text->m_justify;
+	if (const Character* glyph = characters.Find(key))
+		return glyph;
 
-	std::vector<TextVertex> vertices;
-	std::vector<unsigned int> indices;
-	int height = 0;
+	// ranges load into the current style's atlas, callers laying out on their
+	// own style state may not have set it
+	FontType previousType = currentFontType;
+	currentFontType = key.fontType;
 
-	std::vector<TextToken> tokens;
-	TextToken currentToken;
+	SableUI::FontRange targetRange;
+	if (FindFontRangeForChar(key.c, targetRange))
+	{
+		Atlas newAtlas{};
+		newAtlas.fontSize = key.fontSize;
+		LoadFontRange(newAtlas, targetRange);
+	}
+
+	currentFontType = previousType;
+	return characters.Find(key);
+}
+
+float FontManager::GetAdvance(char32_t c, int fontSize, FontType fontType)
+{
+	const Character* glyph = GetGlyph({ c, fontSize, fontType });
+	return glyph != nullptr ? glyph->advance : 0.0f;
+}
 
-	currentFontType = FontType::Regular;
+bool FontManager::NextToken(const char32_t* text, uint32_t length, uint32_t& pos, int fontSize,
+	FontType& style, TextToken& outToken, float* outAdvances)
+{
+	outToken = TextToken{};
+	bool open = false;
 
-	/* tokenisation with style tracking */
-	for (char32_t c : text->m_content)
+	for (; pos < length; pos++)
 	{
+		char32_t c = text[pos];
 		if (IsNonPrintableChar(c)) continue;
+		if (GetStyleTagType(c, style)) continue;
 
-		if (SetStyleChar(c))
+		if (c == U'\n')
 		{
-			if (!currentToken.content.empty())
-			{
-				tokens.push_back(currentToken);
-				currentToken = TextToken{};
-			}
-			continue;
+			if (open) break;
+
+			outToken.begin = pos;
+			outToken.end = ++pos;
+			outToken.isNewline = true;
+			outToken.fontType = style;
+			return true;
 		}
 
-		if (c == U'\n')
+		bool isSpace = std::iswspace(static_cast<wint_t>(c)) != 0;
+		if (open && outToken.isSpace != isSpace)
+			break;
+
+		if (!open)
 		{
-			if (!currentToken.content.empty())
-				tokens.push_back(currentToken);
+			outToken.begin = pos;
+			outToken.isSpace = isSpace;
+			outToken.fontType = style;
+			open = true;
+		}
+
+		// glyphs are keyed by style, a hit is always from the current style's atlas
+		float advance = GetAdvance(c, fontSize, style);
+		if (outAdvances) outAdvances[pos] = advance;
+		outToken.width += advance;
+	}
+
+	outToken.end = pos;
+	return open;
+}
+
+static size_t HashShapedLine(const char32_t* text, uint32_t length, int fontSize, FontType style)
+{
+	size_t h = std::hash<std::u32string_view>()(std::u32string_view(text, length));
+	h ^= ((static_cast<size_t>(fontSize) << 8) | static_cast<size_t>(style)) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+	return h;
+}
 
-			TextToken newlineToken;
-			newlineToken.isNewline = true;
-			tokens.push_back(newlineToken);
-			currentToken = TextToken{};
+std::shared_ptr<const ShapedLine> FontManager::GetShapedLine(const char32_t* text, uint32_t length, int fontSize, FontType style)
+{
+	size_t hash = HashShapedLine(text, length, fontSize, style);
+	auto range = m_lineIndex.equal_range(hash);
+	for (auto it = range.first; it != range.second; it++)
+	{
+		const ShapedLine& cached = **it->second;
+		if (cached.fontSize != fontSize || cached.startStyle != style || cached.text.size() != length ||
+			!std::equal(cached.text.begin(), cached.text.end(), text))
 			continue;
-		}
 
-		Character charData;
-		char_t charKey = { c, text->m_fontSize, currentFontType };
+		m_paragraphHits++;
+		m_lineOrder.splice(m_lineOrder.begin(), m_lineOrder, it->second);
+		return *it->second;
+	}
 
-		auto it = characters.find(charKey);
-		bool needsReload = false;
+	m_paragraphMisses++;
 
-		if (it != characters.end())
-		{
-			std::string currentFontDir = GetCurrentFontDirectory();
-			bool foundInStyle = false;
+	auto shaped = std::make_shared<ShapedLine>();
+	shaped->text.assign(text, length);
+	shaped->fontSize = fontSize;
+	shaped->startStyle = style;
+	shaped->advances.assign(length, 0.0f);
+	shaped->hash = hash;
 
-			for (const auto& atlas : atlases)
-			{
-				if (atlas.fontSize == text->m_fontSize &&
-					atlas.range.fontPath.find(currentFontDir) != std::string::npos)
-				{
-					if (c >= atlas.range.start && c <= atlas.range.end)
-					{
-						foundInStyle = true;
-						break;
-					}
-				}
-			}
+	uint32_t pos = 0;
+	TextToken token;
+	while (NextToken(text, length, pos, fontSize, style, token, shaped->advances.data()))
+	{
+		shaped->runs.push_back(token);
+		if (token.isNewline) continue;
 
-			if (!foundInStyle)
-				needsReload = true;
-			else
-				charData = it->second;
-		}
-		else
-			needsReload = true;
+		if (!token.isSpace)
+			shaped->widestWord = std::max(shaped->widestWord, token.width);
 
-		if (needsReload)
-		{
-			SableUI::FontRange targetRange;
-			if (FindFontRangeForChar(c, targetRange))
-			{
-				Atlas newAtlas{};
-				newAtlas.fontSize = text->m_fontSize;
-				LoadFontRange(newAtlas, targetRange);
+		shaped->width += token.width;
+	}
 
-				it = characters.find(charKey);
-				if (it != characters.end())
-					charData = it->second;
-				else
-				{
-					charData = Character{};
-				}
-			}
-			else
-			{
-				charData = Character{};
-			}
-		}
+	shaped->endStyle = style;
+	shaped->runs.shrink_to_fit();
+	shaped->bytes = sizeof(ShapedLine) + length * (sizeof(char32_t) + sizeof(float)) +
+		shaped->runs.size() * sizeof(TextToken);
 
-		if (std::iswspace(static_cast<wint_t>(c)))
-		{
-			if (!currentToken.content.empty() && !currentToken.isSpace)
-			{
-				tokens.push_back(currentToken);
-				currentToken = TextToken{};
-			}
-			if (currentToken.content.empty() || !currentToken.isSpace)
-				currentToken.isSpace = true;
+	m_lineOrder.push_front(shaped);
+	m_lineIndex.emplace(hash, m_lineOrder.begin());
+	m_lineBytes += shaped->bytes;
+	TrimShapedLines();
 
-			currentToken.content.push_back(c);
-			currentToken.width += charData.advance;
-			currentToken.charDataList.push_back(charData);
+	return shaped;
+}
+
+void FontManager::TrimShapedLines()
+{
+	// lines a paragraph still holds are in use, they move to the front and the walk goes on
+	size_t remaining = m_lineOrder.size();
+	while (m_lineBytes > SHAPED_LINE_BUDGET && remaining-- > 0)
+	{
+		auto last = std::prev(m_lineOrder.end());
+		if (last->use_count() > 1)
+		{
+			m_lineOrder.splice(m_lineOrder.begin(), m_lineOrder, last);
+			continue;
 		}
-		else
+
+		auto range = m_lineIndex.equal_range((*last)->hash);
+		for (auto it = range.first; it != range.second; it++)
 		{
-			if (!currentToken.content.empty() && currentToken.isSpace)
-			{
-				tokens.push_back(currentToken);
-				currentToken = TextToken{};
-			}
-			currentToken.isSpace = false;
-			currentToken.content.push_back(c);
-			currentToken.width += charData.advance;
-			currentToken.charDataList.push_back(charData);
+			if (it->second != last) continue;
+			m_lineIndex.erase(it);
+			break;
 		}
+
+		m_lineBytes -= (*last)->bytes;
+		m_lineOrder.erase(last);
 	}
+}
 
-	if (!currentToken.content.empty())
-		tokens.push_back(currentToken);
+std::shared_ptr<const SableUI::ShapedParagraph> FontManager::GetParagraph(const SableString& text, int fontSize,
+	const SableUI::ShapedParagraph* previous)
+{
+	using Line = SableUI::ShapedParagraph::Line;
 
-	SableUI::vec2 cursor{};
-	currentFontType = FontType::Regular;
+	auto shaped = std::make_shared<SableUI::ShapedParagraph>();
+	shaped->text = text;
+	shaped->fontSize = fontSize;
 
-	std::vector<std::vector<TextToken>> lines;
-	std::vector<TextToken> currentLine;
-	float currentLineWidth = 0.0f;
-	int totalLines = 1;
+	const char32_t* source = text.begin();
+	uint32_t length = static_cast<uint32_t>(text.size());
 
-	int maxVisibleLines = (text->m_maxHeight != 0)
-		? std::max(1, text->m_maxHeight / text->m_lineSpacingPx)
-		: INT_MAX;
+	if (previous != nullptr && previous->fontSize != fontSize)
+		previous = nullptr;
 
-	bool truncated = false;
+	// the edit is whatever lies between the common prefix and suffix, lines outside it are kept
+	size_t frontLines = 0;
+	size_t backFirst = 0;
+	size_t backLast = 0;
+	int64_t delta = 0;
 
-	for (const TextToken& token : tokens)
+	if (previous != nullptr)
 	{
-		if (token.isNewline)
-		{
-			lines.push_back(currentLine);
-			currentLine.clear();
-			currentLineWidth = 0;
-			totalLines++;
+		const std::vector<Line>& old = previous->lines;
+		const char32_t* oldText = previous->text.begin();
+		uint32_t oldLength = static_cast<uint32_t>(previous->text.size());
+		uint32_t shorter = std::min(oldLength, length);
+		delta = static_cast<int64_t>(length) - static_cast<int64_t>(oldLength);
+
+		uint32_t prefix = static_cast<uint32_t>(std::mismatch(oldText, oldText + shorter, source).first - oldText);
+		uint32_t suffix = 0;
+		while (suffix < shorter - prefix && oldText[oldLength - 1 - suffix] == source[length - 1 - suffix])
+			suffix++;
+
+		frontLines = static_cast<size_t>(std::partition_point(old.begin(), old.end(),
+			[&](const Line& line) { return line.end <= prefix; }) - old.begin());
+
+		// a last line without a newline only matches while nothing follows it
+		if (frontLines > 0 && frontLines == old.size() && !old.back().shaped->EndsParagraph() && old.back().end != length)
+			frontLines--;
+
+		// a line after the edit needs the newline before it unchanged too
+		backFirst = static_cast<size_t>(std::partition_point(old.begin() + frontLines, old.end(),
+			[&](const Line& line) { return line.begin < oldLength - suffix + 1; }) - old.begin());
+		backLast = old.size();
+
+		shaped->lines.reserve(old.size() + 1);
+		shaped->lines.insert(shaped->lines.end(), old.begin(), old.begin() + frontLines);
+	}
+
+	FontType style = shaped->lines.empty() ? FontType::Regular : shaped->lines.back().shaped->endStyle;
+	auto append = [&](uint32_t begin, std::shared_ptr<const ShapedLine> line) {
+		uint32_t end = begin + static_cast<uint32_t>(line->text.size());
+		style = line->endStyle;
+		shaped->lines.push_back({ begin, end, line->widestWord, line->width, std::move(line) });
+	};
+
+	uint32_t pos = shaped->lines.empty() ? 0 : shaped->lines.back().end;
+	uint32_t middleEnd = backFirst < backLast
+		? static_cast<uint32_t>(previous->lines[backFirst].begin + delta)
+		: length;
+
+	while (pos < middleEnd)
+	{
+		const char32_t* newline = std::find(source + pos, source + middleEnd, U'\n');
+		uint32_t end = static_cast<uint32_t>(newline - source) + (newline != source + middleEnd ? 1 : 0);
 
-			if (totalLines > maxVisibleLines)
-			{
-				truncated = true;
-				break;
-			}
+		append(pos, GetShapedLine(source + pos, end - pos, fontSize, style));
+		pos = end;
+	}
+
+	// a style tag in the edit carries on until a line starts the way it did before
+	for (size_t i = backFirst; i < backLast; i++)
+	{
+		const Line& line = previous->lines[i];
+		uint32_t begin = static_cast<uint32_t>(line.begin + delta);
+
+		if (line.shaped->startStyle != style)
+		{
+			append(begin, GetShapedLine(source + begin, line.end - line.begin, fontSize, style));
 			continue;
 		}
 
-		if (!token.isSpace && text->m_maxWidth > 0 &&
-			currentLineWidth > 0 &&
-			(currentLineWidth + token.width > text->m_maxWidth))
+		size_t first = shaped->lines.size();
+		shaped->lines.insert(shaped->lines.end(), previous->lines.begin() + i, previous->lines.begin() + backLast);
+		for (size_t j = first; j < shaped->lines.size(); j++)
 		{
-			lines.push_back(currentLine);
-			currentLine.clear();
-			currentLineWidth = 0;
-			totalLines++;
-
-			if (totalLines > maxVisibleLines)
-			{
-				truncated = true;
-				break;
-			}
+			shaped->lines[j].begin = static_cast<uint32_t>(shaped->lines[j].begin + delta);
+			shaped->lines[j].end = static_cast<uint32_t>(shaped->lines[j].end + delta);
 		}
-
-		currentLine.push_back(token);
-		currentLineWidth += token.width;
+		break;
 	}
 
-	if (!truncated)
-		lines.push_back(currentLine);
-
-	if (truncated && !lines.empty())
+	for (const Line& line : shaped->lines)
 	{
-		std::vector<TextToken>& lastLine = lines.back();
-
-		std::u32string ellipsis = U"...";
-		TextToken ellipsisToken;
-		ellipsisToken.isSpace = false;
+		shaped->widestWord = std::max(shaped->widestWord, line.widestWord);
+		shaped->widestLine = std::max(shaped->widestLine, line.width);
+	}
 
-		for (char32_t c : ellipsis)
-		{
-			char_t charKey = { c, text->m_fontSize, FontType::Regular };
-			auto it = characters.find(charKey);
-			if (it == characters.end())
-			{
-				SableUI::FontRange targetRange;
-				if (FindFontRangeForChar(c, targetRange))
-				{
-					Atlas newAtlas{};
-					newAtlas.fontSize = text->m_fontSize;
-					LoadFontRange(newAtlas, targetRange);
-					it = characters.find(charKey);
-				}
-			}
+	shaped->hardLines = static_cast<int>(shaped->lines.size());
+	if (shaped->lines.empty() || shaped->lines.back().shaped->EndsParagraph())
+		shaped->hardLines++;
 
-			Character charData{};
-			if (it != characters.end())
-				charData = it->second;
+	return shaped;
+}
 
-			ellipsisToken.content.push_back(c);
-			ellipsisToken.width += charData.advance;
-			ellipsisToken.charDataList.push_back(charData);
-		}
+SableUI::ParagraphCacheStats FontManager::GetParagraphStats() const
+{
+	SableUI::ParagraphCacheStats stats;
+	stats.hits = m_paragraphHits;
+	stats.misses = m_paragraphMisses;
+	stats.lines = m_lineOrder.size();
+	stats.bytes = m_lineBytes;
+	stats.budget = SHAPED_LINE_BUDGET;
+	return stats;
+}
 
-		float lineWidth = 0.0f;
-		for (auto& t : lastLine)
-			lineWidth += t.width;
+// ============================================================================
+// Text Layout
+// ============================================================================
+bool SableUI::TextLayout::Update(const SableString& text, int fontSize, int maxWidth)
+{
+	FontManager& fm = FontManager::GetInstance();
+	if (!fm.isInitialized) fm.Initialise();
 
-		while (!lastLine.empty() && lineWidth + ellipsisToken.width > text->m_maxWidth)
-		{
-			TextToken& back = lastLine.back();
-			lineWidth -= back.width;
-			lastLine.pop_back();
-		}
+	const char32_t* oldText = std::as_const(m_source).begin(); // non const begin() unshares
+	const char32_t* newText = text.begin();
+	size_t oldLength = m_source.size();
+	size_t newLength = text.size();
 
-		lastLine.push_back(ellipsisToken);
+	bool sameShape = m_valid && fontSize == m_fontSize && maxWidth == m_maxWidth;
 
-		while ((int)lines.size() > maxVisibleLines)
-			lines.pop_back();
+	// strings share their buffer until one is written to, same buffer is same text
+	if (sameShape && oldText == newText && oldLength == newLength)
+	{
+		m_rewrappedLines = 0;
+		return false;
 	}
 
-	height = static_cast<int>(lines.size()) * text->m_lineSpacingPx;
-	cursor.y -= height;
+	// the edit is whatever lies between the common prefix and suffix
+	size_t shorter = std::min(oldLength, newLength);
+	size_t prefix = 0;
+	if (sameShape)
+		while (prefix < shorter && oldText[prefix] == newText[prefix]) prefix++;
 
-	float maxActualLineWidth = 0.0f;
-	for (const auto& line : lines)
+	if (sameShape && prefix == oldLength && oldLength == newLength)
 	{
-		float lineWidth = 0.0f;
-		for (const auto& token : line)
-			lineWidth += token.width;
-		maxActualLineWidth = std::max(maxActualLineWidth, lineWidth);
+		m_rewrappedLines = 0;
+		return false;
 	}
 
-	unsigned int currentGlyphOffset = 0;
+	size_t suffix = 0;
+	if (sameShape)
+		while (suffix < shorter - prefix && oldText[oldLength - 1 - suffix] == newText[newLength - 1 - suffix])
+			suffix++;
 
-	for (const auto& line : lines)
+	// an edit can pull the first word of its line back onto the line before
+	size_t firstLine = 0;
+	if (sameShape)
+	{
+		firstLine = GetLineOfIndex(prefix);
+		if (firstLine > 0) firstLine--;
+	}
+	else
 	{
-		float lineWidth = 0.0f;
-		for (const auto& token : line)
-			lineWidth += token.width;
+		m_lines.clear();
+		m_caretX.clear();
+	}
 
-		float xOffset = 0.0f;
-		if (text->m_maxWidth > 0)
-		{
-			switch (currentJustification)
-			{
-			case SableUI::TextJustification::Center:
-				xOffset = (text->m_maxWidth - lineWidth) / 2.0f;
-				break;
-			case SableUI::TextJustification::Right:
-				xOffset = (text->m_maxWidth - lineWidth);
-				break;
-			default:
-				break;
-			}
-		}
+	m_source = text;
+	m_fontSize = fontSize;
+	m_maxWidth = maxWidth;
+	m_valid = true;
 
-		cursor.x = xOffset;
+	Rewrap(firstLine, static_cast<uint32_t>(newLength - suffix),
+		static_cast<int64_t>(newLength) - static_cast<int64_t>(oldLength), sameShape);
+	return true;
+}
 
-		for (const auto& token : line)
-		{
-			for (size_t i = 0; i < token.content.size(); i++)
-			{
-				const Character& charData = token.charDataList[i];
+void SableUI::TextLayout::Rewrap(size_t firstLine, uint32_t editEnd, int64_t delta, bool canResync)
+{
+	FontManager& fm = FontManager::GetInstance();
 
-				float x = std::round(cursor.x + charData.bearing.x);
-				float y = std::round(cursor.y - charData.bearing.y + static_cast<float>(text->m_fontSize));
+	const char32_t* text = std::as_const(m_source).begin();
+	uint32_t length = static_cast<uint32_t>(m_source.size());
 
-				float w = static_cast<float>(charData.size.x);
-				float h = static_cast<float>(charData.size.y);
+	uint32_t start = firstLine < m_lines.size() ? m_lines[firstLine].begin : 0;
+	FontType style = firstLine < m_lines.size() ? static_cast<FontType>(m_lines[firstLine].style) : FontType::Regular;
 
-				float uBottomLeft = static_cast<float>(charData.pos.x) / ATLAS_WIDTH;
-				float vBottomLeft = static_cast<float>(charData.pos.y % ATLAS_HEIGHT) / ATLAS_HEIGHT;
+	std::vector<TextLine> newLines;
+	std::vector<float> newCaretX;
 
-				float uTopRight = uBottomLeft + (static_cast<float>(charData.size.x) / ATLAS_WIDTH);
-				float vTopRight = vBottomLeft + (static_cast<float>(charData.size.y) / ATLAS_HEIGHT);
+	TextLine line{ start, start, 0.0f, static_cast<uint8_t>(style) };
+	uint32_t filled = start;
+	size_t resyncLine = SIZE_MAX;
 
-				float layerIndex = static_cast<float>(charData.layer);
+	// caret x for chars between tokens, style tags and the like
+	auto fill = [&](uint32_t upTo) {
+		for (; filled < upTo; filled++)
+			newCaretX.push_back(line.width);
+	};
 
-				vertices.push_back(TextVertex{ {x, y}, {uBottomLeft, vBottomLeft, layerIndex}, text->m_colour });
-				vertices.push_back(TextVertex{ {x + w, y}, {uTopRight, vBottomLeft, layerIndex}, text->m_colour });
-				vertices.push_back(TextVertex{ {x + w, y + h}, {uTopRight, vTopRight, layerIndex}, text->m_colour });
-				vertices.push_back(TextVertex{ {x, y + h}, {uBottomLeft, vTopRight, layerIndex}, text->m_colour });
+	// true once the next line starts where an old one did, the rest is unchanged
+	auto endLine = [&](uint32_t end, uint32_t nextBegin, FontType nextStyle) {
+		line.end = end;
+		newLines.push_back(line);
+		line = TextLine{ nextBegin, nextBegin, 0.0f, static_cast<uint8_t>(nextStyle) };
 
-				unsigned int offset = currentGlyphOffset * 4;
-				indices.push_back(offset);
-				indices.push_back(offset + 1);
-				indices.push_back(offset + 2);
-				indices.push_back(offset);
-				indices.push_back(offset + 2);
-				indices.push_back(offset + 3);
+		if (!canResync || nextBegin < editEnd) return false;
 
-				cursor.x += charData.advance;
-				currentGlyphOffset++;
-			}
+		int64_t oldBegin = static_cast<int64_t>(nextBegin) - delta;
+		auto it = std::lower_bound(m_lines.begin() + firstLine, m_lines.end(), oldBegin,
+			[](const TextLine& l, int64_t begin) { return static_cast<int64_t>(l.begin) < begin; });
+
+		if (it == m_lines.end() || static_cast<int64_t>(it->begin) != oldBegin || it->style != line.style)
+			return false;
+
+		resyncLine = static_cast<size_t>(it - m_lines.begin());
+		return true;
+	};
+
+	// a full layout wraps the shaped runs, an edit tokenises from its line on
+	std::shared_ptr<const ShapedParagraph> shaped;
+	if (!canResync) shaped = fm.GetParagraph(m_source, m_fontSize);
+	size_t nextLine = 0;
+	size_t nextRun = 0;
+	const ShapedLine* runLine = nullptr;
+	uint32_t runBase = 0;
+	uint32_t pos = start;
+
+	auto nextToken = [&](TextToken& outToken) {
+		if (!shaped)
+			return fm.NextToken(text, length, pos, m_fontSize, style, outToken);
+
+		while (runLine == nullptr || nextRun >= runLine->runs.size())
+		{
+			if (nextLine >= shaped->lines.size()) return false;
+			runBase = shaped->lines[nextLine].begin;
+			runLine = shaped->lines[nextLine++].shaped.get();
+			nextRun = 0;
 		}
-		cursor.y += text->m_lineSpacingPx;
-	}
 
-	outVertices = vertices;
-	outIndices = indices;
-	outHeight = height;
-	outActualLineWidth = static_cast<int>(std::ceil(maxActualLineWidth));
-}
+		outToken = runLine->runs[nextRun++];
+		outToken.begin += runBase;
+		outToken.end += runBase;
+		return true;
+	};
 
-int FontManager::GetMinWidth(SableUI::_Text* text, bool wrapped)
-{
-	if (wrapped)
+	TextToken token;
+	while (nextToken(token))
 	{
-		int maxWordWidth = 0;
-		int currentWordWidth = 0;
-		currentFontType = FontType::Regular;
+		fill(token.begin);
 
-		for (char32_t c : text->m_content)
+		if (token.isNewline)
 		{
-			if (IsNonPrintableChar(c)) continue;
+			fill(token.end);
+			if (endLine(token.begin, token.end, token.fontType)) break;
+			continue;
+		}
 
-			if (c == U' ' || c == U'\n' || c == U'\t')
-			{
-				maxWordWidth = std::max(maxWordWidth, currentWordWidth);
-				currentWordWidth = 0;
-				continue;
-			}
+		if (!token.isSpace && m_maxWidth > 0 &&
+			line.width > 0 &&
+			(line.width + token.width > m_maxWidth))
+		{
+			if (endLine(token.begin, token.begin, token.fontType)) break;
+		}
 
-			SetStyleChar(c);
+		FontType charStyle = token.fontType;
+		for (uint32_t i = token.begin; i < token.end; i++)
+		{
+			newCaretX.push_back(line.width);
 
-			char_t charKey = { c, text->m_fontSize, currentFontType };
-			auto it = characters.find(charKey);
+			char32_t c = text[i];
+			if (IsNonPrintableChar(c) || GetStyleTagType(c, charStyle)) continue;
+			line.width += shaped ? runLine->advances[i - runBase] : fm.GetAdvance(c, m_fontSize, charStyle);
+		}
+		filled = token.end;
+	}
 
-			if (it != characters.end())
-			{
-				currentWordWidth += it->second.advance;
-			}
-			else
-			{
-				SableUI::FontRange targetRange;
-				if (FindFontRangeForChar(c, targetRange))
-				{
-					Atlas newAtlas{};
-					newAtlas.fontSize = text->m_fontSize;
-					LoadFontRange(newAtlas, targetRange);
-					auto newIt = characters.find(charKey);
-					if (newIt != characters.end())
-					{
-						currentWordWidth += newIt->second.advance;
-					}
-				}
-			}
+	m_rewrappedLines = newLines.size();
+
+	if (resyncLine != SIZE_MAX)
+	{
+		uint32_t oldResume = static_cast<uint32_t>(static_cast<int64_t>(line.begin) - delta);
+
+		for (size_t i = resyncLine; i < m_lines.size(); i++)
+		{
+			m_lines[i].begin = static_cast<uint32_t>(m_lines[i].begin + delta);
+			m_lines[i].end = static_cast<uint32_t>(m_lines[i].end + delta);
 		}
 
-		currentFontType = FontType::Regular;
-		return std::max(maxWordWidth, currentWordWidth);
+		m_lines.erase(m_lines.begin() + firstLine, m_lines.begin() + resyncLine);
+		m_lines.insert(m_lines.begin() + firstLine, newLines.begin(), newLines.end());
+
+		m_caretX.erase(m_caretX.begin() + start, m_caretX.begin() + oldResume);
+		m_caretX.insert(m_caretX.begin() + start, newCaretX.begin(), newCaretX.end());
+		return;
 	}
-	else
+
+	fill(length);
+	newCaretX.push_back(line.width);
+	line.end = length;
+	newLines.push_back(line);
+	m_rewrappedLines = newLines.size();
+
+	m_lines.resize(firstLine);
+	m_lines.insert(m_lines.end(), newLines.begin(), newLines.end());
+	m_caretX.resize(start);
+	m_caretX.insert(m_caretX.end(), newCaretX.begin(), newCaretX.end());
+}
+
+void SableUI::TextLayout::Invalidate()
+{
+	m_valid = false;
+	m_lines.clear();
+	m_caretX.clear();
+	m_source.clear();
+}
+
+size_t SableUI::TextLayout::GetLineOfIndex(size_t index) const
+{
+	auto it = std::upper_bound(m_lines.begin(), m_lines.end(), index,
+		[](size_t i, const TextLine& line) { return i < line.begin; });
+
+	return it == m_lines.begin() ? 0 : static_cast<size_t>(it - m_lines.begin()) - 1;
+}
+
+float SableUI::TextLayout::GetCaretX(size_t index) const
+{
+	if (m_caretX.empty()) return 0.0f;
+	return m_caretX[std::min(index, m_caretX.size() - 1)];
+}
+
+size_t SableUI::TextLayout::GetIndexAt(size_t line, float x) const
+{
+	if (m_lines.empty()) return 0;
+	line = std::min(line, m_lines.size() - 1);
+
+	// a wrapped line's end is the next line's start, the caret there belongs below
+	const TextLine& l = m_lines[line];
+	size_t first = l.begin;
+	size_t last = l.end;
+	if (line + 1 < m_lines.size() && m_lines[line + 1].begin == l.end && last > first)
+		last--;
+
+	auto begin = m_caretX.begin() + first;
+	auto end = m_caretX.begin() + last + 1;
+	auto it = std::lower_bound(begin, end, x);
+
+	if (it == end) return last;
+	if (it != begin && x - *(it - 1) < *it - x) it--;
+	return static_cast<size_t>(it - m_caretX.begin());
+}
+
+// ============================================================================
+// Font Rendering
+// ============================================================================
+// a line as drawn, the last visible one may end early to fit the ellipsis
+struct DrawnLine {
+	uint32_t begin = 0;
+	uint32_t end = 0;
+	float width = 0.0f;
+	FontType fontType = FontType::Regular;
+	bool ellipsis = false;
+	float ellipsisX = 0.0f;
+};
+
+/* per thread scratch for GetTextVertexData, cleared but never shrunk so a
+ * layout no larger than an earlier one allocates nothing */
+struct TextLayoutScratch {
+	std::vector<TextToken> tokens;
+	std::vector<DrawnLine> lines;
+	std::vector<char_t> drawnKeys;
+};
+
+static thread_local TextLayoutScratch s_layoutScratch;
+static const char32_t s_ellipsis[] = U"...";
+
+void FontManager::LayoutDrawnLines(const SableUI::_Text* text, std::vector<DrawnLine>& outLines)
+{
+	std::vector<TextToken>& tokens = s_layoutScratch.tokens;
+	outLines.clear();
+
+	// line breaks come from the text's own layout, only the edited lines are wrapped again
+	SableUI::TextLayout& layout = text->m_layout;
+	layout.Update(text->m_content, text->m_fontSize, text->m_maxWidth);
+
+	const char32_t* source = text->m_content.begin();
+
+	int maxVisibleLines = (text->m_maxHeight != 0)
+		? std::max(1, text->m_maxHeight / text->m_lineSpacingPx)
+		: INT_MAX;
+
+	size_t visibleLines = std::min(layout.GetLineCount(), static_cast<size_t>(maxVisibleLines));
+	bool truncated = layout.GetLineCount() > visibleLines;
+
+	for (size_t i = 0; i < visibleLines; i++)
 	{
-		int totalWidth = 0;
-		currentFontType = FontType::Regular;
+		const SableUI::TextLine& line = layout.GetLine(i);
+		outLines.push_back({ line.begin, line.end, line.width, static_cast<FontType>(line.style) });
+	}
+
+	if (truncated && !outLines.empty())
+	{
+		DrawnLine& lastLine = outLines.back();
 
-		for (char32_t c : text->m_content)
+		float ellipsisWidth = 0.0f;
+		for (uint32_t i = 0; i < 3; i++)
+			ellipsisWidth += GetAdvance(s_ellipsis[i], text->m_fontSize, FontType::Regular);
+
+		// the line's tokens again, dropped from the end until the ellipsis fits
+		tokens.clear();
+		uint32_t pos = lastLine.begin;
+		FontType style = lastLine.fontType;
+		TextToken token;
+		while (NextToken(source, lastLine.end, pos, text->m_fontSize, style, token))
+			tokens.push_back(token);
+
+		while (!tokens.empty() && lastLine.width + ellipsisWidth > text->m_maxWidth)
 		{
-			if (IsNonPrintableChar(c)) continue;
-			if (c == U'\n') continue;
+			lastLine.width -= tokens.back().width;
+			tokens.pop_back();
+		}
+
+		lastLine.end = tokens.empty() ? lastLine.begin : tokens.back().end;
+		lastLine.ellipsis = true;
+		lastLine.ellipsisX = lastLine.width;
+		lastLine.width += ellipsisWidth;
+	}
+}
+
+void FontManager::MeasureTextLayout(const SableUI::_Text* text, int& outHeight, int& outActualLineWidth)
+{
+	std::vector<DrawnLine>& lines = s_layoutScratch.lines;
+	LayoutDrawnLines(text, lines);
+
+	float maxActualLineWidth = 0.0f;
+	for (const DrawnLine& line : lines)
+		maxActualLineWidth = std::max(maxActualLineWidth, line.width);
+
+	outHeight = static_cast<int>(lines.size()) * text->m_lineSpacingPx;
+	outActualLineWidth = static_cast<int>(std::ceil(maxActualLineWidth));
+}
 
-			SetStyleChar(c);
+void FontManager::GetTextVertexData(
+	const SableUI::_Text* text,
+	std::vector<TextVertex>& outVertices,
+	std::vector<uint32_t>& outIndices,
+	int& outHeight,
+	int& outActualLineWidth,
+	uint64_t& outAtlasLayers)
+{
+	SableUI::TextJustification currentJustification = text->m_justify;
+
+	TextLayoutScratch& scratch = s_layoutScratch;
+	std::vector<DrawnLine>& lines = scratch.lines;
+
+	outVertices.clear();
+	outIndices.clear();
+
+	int height = 0;
+	uint64_t atlasLayers = 0;
+
+	LayoutDrawnLines(text, lines);
+
+	const SableUI::TextLayout& layout = text->m_layout;
+	const char32_t* source = text->m_content.begin();
+
+	height = static_cast<int>(lines.size()) * text->m_lineSpacingPx;
+
+	SableUI::vec2 cursor{};
+	cursor.y -= height;
 
-			char_t charKey = { c, text->m_fontSize, currentFontType };
-			auto it = characters.find(charKey);
+	// visits every printable char of a line with its style and x, the ellipsis last
+	auto forEachChar = [&](const DrawnLine& line, auto&& fn) {
+		FontType style = line.fontType;
+		for (uint32_t i = line.begin; i < line.end; i++)
+		{
+			char32_t c = source[i];
+			if (IsNonPrintableChar(c) || GetStyleTagType(c, style)) continue;
+			fn(c, style, layout.GetCaretX(i));
+		}
 
-			if (it != characters.end())
+		if (line.ellipsis)
+		{
+			float x = line.ellipsisX;
+			for (uint32_t i = 0; i < 3; i++)
 			{
-				totalWidth += it->second.advance;
+				fn(s_ellipsis[i], FontType::Regular, x);
+				x += GetAdvance(s_ellipsis[i], text->m_fontSize, FontType::Regular);
 			}
-			else
+		}
+	};
+
+	float maxActualLineWidth = 0.0f;
+	for (const DrawnLine& line : lines)
+		maxActualLineWidth = std::max(maxActualLineWidth, line.width);
+
+	// only glyphs left after wrapping and truncation are rasterised
+	std::vector<char_t>& drawnKeys = scratch.drawnKeys;
+	drawnKeys.clear();
+
+	for (const DrawnLine& line : lines)
+	{
+		forEachChar(line, [&](char32_t c, FontType style, float) {
+			if (!std::iswspace(static_cast<wint_t>(c)))
+				drawnKeys.push_back({ c, text->m_fontSize, style });
+		});
+	}
+
+	RasteriseGlyphs(drawnKeys);
+
+	bool sdf = renderMode == SableUI::GlyphRenderMode::SDF;
+	int drawnSize = sdf ? SDF_GLYPH_KEY_SIZE : text->m_fontSize;
+	float glyphScale = sdf ? static_cast<float>(text->m_fontSize) / SableUI::SDF_REFERENCE_SIZE : 1.0f;
+
+	for (const DrawnLine& line : lines)
+	{
+		float xOffset = 0.0f;
+		if (text->m_maxWidth > 0)
+		{
+			switch (currentJustification)
 			{
-				SableUI::FontRange targetRange;
-				if (FindFontRangeForChar(c, targetRange))
-				{
-					Atlas newAtlas{};
-					newAtlas.fontSize = text->m_fontSize;
-					LoadFontRange(newAtlas, targetRange);
-					auto newIt = characters.find(charKey);
-					if (newIt != characters.end())
-					{
-						totalWidth += newIt->second.advance;
-					}
-				}
+			case SableUI::TextJustification::Center:
+				xOffset = (text->m_maxWidth - line.width) / 2.0f;
+				break;
+			case SableUI::TextJustification::Right:
+				xOffset = (text->m_maxWidth - line.width);
+				break;
+			default:
+				break;
 			}
 		}
 
-		currentFontType = FontType::Regular;
-		return totalWidth;
+		forEachChar(line, [&](char32_t c, FontType style, float caretX) {
+			// placement in the atlas comes from the table, spaces and glyphs
+			// not in the atlas draw nothing
+			if (std::iswspace(static_cast<wint_t>(c))) return;
+
+			const Character* drawn = characters.Find({ c, drawnSize, style });
+			if (drawn == nullptr || !drawn->rasterised || drawn->size.x == 0 || drawn->size.y == 0)
+				return;
+
+			const Character& charData = *drawn;
+
+			float x = xOffset + caretX + charData.bearing.x * glyphScale;
+			float y = cursor.y - charData.bearing.y * glyphScale + static_cast<float>(text->m_fontSize);
+
+			// coverage glyphs stay on the pixel grid, fields are filtered
+			if (!sdf)
+			{
+				x = std::round(x);
+				y = std::round(y);
+			}
+
+			float w = static_cast<float>(charData.size.x) * glyphScale;
+			float h = static_cast<float>(charData.size.y) * glyphScale;
+
+			float uBottomLeft = static_cast<float>(charData.pos.x) / ATLAS_WIDTH;
+			float vBottomLeft = static_cast<float>(charData.pos.y % ATLAS_HEIGHT) / ATLAS_HEIGHT;
+
+			float uTopRight = uBottomLeft + (static_cast<float>(charData.size.x) / ATLAS_WIDTH);
+			float vTopRight = vBottomLeft + (static_cast<float>(charData.size.y) / ATLAS_HEIGHT);
+
+			float layerIndex = static_cast<float>(charData.layer);
+			atlasLayers |= AtlasLayerBit(charData.layer);
+
+			uint32_t offset = static_cast<uint32_t>(outVertices.size());
+			outVertices.push_back(TextVertex{ {x, y}, {uBottomLeft, vBottomLeft, layerIndex}, text->m_colour });
+			outVertices.push_back(TextVertex{ {x + w, y}, {uTopRight, vBottomLeft, layerIndex}, text->m_colour });
+			outVertices.push_back(TextVertex{ {x + w, y + h}, {uTopRight, vTopRight, layerIndex}, text->m_colour });
+			outVertices.push_back(TextVertex{ {x, y + h}, {uBottomLeft, vTopRight, layerIndex}, text->m_colour });
+
+			outIndices.push_back(offset);
+			outIndices.push_back(offset + 1);
+			outIndices.push_back(offset + 2);
+			outIndices.push_back(offset);
+			outIndices.push_back(offset + 2);
+			outIndices.push_back(offset + 3);
+		});
+
+		cursor.y += text->m_lineSpacingPx;
 	}
+
+	outHeight = height;
+	outActualLineWidth = static_cast<int>(std::ceil(maxActualLineWidth));
+	outAtlasLayers = atlasLayers;
 }
 
-SableUI::GpuObject* SableUI::GetTextGpuObject(const _Text* text, int& height, int& maxWidth)
+SableUI::GpuObject* SableUI::GetTextGpuObject(const _Text* text, int& height, int& maxWidth, uint64_t& atlasLayers)
 {
 	if (fontManager == nullptr)
 		FontManager::GetInstance().Initialise();
 
-	std::vector<TextVertex> vertices;
-	std::vector<uint32_t> indices;
-	fontManager->GetTextVertexData(text, vertices, indices, height, maxWidth);
+	// reused between calls, the layout writes straight into them
+	static thread_local std::vector<TextVertex> vertices;
+	static thread_local std::vector<uint32_t> indices;
+	fontManager->GetTextVertexData(text, vertices, indices, height, maxWidth, atlasLayers);
 
-	VertexLayout layout;
-	layout.Add(VertexFormat::Float2);
-	layout.Add(VertexFormat::Float3);
-	layout.Add(VertexFormat::UInt1);
+	static const VertexLayout layout = [] {
+		VertexLayout l;
+		l.Add(VertexFormat::Float2);
+		l.Add(VertexFormat::Float3);
+		l.Add(VertexFormat::UInt1);
+		return l;
+	}();
 
 	GpuObject* obj = text->m_renderer->CreateGpuObject(
 		vertices.data(),
@@ -1980,6 +2706,49 @@ const SableUI::GpuTexture2DArray* SableUI::GetTextAtlasTexture()
 	return FontManager::GetInstance().GetTextAtlasTexture();
 }
 
+void SableUI::SetGlyphRenderMode(GlyphRenderMode mode)
+{
+	FontManager::GetInstance().SetRenderMode(mode);
+}
+
+SableUI::GlyphRenderMode SableUI::GetGlyphRenderMode()
+{
+	return FontManager::GetInstance().renderMode;
+}
+
+float SableUI::GetTextSdfRange(int fontSize)
+{
+	if (FontManager::GetInstance().renderMode != GlyphRenderMode::SDF)
+		return 0.0f;
+
+	return GetSdfPixelRange(fontSize);
+}
+
+void SableUI::SetFontAtlasLayerBudget(int layers)
+{
+	FontManager::GetInstance().SetAtlasLayerBudget(layers);
+}
+
+SableUI::ParagraphCacheStats SableUI::GetParagraphCacheStats()
+{
+	return FontManager::GetInstance().GetParagraphStats();
+}
+
+SableUI::AtlasStats SableUI::GetFontAtlasStats()
+{
+	return FontManager::GetInstance().GetAtlasStats();
+}
+
+uint64_t SableUI::GetFontAtlasGeneration()
+{
+	return FontManager::GetInstance().GetAtlasGeneration();
+}
+
+void SableUI::AdvanceFontAtlasFrame()
+{
+	FontManager::GetInstance().AdvanceAtlasFrame();
+}
+
 // ============================================================================
 // Size queries
 // ============================================================================
@@ -2035,29 +2804,10 @@ SableUI::CursorPosition SableUI::QueryCursorPosition(
 		}
 
 		char_t charKey = { c, fontSize, currentFontType };
-		auto charIt = fontManager.characters.find(charKey);
 
 		Character charData;
-		if (charIt != fontManager.characters.end())
-		{
-			charData = charIt->second;
-		}
-		else
-		{
-			FontRange targetRange;
-			if (fontManager.FindFontRangeForChar(c, targetRange))
-			{
-				Atlas newAtlas{};
-				newAtlas.fontSize = fontSize;
-				fontManager.LoadFontRange(newAtlas, targetRange);
-
-				auto newIt = fontManager.characters.find(charKey);
-				if (newIt != fontManager.characters.end())
-				{
-					charData = newIt->second;
-				}
-			}
-		}
+		if (const Character* glyph = fontManager.GetGlyph(charKey))
+			charData = *glyph;
 
 		float charAdvance = charData.advance;
 
@@ -2110,101 +2860,47 @@ SableUI::TextSizeResult SableUI::QueryTextSize(
 
 	int lineSpacingPx = static_cast<int>(fontSize * lineSpacing);
 
-	std::vector<float> lineWidths;
-	float currentLineWidth = 0.0f;
-	float currentWordWidth = 0.0f;
-	bool inWord = false;
+	// lines past maxHeight are not drawn, the same count as GetTextVertexData
+	int maxLines = (maxHeight > 0 && lineSpacingPx > 0)
+		? std::max(1, maxHeight / lineSpacingPx)
+		: INT_MAX;
 
-	FontType currentFontType = FontType::Regular;
+	std::shared_ptr<const ShapedParagraph> shaped = fontManager.GetParagraph(text, fontSize);
 
-	for (char32_t c : text)
-	{
-		if (fontManager.SetStyleChar(c))
-			continue;
+	// breaks as TextLayout makes them, over the cached runs
+	float lineWidth = 0.0f;
+	float widestLine = 0.0f;
+	int lineCount = 1;
 
-		if (c == U'\n')
+	bool full = false;
+	for (size_t i = 0; i < shaped->lines.size() && !full; i++)
+	{
+		for (const TextToken& run : shaped->lines[i].shaped->runs)
 		{
-			lineWidths.push_back(currentLineWidth + currentWordWidth);
-			currentLineWidth = 0.0f;
-			currentWordWidth = 0.0f;
-			inWord = false;
-			continue;
-		}
-
-		if (IsNonPrintableChar(c))
-			continue;
+			bool wraps = !run.isSpace && maxWidth > 0 &&
+				lineWidth > 0 && (lineWidth + run.width > maxWidth);
 
-		char_t charKey = { c, fontSize, currentFontType };
-		auto it = fontManager.characters.find(charKey);
-
-		Character charData;
-		if (it != fontManager.characters.end())
-		{
-			charData = it->second;
-		}
-		else
-		{
-			FontRange targetRange;
-			if (fontManager.FindFontRangeForChar(c, targetRange))
+			if (run.isNewline || wraps)
 			{
-				Atlas newAtlas{};
-				newAtlas.fontSize = fontSize;
-				fontManager.LoadFontRange(newAtlas, targetRange);
-
-				auto newIt = fontManager.characters.find(charKey);
-				if (newIt != fontManager.characters.end())
-				{
-					charData = newIt->second;
-				}
-			}
-		}
+				widestLine = std::max(widestLine, lineWidth);
+				lineWidth = 0.0f;
 
-		float charAdvance = charData.advance;
+				full = lineCount == maxLines;
+				if (full) break;
+				lineCount++;
 
-		if (std::iswspace(static_cast<wint_t>(c)))
-		{
-			if (inWord)
-			{
-				currentLineWidth += currentWordWidth;
-				currentWordWidth = 0.0f;
-				inWord = false;
+				if (run.isNewline) continue;
 			}
-			currentLineWidth += charAdvance;
-		}
-		else
-		{
-			currentWordWidth += charAdvance;
-			inWord = true;
-
-			if (maxWidth > 0 && currentLineWidth > 0 &&
-				(currentLineWidth + currentWordWidth > maxWidth))
-			{
-				lineWidths.push_back(currentLineWidth);
-				currentLineWidth = 0.0f;
 
-				if (maxHeight > 0)
-				{
-					int potentialLines = lineWidths.size() + 1;
-					if (potentialLines * lineSpacingPx > maxHeight)
-					{
-						currentWordWidth = 0.0f;
-						break;
-					}
-				}
-			}
+			lineWidth += run.width;
 		}
 	}
 
-	if (currentLineWidth > 0 || currentWordWidth > 0)
-		lineWidths.push_back(currentLineWidth + currentWordWidth);
+	widestLine = std::max(widestLine, lineWidth);
 
-	result.lineCount = lineWidths.empty() ? 1 : lineWidths.size();
-	result.height = result.lineCount * lineSpacingPx;
-
-	for (float width : lineWidths)
-		result.width = std::max(result.width, static_cast<int>(std::ceil(width)));
-
-	currentFontType = FontType::Regular;
+	result.lineCount = lineCount;
+	result.height = lineCount * lineSpacingPx;
+	result.width = static_cast<int>(std::ceil(widestLine));
 
 	return result;
 }
@@ -2243,7 +2939,12 @@ SableUI::_Text::_Text(_Text&& other) noexcept
 	m_cachedHeight(other.m_cachedHeight),
 	m_actualWrappedWidth(other.m_actualWrappedWidth),
 	m_renderer(other.m_renderer),
-	m_cacheKeys(std::move(other.m_cacheKeys))
+	m_atlasGeneration(other.m_atlasGeneration),
+	m_atlasLayers(other.m_atlasLayers),
+	m_gpuStale(other.m_gpuStale),
+	m_layout(std::move(other.m_layout)),
+	m_cacheKeys(std::move(other.m_cacheKeys)),
+	m_shaped(std::move(other.m_shaped))
 {
 	other.m_gpuObject = nullptr;
 	other.m_cacheKeys.clear();
@@ -2269,10 +2970,7 @@ int SableUI::_Text::SetContent(
 	m_lineSpacingPx = static_cast<int>(fontSize * lineSpacing);
 	m_justify = justification;
 
-	TextCacheKey key(this);
-	m_gpuObject = TextCacheFactory::Get(this, m_cachedHeight);
-	m_cacheKeys.push_back(key);
-
+	Rebuild();
 	return m_cachedHeight;
 }
 
@@ -2292,36 +2990,121 @@ int SableUI::_Text::UpdateMaxWidth(int maxWidth)
 
 	fontManager = &FontManager::GetInstance();
 
-	TextCacheKey key(this);
-	m_gpuObject = TextCacheFactory::Get(this, m_cachedHeight);
-	m_cacheKeys.push_back(key);
-
+	Rebuild();
 	return m_cachedHeight;
 }
 
-
-int SableUI::_Text::GetMinWidth(bool wrapped)
+void SableUI::_Text::Rebuild()
 {
+	for (const auto& oldKey : m_cacheKeys)
+		TextCacheFactory::Release(m_renderer, oldKey);
+	m_cacheKeys.clear();
+	m_gpuObject = nullptr;
+
 	if (fontManager == nullptr || !fontManager->isInitialized)
 		FontManager::GetInstance().Initialise();
 
 	fontManager = &FontManager::GetInstance();
 
-	return fontManager->GetMinWidth(this, wrapped);
+	// layout needs metrics only, the glyphs are rasterised by PrepareAtlas() if the text is drawn
+	fontManager->MeasureTextLayout(this, m_cachedHeight, m_actualWrappedWidth);
+	m_gpuStale = true;
 }
 
-int SableUI::_Text::GetUnwrappedHeight()
+void SableUI::_Text::BuildGpuObject()
+{
+	for (const auto& oldKey : m_cacheKeys)
+		TextCacheFactory::Release(m_renderer, oldKey);
+	m_cacheKeys.clear();
+
+	m_atlasGeneration = GetFontAtlasGeneration();
+
+	int height = 0;
+	TextCacheKey key(this);
+	m_gpuObject = TextCacheFactory::Get(this, height, m_atlasLayers);
+	m_cacheKeys.push_back(key);
+	m_gpuStale = false;
+}
+
+void SableUI::_Text::PrepareAtlas()
 {
-	int lines = 1;
-	for (char32_t c : m_content)
+	// the cached vertices point at evicted glyphs, height and width are unchanged
+	if (m_gpuStale || (m_gpuObject != nullptr && m_atlasGeneration != GetFontAtlasGeneration()))
+		BuildGpuObject();
+
+	if (m_gpuObject == nullptr) return;
+	FontManager::GetInstance().TouchAtlasLayers(m_atlasLayers);
+}
+
+SableUI::CursorPosition SableUI::_Text::GetCursorPosition(size_t index)
+{
+	m_layout.Update(m_content, m_fontSize, m_maxWidth);
+
+	size_t line = m_layout.GetLineOfIndex(index);
+	float x = m_layout.GetCaretX(index);
+
+	if (m_maxWidth > 0 && line < m_layout.GetLineCount())
 	{
-		if (IsNonPrintableChar(c)) continue;
+		float lineWidth = m_layout.GetLine(line).width;
+		if (m_justify == TextJustification::Center) x += (m_maxWidth - lineWidth) / 2.0f;
+		if (m_justify == TextJustification::Right) x += m_maxWidth - lineWidth;
+	}
 
-		if (c == U'\n')
-			lines++;
+	CursorPosition result;
+	result.x = static_cast<int>(std::round(x));
+	result.y = static_cast<int>(line) * m_lineSpacingPx;
+	result.lineHeight = m_lineSpacingPx;
+	result.lineIndex = static_cast<int>(line);
+	return result;
+}
+
+size_t SableUI::_Text::GetIndexAtPoint(ivec2 point)
+{
+	m_layout.Update(m_content, m_fontSize, m_maxWidth);
+	if (m_layout.GetLineCount() == 0 || m_lineSpacingPx <= 0) return 0;
+
+	int line = std::clamp(point.y / m_lineSpacingPx, 0, static_cast<int>(m_layout.GetLineCount()) - 1);
+	float x = static_cast<float>(point.x);
+
+	if (m_maxWidth > 0)
+	{
+		float lineWidth = m_layout.GetLine(line).width;
+		if (m_justify == TextJustification::Center) x -= (m_maxWidth - lineWidth) / 2.0f;
+		if (m_justify == TextJustification::Right) x -= m_maxWidth - lineWidth;
+	}
+
+	return m_layout.GetIndexAt(static_cast<size_t>(line), x);
+}
+
+
+const SableUI::ShapedParagraph& SableUI::_Text::GetShaped()
+{
+	if (fontManager == nullptr || !fontManager->isInitialized)
+		FontManager::GetInstance().Initialise();
+
+	fontManager = &FontManager::GetInstance();
+
+	// the paragraph's copy of the content shares its buffer until either is written to.
+	// the superseded paragraph is dropped here, lines the edit did not touch carry over from it
+	const char32_t* content = std::as_const(m_content).begin();
+	if (!m_shaped || m_shaped->fontSize != m_fontSize ||
+		m_shaped->text.size() != m_content.size() || m_shaped->text.begin() != content)
+	{
+		m_shaped = fontManager->GetParagraph(m_content, m_fontSize, m_shaped.get());
 	}
 
-	return lines * m_lineSpacingPx;
+	return *m_shaped;
+}
+
+int SableUI::_Text::GetMinWidth(bool wrapped)
+{
+	const ShapedParagraph& shaped = GetShaped();
+	return static_cast<int>(std::ceil(wrapped ? shaped.widestWord : shaped.widestLine));
+}
+
+int SableUI::_Text::GetUnwrappedHeight()
+{
+	return GetShaped().hardLines * m_lineSpacingPx;
 }
 
 int SableUI::_Text::GetNumInstances()
@@ -13,38 +13,61 @@
 using namespace SableUI;
 
 static std::unordered_map<RendererBackend*, TextCacheFactory> s_textCacheFactories;
+static size_t s_textCacheBudget = 8 * 1024 * 1024;
 
-GpuObject* TextCacheFactory::Get_priv(const _Text* text, int& height)
+// an idle entry keeps its key's text alive on its own, so that counts too
+static size_t GetEntryBytes(const TextCacheKey& key, const GpuObject* obj)
+{
+	size_t bytes = key.content.size() * sizeof(char32_t);
+	if (obj == nullptr) return bytes;
+
+	return bytes + static_cast<size_t>(obj->numVertices) * obj->layout.stride +
+		static_cast<size_t>(obj->numIndices) * sizeof(uint32_t);
+}
+
+GpuObject* TextCacheFactory::Get_priv(const _Text* text, int& height, uint64_t& atlasLayers)
 {
 	TextCacheKey key = TextCacheKey(text);
 	auto it = m_cache.find(key);
 	if (it != m_cache.end())
 	{
-		it->second.refCount++;
-		it->second.lastConsumedFrame = m_currentFrame;
-		height = it->second.height;
-		return it->second.gpuObject;
+		TextCache& entry = it->second;
+		if (entry.refCount <= 0)
+		{
+			UnlinkIdle(entry);
+			entry.refCount = 0;
+		}
+
+		m_hits++;
+		entry.refCount++;
+		entry.lastConsumedFrame = m_currentFrame;
+		height = entry.height;
+		atlasLayers = entry.atlasLayers;
+		return entry.gpuObject;
 	}
 
+	m_misses++;
+
 	int maxWidth = 0;
 	TextCache entry{};
-	entry.gpuObject = GetTextGpuObject(text, height, maxWidth);
+	entry.gpuObject = GetTextGpuObject(text, height, maxWidth, entry.atlasLayers);
 	entry.refCount++;
 	entry.maxWidth = text->m_maxWidth;
 	entry.height = height;
 	entry.lastConsumedFrame = m_currentFrame;
-	m_cache[key] = entry;
+	entry.bytes = GetEntryBytes(key, entry.gpuObject);
+
+	auto inserted = m_cache.emplace(key, entry).first;
+	inserted->second.key = &inserted->first;
+	m_bytes += entry.bytes;
+
+	atlasLayers = entry.atlasLayers;
 	return entry.gpuObject;
 }
 
-GpuObject* SableUI::TextCacheFactory::Get(const _Text* key, int& height)
+GpuObject* SableUI::TextCacheFactory::Get(const _Text* key, int& height, uint64_t& atlasLayers)
 {
-	auto it = s_textCacheFactories.find(key->m_renderer);
-	if (it != s_textCacheFactories.end())
-		return it->second.Get_priv(key, height);
-
-	s_textCacheFactories[key->m_renderer] = TextCacheFactory();
-	return s_textCacheFactories[key->m_renderer].Get_priv(key, height);
+	return s_textCacheFactories[key->m_renderer].Get_priv(key, height, atlasLayers);
 }
 
 void SableUI::TextCacheFactory::Release(RendererBackend* renderer, const TextCacheKey& key)
@@ -61,12 +84,23 @@ void SableUI::TextCacheFactory::ShutdownFactory(RendererBackend* renderer)
 	{
 		for (auto& pair : it->second.m_cache)
 		{
-			pair.second.gpuObject->context->DestroyGpuObject(pair.second.gpuObject);
+			if (pair.second.gpuObject)
+				pair.second.gpuObject->context->DestroyGpuObject(pair.second.gpuObject);
 		}
 		s_textCacheFactories.erase(it);
 	}
 }
 
+void SableUI::TextCacheFactory::SetMemoryBudget(size_t bytes)
+{
+	s_textCacheBudget = bytes;
+}
+
+size_t SableUI::TextCacheFactory::GetMemoryBudget()
+{
+	return s_textCacheBudget;
+}
+
 std::vector<const TextCacheFactory*> SableUI::TextCacheFactory::GetFactories()
 {
 	std::vector<const TextCacheFactory*> factories;
@@ -83,6 +117,8 @@ void TextCacheFactory::Release_priv(TextCacheKey key)
 	if (it != m_cache.end())
 	{
 		it->second.refCount--;
+		if (it->second.refCount == 0)
+			LinkIdle(it->second);
 	}
 	else
 		SableUI_Warn("Entry not found");
@@ -93,6 +129,44 @@ int SableUI::TextCacheFactory::GetNumInstances() const
 	return m_cache.size();
 }
 
+SableUI::TextCacheStats SableUI::TextCacheFactory::GetStats() const
+{
+	TextCacheStats stats;
+	stats.hits = m_hits;
+	stats.misses = m_misses;
+	stats.evictions = m_evictions;
+	stats.entries = m_cache.size();
+	stats.idleEntries = m_idleCount;
+	stats.bytes = m_bytes;
+	stats.budget = s_textCacheBudget;
+	return stats;
+}
+
+void TextCacheFactory::LinkIdle(TextCache& entry)
+{
+	entry.idlePrev = nullptr;
+	entry.idleNext = m_idleHead;
+
+	if (m_idleHead) m_idleHead->idlePrev = &entry;
+	else m_idleTail = &entry;
+
+	m_idleHead = &entry;
+	m_idleCount++;
+}
+
+void TextCacheFactory::UnlinkIdle(TextCache& entry)
+{
+	if (entry.idlePrev) entry.idlePrev->idleNext = entry.idleNext;
+	else m_idleHead = entry.idleNext;
+
+	if (entry.idleNext) entry.idleNext->idlePrev = entry.idlePrev;
+	else m_idleTail = entry.idlePrev;
+
+	entry.idlePrev = nullptr;
+	entry.idleNext = nullptr;
+	m_idleCount--;
+}
+
 void SableUI::TextCacheFactory::CleanCache(RendererBackend* renderer)
 {
 	auto it = s_textCacheFactories.find(renderer);
@@ -102,20 +176,14 @@ void SableUI::TextCacheFactory::CleanCache(RendererBackend* renderer)
 
 void SableUI::TextCacheFactory::CleanCache_priv()
 {
-	std::vector<TextCacheKey> toDelete;
-
-	for (auto& pair : m_cache)
+	// oldest released first, anything used this frame may still be drawn from
+	while (m_bytes > s_textCacheBudget && m_idleTail != nullptr &&
+		m_idleTail->lastConsumedFrame < m_currentFrame)
 	{
-		if (pair.second.refCount <= 0 && pair.second.lastConsumedFrame < m_currentFrame)
-		{
-			pair.second.gpuObject->context->DestroyGpuObject(pair.second.gpuObject);
-			toDelete.push_back(pair.first);
-		}
+		Delete(*m_idleTail->key);
+		m_evictions++;
 	}
 
-	for (auto& key : toDelete)
-		m_cache.erase(key);
-
 	m_currentFrame++;
 }
 
@@ -124,7 +192,12 @@ void TextCacheFactory::Delete(TextCacheKey key)
 	auto it = m_cache.find(key);
 	if (it != m_cache.end())
 	{
-		it->second.gpuObject->context->DestroyGpuObject(it->second.gpuObject);
+		if (it->second.refCount <= 0)
+			UnlinkIdle(it->second);
+
+		m_bytes -= it->second.bytes;
+		if (it->second.gpuObject)
+			it->second.gpuObject->context->DestroyGpuObject(it->second.gpuObject);
 		m_cache.erase(it);
 	}
 	else
@@ -133,10 +206,12 @@ void TextCacheFactory::Delete(TextCacheKey key)
 
 SableUI::TextCacheKey::TextCacheKey(const _Text* text)
 {
-	stringHash = std::hash<SableString>()(text->m_content);
+	content = text->m_content;
+	colour = text->m_colour;
 	maxWidth = text->m_maxWidth;
 	fontSize = text->m_fontSize;
 	maxHeight = text->m_maxHeight;
 	lineSpacingPx = text->m_lineSpacingPx;
 	justification = text->m_justify;
+	atlasGeneration = text->m_atlasGeneration;
 }
@@ -441,15 +441,20 @@ bool SableUI::Window::Update(const std::unordered_set<TimerHandle>& firedTimers)
 	CommandBuffer& cmd = m_baseRenderer->GetCommandBuffer();
 	ContextResources& contextResources = GetContextResources(m_baseRenderer);
 
-	// regular panels
-	m_root->DistributeEvents(ctx);
-	bool dirty = m_root->UpdateComponents(cmd, &m_baseFramebuffer, contextResources);
-	if (dirty)
+	// regular panels, state changes made while handling events wake the loop once
 	{
-		m_root->Render(cmd, &m_baseFramebuffer, contextResources);
-		m_needsStaticRedraw = true;
+		UpdateBatch batch;
+		m_root->DistributeEvents(ctx);
+
+		m_dirtyQueue.Process(cmd, &m_baseFramebuffer, contextResources);
+		bool dirty = m_root->UpdateComponents(cmd, &m_baseFramebuffer, contextResources);
+		if (dirty)
+		{
+			m_root->Render(cmd, &m_baseFramebuffer, contextResources);
+			m_needsStaticRedraw = true;
+		}
+		m_root->PostLayoutUpdate(ctx);
 	}
-	m_root->PostLayoutUpdate(ctx);
 
 	StepCachedTexturesCleaner();
 	TextCacheFactory::CleanCache(m_baseRenderer);
@@ -487,9 +492,13 @@ void SableUI::Window::Draw()
 	//	}
 	//}
 
-	if (baseLayerDirty || anyFloatingPanelDirty || !m_customTargetQueues.empty())
+	// overlay queues are only presented again when rebuilt or removed, an
+	// idle focused text field does not keep the loop swapping
+	if (baseLayerDirty || anyFloatingPanelDirty || m_customQueuesChanged)
 		m_syncFrames = 2;
 
+	m_customQueuesChanged = false;
+
 	if (m_syncFrames > 0)
 	{
 		if (baseLayerDirty)
@@ -586,6 +595,7 @@ void SableUI::Window::SubmitCustomQueue(CustomTargetQueue* queue)
 		== m_customTargetQueues.end())
 	{
 		m_customTargetQueues.push_back(queue);
+		m_customQueuesChanged = true;
 	}
 	else
 	{
@@ -602,6 +612,7 @@ void SableUI::Window::RemoveQueueReference(CustomTargetQueue* reference)
 		if (m_customTargetQueues[i] == reference)
 		{
 			m_customTargetQueues.erase(m_customTargetQueues.begin() + i);
+			m_customQueuesChanged = true;
 			break;
 		}
 	}
@@ -0,0 +1,71 @@
+#include <SableUI/states/store.h>
+#include <SableUI/SableUI.h>
+#include <algorithm>
+#include <vector>
+
+// selectors setting the store they watch converge or are cut off here
+constexpr int MAX_NOTIFY_PASSES = 16;
+
+SableUI::StoreBase::~StoreBase()
+{
+	for (StoreSubscriber* subscriber : m_subscribers)
+		if (subscriber)
+			subscriber->OnStoreDestroyed();
+}
+
+size_t SableUI::StoreBase::GetNumSubscribers() const
+{
+	return std::count_if(m_subscribers.begin(), m_subscribers.end(),
+		[](const StoreSubscriber* s) { return s != nullptr; });
+}
+
+void SableUI::StoreBase::Subscribe(StoreSubscriber* subscriber)
+{
+	m_subscribers.push_back(subscriber);
+}
+
+void SableUI::StoreBase::Unsubscribe(StoreSubscriber* subscriber)
+{
+	auto it = std::find(m_subscribers.begin(), m_subscribers.end(), subscriber);
+	if (it == m_subscribers.end())
+		return;
+
+	// keep indices stable while a notification is walking the list
+	if (m_notifying)
+		*it = nullptr;
+	else
+		m_subscribers.erase(it);
+}
+
+void SableUI::StoreBase::Notify()
+{
+	m_version++;
+
+	// re-entrant sets from a selector only bump the version, the outer
+	// call repeats its pass until the version settles
+	if (m_notifying)
+		return;
+
+	m_notifying = true;
+
+	// components dirtied here wake the event loop once
+	UpdateBatch batch;
+	int passes = 0;
+	uint64_t notifiedVersion;
+	do
+	{
+		if (passes++ == MAX_NOTIFY_PASSES)
+		{
+			SableUI_Warn("Store still changing after %d notify passes, a subscriber keeps setting it", MAX_NOTIFY_PASSES);
+			break;
+		}
+
+		notifiedVersion = m_version;
+		for (size_t i = 0; i < m_subscribers.size(); i++)
+			if (m_subscribers[i])
+				m_subscribers[i]->OnStoreChanged();
+	} while (m_version != notifiedVersion);
+
+	m_subscribers.erase(std::remove(m_subscribers.begin(), m_subscribers.end(), nullptr), m_subscribers.end());
+	m_notifying = false;
+}
@@ -1,6 +1,7 @@
 #include <SableUI/utils/string.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <cstdarg>
 #include <cstdio>
@@ -10,7 +11,7 @@
 
 using namespace SableUI;
 
-static int s_numComponents = 0;
+static std::atomic<int> s_numComponents = 0;
 
 String::StringData::StringData(const char32_t* str, size_t len)
 	: size(len), refCount(1), data(nullptr)
@@ -334,6 +335,12 @@ bool String::operator==(const String& other) const
 	if (!m_data || !other.m_data)
 		return false;
 
+	if (m_data == other.m_data)
+		return true;
+
+	if (m_data->hash != 0 && other.m_data->hash != 0 && m_data->hash != other.m_data->hash)
+		return false;
+
 	return std::equal(m_data->data, m_data->data + m_size, other.m_data->data);
 }
 
@@ -477,6 +484,47 @@ String String::substr(size_t pos, size_t count) const
 	return result;
 }
 
+// multiply-xorshift over two code points per step
+static uint64_t HashCodePoints(const char32_t* data, size_t len)
+{
+	constexpr uint64_t K = 0x9e3779b97f4a7c15ULL;
+	uint64_t h = 0xcbf29ce484222325ULL ^ (len * K);
+
+	size_t i = 0;
+	for (; i + 2 <= len; i += 2)
+	{
+		uint64_t v;
+		std::memcpy(&v, data + i, sizeof(v));
+		h = (h ^ v) * K;
+		h ^= h >> 32;
+	}
+
+	if (i < len)
+	{
+		h = (h ^ static_cast<uint64_t>(data[i])) * K;
+		h ^= h >> 32;
+	}
+
+	h ^= h >> 29;
+	h *= 0xbf58476d1ce4e5b9ULL;
+	h ^= h >> 32;
+	return h;
+}
+
+size_t String::Hash() const noexcept
+{
+	if (!m_data || !m_data->data)
+		return static_cast<size_t>(HashCodePoints(nullptr, 0));
+
+	if (m_data->hash == 0)
+	{
+		size_t h = static_cast<size_t>(HashCodePoints(m_data->data, m_size));
+		m_data->hash = (h != 0) ? h : 1;
+	}
+
+	return m_data->hash;
+}
+
 size_t String::size() const noexcept
 {
 	return m_size;
@@ -494,15 +542,18 @@ char32_t String::operator[](size_t index) const noexcept
 	return m_data->data[index];
 }
 
+// mutable iterators may write through, so the cached hash is dropped
 String::iterator String::begin() noexcept
 {
 	MakeUnique();
+	if (m_data) m_data->hash = 0;
 	return m_data ? m_data->data : nullptr;
 }
 
 String::iterator String::end() noexcept
 {
 	MakeUnique();
+	if (m_data) m_data->hash = 0;
 	return m_data ? (m_data->data + m_size) : nullptr;
 }
 
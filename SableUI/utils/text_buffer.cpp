@@ -0,0 +1,322 @@
+#include <SableUI/utils/text_buffer.h>
+#include <algorithm>
+#include <string>
+#include <utility>
+
+using namespace SableUI;
+
+// chars per shared block, larger inserts get a block of their own
+constexpr uint32_t TEXT_BLOCK_SIZE = 64 * 1024;
+
+struct TextBuffer::Node
+{
+	std::shared_ptr<const char32_t[]> block;
+	uint32_t offset = 0;
+	uint32_t length = 0;
+	uint32_t priority = 0;
+
+	size_t total = 0;	// chars in this subtree
+	size_t pieces = 0;	// nodes in this subtree
+
+	NodePtr left;
+	NodePtr right;
+};
+
+using Node = TextBuffer::Node;
+using NodePtr = TextBuffer::NodePtr;
+
+static size_t Total(const NodePtr& node) { return node ? node->total : 0; }
+static size_t Pieces(const NodePtr& node) { return node ? node->pieces : 0; }
+
+static uint32_t NextPriority(uint32_t& seed)
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	return seed;
+}
+
+// copy of piece with new children, nodes are never modified once shared
+static NodePtr With(const Node& piece, uint32_t offset, uint32_t length, NodePtr left, NodePtr right)
+{
+	auto node = std::make_shared<Node>();
+	node->block = piece.block;
+	node->offset = offset;
+	node->length = length;
+	node->priority = piece.priority;
+	node->total = Total(left) + length + Total(right);
+	node->pieces = Pieces(left) + 1 + Pieces(right);
+	node->left = std::move(left);
+	node->right = std::move(right);
+	return node;
+}
+
+static NodePtr With(const Node& piece, NodePtr left, NodePtr right)
+{
+	return With(piece, piece.offset, piece.length, std::move(left), std::move(right));
+}
+
+// all of a before all of b
+static NodePtr Merge(const NodePtr& a, const NodePtr& b)
+{
+	if (!a) return b;
+	if (!b) return a;
+
+	if (a->priority > b->priority)
+		return With(*a, a->left, Merge(a->right, b));
+
+	return With(*b, Merge(a, b->left), b->right);
+}
+
+// [0, pos) and [pos, total), a piece across pos is cut in two
+static void Split(const NodePtr& node, size_t pos, NodePtr& outLeft, NodePtr& outRight, uint32_t& seed)
+{
+	if (!node)
+	{
+		outLeft = nullptr;
+		outRight = nullptr;
+		return;
+	}
+
+	size_t leftTotal = Total(node->left);
+
+	if (pos <= leftTotal)
+	{
+		NodePtr right;
+		Split(node->left, pos, outLeft, right, seed);
+		outRight = With(*node, right, node->right);
+	}
+	else if (pos >= leftTotal + node->length)
+	{
+		NodePtr left;
+		Split(node->right, pos - leftTotal - node->length, left, outRight, seed);
+		outLeft = With(*node, node->left, left);
+	}
+	else
+	{
+		// the head keeps its place, the tail is a new piece. reusing the
+		// priority would leave runs of equal keys that merge into a list
+		uint32_t cut = static_cast<uint32_t>(pos - leftTotal);
+		outLeft = With(*node, node->offset, cut, node->left, nullptr);
+
+		Node tail = *node;
+		tail.priority = NextPriority(seed);
+		outRight = Merge(With(tail, node->offset + cut, node->length - cut, nullptr, nullptr), node->right);
+	}
+}
+
+static const Node* LastPiece(const NodePtr& node)
+{
+	const Node* last = node.get();
+	while (last && last->right) last = last->right.get();
+	return last;
+}
+
+static NodePtr ExtendLast(const NodePtr& node, uint32_t extra)
+{
+	if (node->right)
+		return With(*node, node->left, ExtendLast(node->right, extra));
+
+	return With(*node, node->offset, node->length + extra, node->left, nullptr);
+}
+
+static void AppendRange(const NodePtr& node, size_t pos, size_t end, std::u32string& out)
+{
+	if (!node || pos >= end) return;
+
+	size_t leftTotal = Total(node->left);
+	size_t pieceEnd = leftTotal + node->length;
+
+	if (pos < leftTotal)
+		AppendRange(node->left, pos, std::min(end, leftTotal), out);
+
+	if (end > leftTotal && pos < pieceEnd)
+	{
+		size_t from = std::max(pos, leftTotal) - leftTotal;
+		size_t to = std::min(end, pieceEnd) - leftTotal;
+		const char32_t* text = node->block.get() + node->offset;
+		out.append(text + from, text + to);
+	}
+
+	if (end > pieceEnd)
+		AppendRange(node->right, pos > pieceEnd ? pos - pieceEnd : 0, end - pieceEnd, out);
+}
+
+// ============================================================================
+// TextBuffer
+// ============================================================================
+TextBuffer::TextBuffer(const String& text)
+{
+	Assign(text);
+}
+
+void TextBuffer::Assign(const String& text)
+{
+	m_root = nullptr;
+	m_block = nullptr;
+	m_blockSize = 0;
+	m_blockUsed = 0;
+
+	Append(text.begin(), text.size(), 0);
+
+	m_flat = text;
+	m_flatValid = true;
+}
+
+void TextBuffer::Append(const char32_t* text, size_t length, size_t pos)
+{
+	if (text == nullptr || length == 0) return;
+
+	if (!m_block || m_blockUsed + length > m_blockSize)
+	{
+		m_blockSize = static_cast<uint32_t>(std::max<size_t>(TEXT_BLOCK_SIZE, length));
+		m_block = std::shared_ptr<char32_t[]>(new char32_t[m_blockSize]);
+		m_blockUsed = 0;
+	}
+
+	MarkEdited(pos, 0);
+
+	uint32_t offset = m_blockUsed;
+	std::copy(text, text + length, m_block.get() + offset);
+	m_blockUsed += static_cast<uint32_t>(length);
+
+	NodePtr left, right;
+	Split(m_root, pos, left, right, m_seed);
+
+	// typing extends the piece written just before it instead of adding one
+	const Node* last = LastPiece(left);
+	if (last && last->block.get() == m_block.get() && last->offset + last->length == offset)
+	{
+		left = ExtendLast(left, static_cast<uint32_t>(length));
+	}
+	else
+	{
+		Node piece;
+		piece.block = m_block;
+		piece.priority = NextPriority(m_seed);
+		left = Merge(left, With(piece, offset, static_cast<uint32_t>(length), nullptr, nullptr));
+	}
+
+	m_root = Merge(left, right);
+}
+
+void TextBuffer::MarkEdited(size_t pos, size_t erased)
+{
+	// [pos, pos + erased) is replaced, text either side of it is unchanged
+	size_t tail = size() - (pos + erased);
+	if (m_flatValid)
+	{
+		m_flatPrefix = pos;
+		m_flatSuffix = tail;
+		m_flatValid = false;
+		return;
+	}
+
+	m_flatPrefix = std::min(m_flatPrefix, pos);
+	m_flatSuffix = std::min(m_flatSuffix, tail);
+}
+
+void TextBuffer::Insert(size_t pos, const String& text)
+{
+	Append(text.begin(), text.size(), std::min(pos, size()));
+}
+
+void TextBuffer::Insert(size_t pos, char32_t c)
+{
+	Append(&c, 1, std::min(pos, size()));
+}
+
+void TextBuffer::Erase(size_t pos, size_t count)
+{
+	size_t length = size();
+	if (pos >= length || count == 0) return;
+	count = std::min(count, length - pos);
+	MarkEdited(pos, count);
+
+	NodePtr left, rest, middle, right;
+	Split(m_root, pos, left, rest, m_seed);
+	Split(rest, count, middle, right, m_seed);
+
+	m_root = Merge(left, right);
+}
+
+size_t TextBuffer::size() const
+{
+	return Total(m_root);
+}
+
+char32_t TextBuffer::At(size_t index) const
+{
+	const Node* node = m_root.get();
+	while (node)
+	{
+		size_t leftTotal = Total(node->left);
+		if (index < leftTotal)
+		{
+			node = node->left.get();
+		}
+		else if (index < leftTotal + node->length)
+		{
+			return node->block[node->offset + (index - leftTotal)];
+		}
+		else
+		{
+			index -= leftTotal + node->length;
+			node = node->right.get();
+		}
+	}
+
+	return U'\0';
+}
+
+String TextBuffer::Substr(size_t pos, size_t count) const
+{
+	size_t length = size();
+	if (pos >= length) return String();
+
+	std::u32string out;
+	out.reserve(std::min(count, length - pos));
+	AppendRange(m_root, pos, pos + std::min(count, length - pos), out);
+	return String(out);
+}
+
+const String& TextBuffer::ToString() const
+{
+	if (!m_flatValid)
+	{
+		size_t length = size();
+		const char32_t* previous = std::as_const(m_flat).begin();
+		size_t previousLength = m_flat.size();
+
+		// kept between calls, a fresh buffer this size costs more in page
+		// faults than the copy itself
+		std::u32string& out = m_scratch;
+		out.clear();
+		out.reserve(length);
+		out.append(previous, previous + m_flatPrefix);
+		AppendRange(m_root, m_flatPrefix, length - m_flatSuffix, out);
+		out.append(previous + previousLength - m_flatSuffix, previous + previousLength);
+
+		m_flat = String(out);
+		m_flatValid = true;
+	}
+
+	return m_flat;
+}
+
+void TextBuffer::Restore(const Snapshot& snapshot)
+{
+	if (snapshot.root == m_root) return;
+
+	m_root = snapshot.root;
+
+	// nothing is known about what the snapshot shares with m_flat
+	m_flatPrefix = 0;
+	m_flatSuffix = 0;
+	m_flatValid = false;
+}
+
+size_t TextBuffer::GetPieceCount() const
+{
+	return Pieces(m_root);
+}
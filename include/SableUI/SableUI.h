@@ -38,6 +38,16 @@ namespace SableUI
 
 	void PostEmptyEvent();
 
+	/* Holds back PostEmptyEvent() calls made on this thread until the
+	 * outermost batch closes, then wakes the event loop at most once */
+	struct UpdateBatch
+	{
+		UpdateBatch();
+		~UpdateBatch();
+		UpdateBatch(const UpdateBatch&) = delete;
+		UpdateBatch& operator=(const UpdateBatch&) = delete;
+	};
+
 	void SetElementBuilderContext(RendererBackend* renderer, Element* rootElement, bool isVirtual);
 	void SetCurrentComponent(BaseComponent* component);
 	Element* GetCurrentElement();
@@ -52,12 +62,18 @@ namespace SableUI
 	void AddRectVirtual(const ElementInfo& info = {});
 	void AddImageVirtual(const SableString& path, const ElementInfo& info = {});
 	void AddTextVirtual(const SableString& text, const ElementInfo& info = {});
+	void AddMemoisedComponentVirtual(const ElementInfo& info, BaseComponent* child);
+
+	// fills in the defaults the builders apply, inherited bg, sizing and text colour
+	void ResolveElementInfo(ElementInfo& info, const Element* parent);
 
 	void StartDiv(const ElementInfo& info = {}, SableUI::BaseComponent* child = nullptr);
 	void EndDiv();
 	void AddRect(const ElementInfo& info = {});
 	void AddImage(const SableString& path, const ElementInfo& info = {});
 	void AddText(const SableString& text, const ElementInfo& info = {});
+	// places a memoised component's existing subtree without rebuilding it
+	void AddMemoisedComponent(const ElementInfo& info, BaseComponent* child);
 
 	void SetNextPanelMaxWidth(int width);
 	void SetNextPanelMaxHeight(int height);
@@ -115,7 +131,7 @@ namespace SableUI
 	}
 
 	inline ElementInfo StripAppearanceStyles(ElementInfo info) {
-		info.appearance = AppearanceProps{};
+		info.appearance = {};
 		return info;
 	}
 }
@@ -135,7 +151,7 @@ namespace SableUI
 
 #define STRINGIFY(x) #x
 
-#define Component(name, ...) AddComponent(name)									\
+#define Component(name, ...) AddComponent(name, SableUI::PackStyles(__VA_ARGS__))	\
 	->BackendInitialiseChild(name, this, SableUI::PackStyles(__VA_ARGS__))
 
 #define ComponentScoped(name, T, owner, ...)									\
@@ -192,6 +208,8 @@ namespace SableUI
 #include <SableUI/components/text_field.h>
 #include <SableUI/components/calendar.h>
 #include <SableUI/components/date_picker.h>
+#include <SableUI/components/virtual_list.h>
+#include <SableUI/components/data_grid.h>
 #include <SableUI/core/tab_context.h>
 #include <SableUI/core/scroll_context.h>
 
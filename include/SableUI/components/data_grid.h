@@ -0,0 +1,108 @@
+#pragma once
+#include <SableUI/core/component.h>
+#include <SableUI/SableUI.h>
+#include <SableUI/core/element.h>
+#include <SableUI/core/events.h>
+#include <SableUI/utils/utils.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace SableUI
+{
+	/* Source of data for a DataGrid. GetCell is only called on the UI thread.
+	 * Sort and filter run on a worker thread over copies of the cells taken
+	 * on the UI thread when they start. A provider that can compare rows
+	 * without GetCell returns true from CompareOnWorker, LessThan and
+	 * MatchesFilter are then called from the worker instead of copying, so
+	 * they must be safe to run alongside the UI and must not hand out strings
+	 * shared with it */
+	class DataGridProvider
+	{
+	public:
+		virtual ~DataGridProvider() = default;
+
+		virtual size_t GetRowCount() const = 0;
+		virtual size_t GetColumnCount() const = 0;
+		virtual SableString GetColumnName(size_t col) const = 0;
+		virtual SableString GetCell(size_t row, size_t col) const = 0;
+
+		virtual int GetColumnWidth(size_t /*col*/) const { return 120; }
+
+		virtual bool CompareOnWorker() const { return false; }
+
+		// worker thread, only called when CompareOnWorker() is true
+		virtual bool LessThan(size_t rowA, size_t rowB, size_t col) const;
+		virtual bool MatchesFilter(size_t row, const std::u32string& filter) const;
+	};
+
+	struct DataGridState;
+
+	class DataGrid : public BaseComponent
+	{
+	public:
+		void Layout() override;
+		void OnUpdate(const UIEventContext& ctx) override;
+		void OnUpdatePostLayout(const UIEventContext& ctx) override;
+
+		void Init(std::shared_ptr<DataGridProvider> provider, int rowHeight, const ElementInfo& info);
+
+		// call after Init on every layout, an unset filter shows all rows
+		void SetFilter(const SableString& filter);
+
+		// sort and filter run on a worker thread, the grid keeps showing the
+		// previous order until the new permutation is ready. the cells they
+		// read are copied first, see DataGridProvider
+		void SortBy(size_t column, bool ascending = true);
+		void ClearSort();
+
+		bool IsProcessing();
+		size_t GetNumVisibleRows();
+		size_t GetFirstMaterialisedRow() const { return m_firstRow; }
+		size_t GetNumMaterialisedRows() const { return m_numRows; }
+		size_t GetFirstMaterialisedColumn() const { return m_firstCol; }
+		size_t GetNumMaterialisedColumns() const { return m_numCols; }
+
+	private:
+		ElementInfo info;
+		std::shared_ptr<DataGridProvider> m_provider = nullptr;
+		int m_rowHeight = 22;
+		std::u32string m_filter;
+
+		State<int64_t> scrollY{ this, 0 };
+		State<int> scrollX{ this, 0 };
+		State<int> viewportWidth{ this, 0 };
+		State<int> viewportHeight{ this, 0 };
+		State<int> resultVersion{ this, 0 };
+		Ref<int> resizingColumn{ this, -1 };
+		Ref<int> resizeOrigX{ this, 0 };
+		Ref<int> resizeStartWidth{ this, 0 };
+		Ref<std::shared_ptr<DataGridState>> gridState{ this, nullptr };
+
+		ElementId m_bodyId = MakeUniqueElementId();
+		std::vector<ElementId> m_handleIds;
+		size_t m_firstRow = 0;
+		size_t m_numRows = 0;
+		size_t m_firstCol = 0;
+		size_t m_numCols = 0;
+
+		DataGridState& GetGridState();
+		size_t GetSourceRow(size_t row);
+		int64_t GetMaxScrollY();
+		int GetMaxScrollX();
+		void SetScroll(int x, int64_t y);
+		void ToggleSort(size_t column);
+		void StartJob();
+	};
+}
+
+// Virtualised table over a DataGridProvider, only visible rows and columns are built
+#define DataGridView(provider, rowHeight, ...)									\
+	ComponentScopedWithStyle(													\
+		grid,																	\
+		SableUI::DataGrid,														\
+		this,																	\
+		SableUI::StripAppearanceStyles(SableUI::PackStyles(__VA_ARGS__))		\
+	)																			\
+	grid->Init(provider, rowHeight, SableUI::PackStyles(__VA_ARGS__))
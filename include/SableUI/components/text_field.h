@@ -5,7 +5,9 @@
 #include <SableUI/core/events.h>
 #include <SableUI/utils/utils.h>
 #include <SableUI/core/element.h>
+#include <SableUI/utils/text_buffer.h>
 #include <functional>
+#include <vector>
 
 namespace SableUI
 {
@@ -46,16 +48,39 @@ namespace SableUI
 
 		State<int> cursorPos{ this, 0 };
 		State<int> initialCursorPos{ this, -1 };
-		State<bool> cursorVisible{ this, true };
 		Interval m_cursorBlinkInterval{ this };
 
+		// the caret lives in the overlay queue, blinking and moving it only
+		// rebuilds that queue instead of rerendering the field
+		bool m_caretVisible = true;
+		bool m_caretDirty = true;
+		uint64_t m_caretEpoch = 0;
+
+		// edits go through the piece table, content is rebuilt once per update
+		// from the range the edits touched. undo steps are snapshots of it,
+		// a run of typing is one step
+		struct UndoStep
+		{
+			TextBuffer::Snapshot snapshot;
+			int cursor = 0;
+		};
+
+		TextBuffer m_buffer;
+		std::vector<UndoStep> m_undo;
+		std::vector<UndoStep> m_redo;
+		bool m_typingRun = false;
+
 		bool queueInitialised = false;
 		CustomTargetQueue queue;
 		Window* m_window = nullptr;
 		bool m_multiline = false;
 
 		void ResetCursorBlink();
+		void SetCaretVisible(bool visible);
 		void TriggerOnChange();
+		void SyncBuffer(const SableString& content);
+		void PushUndo(bool typing);
+		bool StepHistory(std::vector<UndoStep>& from, std::vector<UndoStep>& to);
 	};
 }
 
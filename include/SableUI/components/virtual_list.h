@@ -0,0 +1,103 @@
+#pragma once
+#include <SableUI/core/component.h>
+#include <SableUI/SableUI.h>
+#include <SableUI/core/element.h>
+#include <SableUI/core/events.h>
+#include <SableUI/utils/utils.h>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace SableUI
+{
+	/* Row heights for estimated-height lists, stored as a fenwick tree so
+	 * offset and row lookups stay O(log n) as rows get measured */
+	class RowHeightIndex
+	{
+	public:
+		void Reset(size_t rowCount, int estimatedHeight);
+
+		size_t GetRowCount() const { return m_heights.size(); }
+		int GetHeight(size_t row) const { return m_heights[row]; }
+		bool SetHeight(size_t row, int height);
+
+		int64_t GetOffset(size_t row) const;
+		int64_t GetTotalHeight() const { return GetOffset(m_heights.size()); }
+		size_t FindRow(int64_t offset) const;
+
+	private:
+		std::vector<int> m_heights;
+		std::vector<int64_t> m_tree;
+	};
+
+	class VirtualList : public BaseComponent
+	{
+	public:
+		using RowBuilder = std::function<void(size_t row)>;
+
+		void Layout() override;
+		void OnUpdate(const UIEventContext& ctx) override;
+		void OnUpdatePostLayout(const UIEventContext& ctx) override;
+
+		// every row is exactly rowHeight pixels tall
+		void Init(size_t rowCount, int rowHeight, RowBuilder builder, const ElementInfo& info);
+		// rows are laid out with the estimate until they are measured
+		void InitEstimated(size_t rowCount, int estimatedRowHeight, RowBuilder builder, const ElementInfo& info);
+
+		void SetOverscan(int rows) { m_overscan = rows; }
+		void ScrollToRow(size_t row);
+
+		size_t GetFirstMaterialisedRow() const { return m_firstRow; }
+		size_t GetNumMaterialisedRows() const { return m_numRows; }
+
+	private:
+		ElementInfo info;
+		RowBuilder m_builder = nullptr;
+		size_t m_rowCount = 0;
+		int m_rowHeight = 20;
+		bool m_estimated = false;
+		int m_overscan = 4;
+
+		State<int64_t> scrollY{ this, 0 };
+		State<int> viewportHeight{ this, 0 };
+		State<bool> barHovered{ this, false };
+		Ref<bool> isDragging{ this, false };
+		Ref<int> dragOrigY{ this, 0 };
+		Ref<int64_t> dragStartScrollY{ this, 0 };
+		Ref<std::shared_ptr<RowHeightIndex>> heights{ this, nullptr };
+
+		ElementId m_viewportId = MakeUniqueElementId();
+		ElementId m_barId = MakeUniqueElementId();
+		std::vector<ElementId> m_slotIds;
+		size_t m_firstRow = 0;
+		size_t m_numRows = 0;
+
+		int64_t GetContentHeight();
+		int64_t GetRowOffset(size_t row);
+		size_t GetRowAt(int64_t offset);
+		int64_t GetMaxScroll();
+		int GetThumbHeight();
+		void SetScroll(int64_t y);
+	};
+}
+
+// Virtualised list, builder is called as builder(rowIndex) for visible rows only
+#define VirtualListView(rowCount, rowHeight, builder, ...)						\
+	ComponentScopedWithStyle(													\
+		vlist,																	\
+		SableUI::VirtualList,													\
+		this,																	\
+		SableUI::StripAppearanceStyles(SableUI::PackStyles(__VA_ARGS__))		\
+	)																			\
+	vlist->Init(rowCount, rowHeight, builder, SableUI::PackStyles(__VA_ARGS__))
+
+// Virtualised list with measured row heights
+#define VirtualListViewEstimated(rowCount, estimatedHeight, builder, ...)		\
+	ComponentScopedWithStyle(													\
+		vlist,																	\
+		SableUI::VirtualList,													\
+		this,																	\
+		SableUI::StripAppearanceStyles(SableUI::PackStyles(__VA_ARGS__))		\
+	)																			\
+	vlist->InitEstimated(rowCount, estimatedHeight, builder, SableUI::PackStyles(__VA_ARGS__))
@@ -0,0 +1,109 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace SableUI
+{
+	/* Bottom-left skyline packer for a single atlas layer. The skyline is the
+	 * top edge of everything placed so far, a rect goes where its top ends up
+	 * lowest, ties broken by the least width. No GPU state, safe to use on
+	 * its own. */
+	class SkylinePacker
+	{
+	public:
+		SkylinePacker() = default;
+		SkylinePacker(int width, int height);
+
+		void Reset();
+
+		// false if the rect does not fit anywhere
+		bool Insert(int width, int height, int& outX, int& outY);
+
+		int GetWidth() const { return m_width; }
+		int GetHeight() const { return m_height; }
+		uint64_t GetUsedArea() const { return m_usedArea; }
+		float GetOccupancy() const;
+
+	private:
+		struct Node
+		{
+			int x;
+			int y;
+			int width;
+		};
+
+		// lowest y a rect of this width can sit at starting at node index, -1 if none
+		int FitAt(size_t index, int width, int height) const;
+		void AddLevel(size_t index, int x, int y, int width, int height);
+
+		std::vector<Node> m_skyline;
+		int m_width = 0;
+		int m_height = 0;
+		uint64_t m_usedArea = 0;
+	};
+
+	struct AtlasSlot
+	{
+		uint16_t x = 0;
+		uint16_t y = 0;
+		uint16_t layer = 0;
+	};
+
+	struct AtlasStats
+	{
+		int layers = 0;
+		int layerBudget = 0;
+		uint64_t allocations = 0;
+		uint64_t evictedEntries = 0;
+		uint64_t reclaimedLayers = 0;
+		uint64_t overBudget = 0; // allocations that grew past the budget
+		float occupancy = 0.0f; // used area over the area of every live layer
+	};
+
+	/* Layers of skyline packers with a layer budget. Every use of an entry
+	 * stamps its layer with the current frame. When the budget is full the
+	 * least recently used layer is reclaimed, returning the keys that lived on
+	 * it so the owner can drop them, skylines cannot free single rects. A
+	 * layer used during the current frame is never reclaimed, allocation goes
+	 * over budget instead. */
+	class AtlasAllocator
+	{
+	public:
+		AtlasAllocator(int width, int height, int padding, int layerBudget);
+
+		void SetLayerBudget(int layers);
+		int GetLayerBudget() const { return m_layerBudget; }
+
+		// slot is the padded rect's inner corner, keys freed to make room are appended to evicted
+		bool Allocate(uint64_t key, int width, int height, uint64_t frame,
+			AtlasSlot& outSlot, std::vector<uint64_t>& evicted);
+
+		void Touch(uint16_t layer, uint64_t frame);
+		void Clear();
+
+		int GetLayerCount() const { return static_cast<int>(m_layers.size()); }
+		AtlasStats GetStats() const;
+
+	private:
+		struct Layer
+		{
+			SkylinePacker packer;
+			std::vector<uint64_t> keys;
+			uint64_t lastUsed = 0;
+		};
+
+		bool TryLayer(size_t index, uint64_t key, int width, int height, uint64_t frame, AtlasSlot& outSlot);
+
+		std::vector<Layer> m_layers;
+		int m_width;
+		int m_height;
+		int m_padding;
+		int m_layerBudget;
+
+		uint64_t m_allocations = 0;
+		uint64_t m_evictedEntries = 0;
+		uint64_t m_reclaimedLayers = 0;
+		uint64_t m_overBudget = 0;
+	};
+}
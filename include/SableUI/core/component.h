@@ -2,10 +2,15 @@
 #include <SableUI/renderer/renderer.h>
 #include <SableUI/core/element.h>
 #include <SableUI/core/events.h>
+#include <SableUI/core/spatial_index.h>
 #include <SableUI/utils/utils.h>
 #include <SableUI/utils/memory.h>
 #include <SableUI/states/state_base.h>
+#include <memory>
+#include <tuple>
 #include <type_traits>
+#include <typeinfo>
+#include <unordered_map>
 #include <vector>
 #include <string>
 #include <utility>
@@ -14,11 +19,22 @@ namespace SableUI
 {
 	class FloatingPanelStateBase;
 	class Window;
+	class DirtyQueue;
+
+	struct ComponentReuseStats
+	{
+		uint64_t created = 0;
+		uint64_t reused = 0;
+		uint64_t memoSkipped = 0;
+	};
+
 	class BaseComponent
 	{
 	public:
 		BaseComponent(Colour colour = Colour{ 32, 32, 32 });
 		static int GetNumInstances();
+		static const ComponentReuseStats& GetReuseStats();
+		static void ResetReuseStats();
 		virtual ~BaseComponent();
 
 		virtual void Layout() {};
@@ -34,10 +50,21 @@ namespace SableUI
 		void Render(CommandBuffer& cmd, const GpuFramebuffer* framebuffer, ContextResources& contextResources, int z = 0);
 
 		BaseComponent* AddComponent(const std::string& componentName);
+		BaseComponent* AddComponent(const std::string& componentName, const ElementInfo& info);
 		template <typename T>
 		T* AddComponent();
+		template <typename T>
+		T* AddComponent(const std::string& typeName, const ElementInfo& info);
+
+		/* Call from Init to opt into memoisation, when every prop compares
+		 * equal to the last layout's, the style is unchanged and the component
+		 * is clean, its Layout() and subtree are skipped */
+		template <typename... Args>
+		void MemoProps(const Args&... args);
+		bool IsHoldingState() const { return m_holdState; }
 
 		Element* GetRootElement();
+		bool IsRootElement(const Element* el) const { return el != nullptr && el == rootElement; }
 		void SetRootElement(Element* element);
 		int GetNumChildren() const;
 		bool Rerender(CommandBuffer& cmd, const GpuFramebuffer* framebuffer, ContextResources& contextResources, bool* hasContentsChanged = nullptr);
@@ -50,13 +77,30 @@ namespace SableUI
 		void RegisterFloatingPanel(FloatingPanelStateBase* state);
 
 		void MarkDirty();
+		// drawables were patched in place, re-record without layout or reconcile
+		void MarkRepaint();
 		bool IsDirty() const { return needsRerender; }
+		void CollectGarbage();
+
+		// set on top level components, children take it from their parent
+		void SetDirtyQueue(DirtyQueue* queue) { m_dirtyQueue = queue; }
+		int GetDepth() const { return m_depth; }
+		// true once after a component in this tree was rerendered from the dirty queue
+		bool TakeSubtreeUpdated();
+		// true once after a component in this tree was repainted from the dirty queue
+		bool TakeSubtreeRepainted();
 
 		void CopyStateFrom(const BaseComponent& other);
 		Element* GetElementById(const SableString& id);
+		Element* GetElementById(ElementId id);
 
 		std::vector<BaseComponent*> m_componentChildren;
 		void RegisterHoverElement(Element* el);
+		void RegisterElementId(Element* el);
+		void UnregisterElementId(Element* el);
+
+		const SpatialIndex& GetSpatialIndex();
+		void InvalidateSpatialIndex() { m_spatialIndex.valid = false; }
 
 	protected:
 		std::vector<BaseComponent*> m_garbageChildren;
@@ -67,7 +111,46 @@ namespace SableUI
 		void UpdateHoverStyling(const UIEventContext& ctx);
 
 	private:
+		friend class DirtyQueue;
+
+		struct MemoBase
+		{
+			virtual ~MemoBase() = default;
+		};
+
+		template <typename... Args>
+		struct MemoHolder : MemoBase
+		{
+			MemoHolder(const Args&... args) : props(args...) {}
+			std::tuple<Args...> props;
+		};
+
+		size_t NextChildHash(const std::string& name, uint64_t key) const;
+		BaseComponent* ClaimPreviousChild(size_t hash, const std::type_info& type);
+
+		std::vector<BaseComponent*> m_previousChildren;
+		std::unique_ptr<MemoBase> m_memoProps = nullptr;
+		size_t m_styleHash = 0;
+		bool m_memoised = false;
+		bool m_propsChanged = true;
+		bool m_holdState = false;
+
+		DirtyQueue* m_dirtyQueue = nullptr;
+		BaseComponent* m_parent = nullptr;
+		int m_depth = 0;
+		bool m_queued = false;
+		bool m_subtreeUpdated = false;
+		bool m_subtreeRepainted = false;
+
+		void RebuildSpatialIndex();
+		SpatialIndex m_spatialIndex;
+		std::vector<BaseComponent*> m_inputChildren;
+		std::vector<Element*> m_hoveredElements;
+		std::vector<Element*> m_hitElements;
+		std::unordered_map<uint32_t, Element*> m_idIndex;
+
 		bool needsRerender = false;
+		bool needsRepaint = false;
 		BaseComponent* AttachComponent(BaseComponent* component);
 		UIEventContext m_lastEventCtx;
 		Element* rootElement = nullptr;
@@ -87,7 +170,7 @@ namespace SableUI
 		ComponentScope(BaseComponent* owner, std::string typeName, ElementInfo info)
 			: m_owner(owner), m_typeName(std::move(typeName)), m_info(std::move(info))
 		{
-			m_child = owner->AddComponent<T>();
+			m_child = owner->AddComponent<T>(m_typeName, m_info);
 		}
 
 		~ComponentScope()
@@ -129,6 +212,41 @@ namespace SableUI
 		return component;
 	}
 
+	template <typename T>
+	inline T* BaseComponent::AddComponent(const std::string& typeName, const ElementInfo& info)
+	{
+		static_assert(std::is_base_of_v<BaseComponent, T>, "AddComponent<T>: T must derive from BaseComponent");
+
+		size_t hash = NextChildHash(typeName, info.key);
+		if (BaseComponent* previous = ClaimPreviousChild(hash, typeid(T)))
+			return static_cast<T*>(previous);
+
+		T* component = SableMemory::SB_new<T>();
+		static_cast<BaseComponent*>(component)->m_hash = hash;
+
+		AttachComponent(component);
+		return component;
+	}
+
+	template <typename... Args>
+	inline void BaseComponent::MemoProps(const Args&... args)
+	{
+		using Holder = MemoHolder<std::decay_t<Args>...>;
+
+		m_memoised = true;
+		if (auto* previous = dynamic_cast<Holder*>(m_memoProps.get()))
+		{
+			if (previous->props == std::tie(args...))
+			{
+				m_propsChanged = false;
+				return;
+			}
+		}
+
+		m_memoProps = std::make_unique<Holder>(args...);
+		m_propsChanged = true;
+	}
+
 	void _priv_comp_PostEmptyEvent();
 }
 
@@ -136,4 +254,5 @@ namespace SableUI
 #include <SableUI/states/ref.h>
 #include <SableUI/states/interval.h>
 #include <SableUI/states/timer.h>
-#include <SableUI/states/floating_panel.h>
\ No newline at end of file
+#include <SableUI/states/floating_panel.h>
+#include <SableUI/states/store.h>
\ No newline at end of file
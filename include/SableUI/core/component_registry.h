@@ -4,6 +4,7 @@
 #include <unordered_map>
 #include <functional>
 #include <type_traits>
+#include <typeinfo>
 
 namespace SableUI
 {
@@ -19,6 +20,8 @@ namespace SableUI
         void Register(const std::string& name);
 
         BaseComponent* Create(const std::string& name) const;
+        // type the name creates, nullptr if it is not registered
+        const std::type_info* GetType(const std::string& name) const;
         bool IsRegistered(const std::string& name) const;
 
     private:
@@ -28,7 +31,13 @@ namespace SableUI
         ComponentRegistry(const ComponentRegistry&) = delete;
         ComponentRegistry& operator=(const ComponentRegistry&) = delete;
 
-        std::unordered_map<std::string, std::function<BaseComponent* ()>> m_factories;
+        struct Factory
+        {
+            std::function<BaseComponent* ()> create;
+            const std::type_info* type = nullptr;
+        };
+
+        std::unordered_map<std::string, Factory> m_factories;
     };
 
     template<typename T>
@@ -36,9 +45,9 @@ namespace SableUI
     {
         static_assert(std::is_base_of<BaseComponent, T>::value, "T must derive from BaseComponent");
 
-        m_factories[name] = []() -> BaseComponent* {
+        m_factories[name] = Factory{ []() -> BaseComponent* {
             return SableMemory::SB_new<T>();
-        };
+        }, &typeid(T) };
     }
 
     template<typename T>
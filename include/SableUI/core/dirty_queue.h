@@ -0,0 +1,39 @@
+#pragma once
+#include <SableUI/renderer/renderer.h>
+#include <cstdint>
+#include <vector>
+
+namespace SableUI
+{
+	class BaseComponent;
+
+	struct DirtyQueueStats
+	{
+		uint64_t queued = 0;
+		uint64_t rerendered = 0;
+		uint64_t repainted = 0; // paint-only, no layout or reconcile
+		uint64_t covered = 0; // already rebuilt by a dirty ancestor in the same pass
+	};
+
+	/* Components marked dirty in a window, rerendered once per frame from the
+	 * shallowest down. A parent's rerender lays its children out again, so a
+	 * queued child under a dirty parent is clean by the time it is reached.
+	 * Components that only need a repaint skip straight to re-recording. */
+	class DirtyQueue
+	{
+	public:
+		void Push(BaseComponent* component);
+		void Remove(BaseComponent* component);
+		bool IsEmpty() const { return m_pending.empty(); }
+
+		// returns true if any component was rerendered or repainted
+		bool Process(CommandBuffer& cmd, const GpuFramebuffer* framebuffer, ContextResources& contextResources);
+
+		const DirtyQueueStats& GetStats() const { return m_stats; }
+
+	private:
+		std::vector<BaseComponent*> m_pending;
+		std::vector<BaseComponent*> m_processing;
+		DirtyQueueStats m_stats;
+	};
+}
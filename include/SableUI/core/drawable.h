@@ -43,6 +43,8 @@ namespace SableUI
 	{
 		float targetSize[2];
 		float pos[2];
+		float sdfRange;
+		float padding[3];
 	};
 
 	void SetupGlobalResources(RendererBackend* renderer);
@@ -79,7 +81,7 @@ namespace SableUI
 		unsigned int GetUUID();
 	};
 
-	class DrawableRect : public DrawableBase
+	class DrawableRect final : public DrawableBase
 	{
 	public:
 		DrawableRect();
@@ -106,7 +108,7 @@ namespace SableUI
 		std::optional<Colour> m_borderColour = std::nullopt;
 	};
 
-	class DrawableSplitter : public DrawableBase
+	class DrawableSplitter final : public DrawableBase
 	{
 	public:
 		DrawableSplitter();
@@ -132,7 +134,7 @@ namespace SableUI
 		PanelType m_type = PanelType::Undef;
 	};
 
-	class DrawableImage : public DrawableBase
+	class DrawableImage final : public DrawableBase
 	{
 	public:
 		DrawableImage();
@@ -161,7 +163,7 @@ namespace SableUI
 		std::optional<Colour> m_borderColour = std::nullopt;
 	};
 
-	class DrawableText : public DrawableBase
+	class DrawableText final : public DrawableBase
 	{
 	public:
 		DrawableText();
@@ -4,10 +4,13 @@
 #include <SableUI/core/drawable.h>
 #include <SableUI/core/text.h>
 #include <SableUI/utils/utils.h>
+#include <SableUI/styles/style_ref.h>
+#include <SableUI/utils/inline_function.h>
 #include <vector>
 #include <string>
 #include <functional>
 #include <optional>
+#include <variant>
 #include <cstdint>
 
 namespace SableUI
@@ -48,6 +51,8 @@ namespace SableUI
 		int bT = 0, bB = 0, bL = 0, bR = 0;
 		bool centerX = false, centerY = false;
 		ivec2 pos = { -1, -1 };
+
+		bool operator==(const LayoutProps& other) const = default;
 	};
 
 	struct AppearanceProps {
@@ -61,8 +66,13 @@ namespace SableUI
 		ComponentSize size = ComponentSize::Medium; // scaling for sableui components
 		bool disabled = false; // special property for sableui components
 		bool clipChildren = false;
+
+		bool operator==(const AppearanceProps& other) const = default;
 	};
 
+	size_t HashStyle(const LayoutProps& layout);
+	size_t HashStyle(const AppearanceProps& appearance);
+
 	struct TextProps {
 		SableString content;
 		std::optional<Colour> colour = std::nullopt;
@@ -72,20 +82,44 @@ namespace SableUI
 		bool wrap = true;
 	};
 
+	// interned element id, 0 means no id
+	struct ElementId
+	{
+		uint32_t value = 0;
+
+		bool operator==(const ElementId& other) const { return value == other.value; }
+		bool operator!=(const ElementId& other) const { return value != other.value; }
+		explicit operator bool() const { return value != 0; }
+	};
+
+	ElementId InternElementId(const SableString& id);
+	ElementId FindElementId(const SableString& id);
+	ElementId MakeUniqueElementId();
+
+	// element callbacks are copied with every ElementInfo, so they live inline
+	using EventHandler = InlineFunction<void()>;
+
 	struct ElementInfo
 	{
 		SableString id;
+		ElementId internedId;
+		uint64_t key = 0; // stable identity among siblings, 0 means unkeyed
 		ElementType type = ElementType::Undef;
 
-		LayoutProps layout;
-		AppearanceProps appearance;
+		// interned once stored in an element or virtual node, see InternStyles()
+		StyleRef<LayoutProps> layout;
+		StyleRef<AppearanceProps> appearance;
 		TextProps text;
 
-		std::function<void()> onClickFunc = nullptr;
-		std::function<void()> onSecondaryClickFunc = nullptr;
-		std::function<void()> onDoubleClickFunc = nullptr;
+		EventHandler onClickFunc = nullptr;
+		EventHandler onSecondaryClickFunc = nullptr;
+		EventHandler onDoubleClickFunc = nullptr;
 	};
 
+	// hash of every diffed prop, never 0
+	size_t HashElementInfo(const ElementInfo& info);
+	void InternStyles(ElementInfo& info);
+
 	class BaseComponent;
 	struct VirtualNode
 	{
@@ -96,7 +130,9 @@ namespace SableUI
 
 		std::vector<VirtualNode*> children;
 		ElementInfo info;
+		size_t hash = 0; // HashElementInfo(info), set once the node is built
 		BaseComponent* childComp = nullptr;
+		bool memoised = false; // childComp kept its subtree, there are no children to diff
 	};
 
 	enum class ChildType
@@ -105,6 +141,26 @@ namespace SableUI
 		COMPONENT = 0x1,
 	};
 
+	// how far a reconciled change reaches, ordered so the widest change wins
+	enum class PropChange : uint8_t
+	{
+		None,
+		Paint,		// colours, radii, handlers, drawables patched in place
+		Layout,		// sizes, spacing, text, props patched and the tree relaid out
+		Structural	// element rebuilt from the virtual node
+	};
+
+	// per-child totals since the last reset
+	struct ReconcileStats
+	{
+		uint64_t unchanged = 0;
+		uint64_t paintPatches = 0;
+		uint64_t layoutPatches = 0;
+		uint64_t created = 0;
+		uint64_t removed = 0;
+		uint64_t moved = 0;
+	};
+
 	struct Child;
 	class Element
 	{
@@ -114,6 +170,9 @@ namespace SableUI
 		~Element();
 
 		static int GetNumInstances();
+		static uint64_t GetLayoutEpoch();
+		static const ReconcileStats& GetReconcileStats();
+		static void ResetReconcileStats();
 
 		// functions for engine
 		void Init(RendererBackend* renderer);
@@ -123,6 +182,7 @@ namespace SableUI
 		void AddChild(Child* component);
 		void SetImage(const std::string& path);
 		void SetText(const SableString& text);
+		_Text* GetText(); // nullptr unless a text element
 		int GetMinWidth();
 		int GetMinHeight();
 
@@ -130,20 +190,33 @@ namespace SableUI
 		ElementInfo GetInfo() const;
 
 		// internal functions
-		bool Reconcile(VirtualNode* vnode);
+		PropChange Reconcile(VirtualNode* vnode, bool parentPatched = false);
+		size_t sourceHash = 0; // hash of the virtual node this was last built or patched from
+		// the hashed props of that node, a matching hash is confirmed against them
+		StyleRef<LayoutProps> sourceLayout;
+		StyleRef<AppearanceProps> sourceAppearance;
+		TextProps sourceText;
 		void BuildRealSubtreeFromVirtual(VirtualNode* vnode);
 		void BuildSingleElementFromVirtual(VirtualNode* vnode);
 
 		// event system
 		void DistributeInputToElements(const UIEventContext& ctx);
+		void DispatchPointerEvents(const UIEventContext& ctx);
+		bool HasPointerHandlers() const;
+		Rect GetHitRect() const;
 		bool CheckElementTreeForChanges(CommandBuffer& cmd, const GpuFramebuffer* fbo, ContextResources& ctx);
 		Element* GetElementById(const SableString& id);
+		Element* GetElementById(ElementId id);
+		ElementId GetId() const { return info.internedId; }
+		void SyncId(const ElementInfo& other);
+		void RegisterId();
 
 		// rendering
 		void Render(CommandBuffer& cmd, const GpuFramebuffer* framebuffer, ContextResources& countextResources, int z = 1);
 		Rect rect = { 0, 0, 0, 0 };
 		bool clipEnabled = false;
 		Rect clipRect = { 0, 0, 0, 0 };
+		Rect subtreeBounds = { 0, 0, 0, 0 }; // rect unioned with all descendants, set during layout
 
 		// children handling
 		void LayoutChildren();
@@ -156,11 +229,19 @@ namespace SableUI
 		BaseComponent* m_owner = nullptr;
 		bool isHovered = false;
 		bool wasHovered = false;
-		std::optional<Colour> originalBg = std::nullopt;
+		// the authored bg, hoverBg in its place while hovered
+		std::optional<Colour> GetDisplayedBg() const;
 
 	private:
-		DrawableBase* drawable = nullptr;
+		// stored inline, transparent borderless rects and divs hold no drawable
+		std::variant<std::monostate, DrawableRect, DrawableImage, DrawableText> drawable;
 		RendererBackend* renderer = nullptr;
+		void UpdateRectDrawable();
+		void UpdateSubtreeBounds();
+		PropChange ReconcileKeyed(VirtualNode* vnode, bool parentPatched);
+		PropChange PatchChild(Element* childEl, VirtualNode* childVn, bool parentPatched);
+		PropChange PatchInfo(const ElementInfo& next);
+		Child* BuildChild(VirtualNode* vnode);
 	};
 
 	struct Child
@@ -0,0 +1,24 @@
+#pragma once
+#include <cstdint>
+
+namespace SableUI
+{
+	// sdf glyphs are rendered once at this pixel size and scaled for every other size
+	constexpr int SDF_REFERENCE_SIZE = 48;
+	// distance in reference pixels covered by the field on either side of the outline
+	constexpr int SDF_SPREAD = 8;
+	// stored value of a texel lying exactly on the outline, inside is higher
+	constexpr float SDF_EDGE_VALUE = 128.0f / 255.0f;
+
+	// screen pixels per unit of stored field value for text drawn at fontSize
+	float GetSdfPixelRange(int fontSize);
+
+	// coverage of a pixel from a normalised field value, text.frag does the same
+	float SdfToCoverage(float fieldValue, float pixelRange);
+
+	/* CPU reference for the sdf path of text.frag. Samples an 8-bit field
+	 * (rows tightly packed) bilinearly at texel coordinates, texel centres at
+	 * +0.5 as on the GPU with clamp to edge, and converts to coverage. */
+	float SampleSdfCoverage(const uint8_t* field, int width, int height,
+		float x, float y, float pixelRange);
+}
@@ -26,9 +26,9 @@ namespace SableUI
         float dragStartScrollY = 0.0f;
         bool barHovered = false;
 
-        std::string GetViewportID() const { return "VP_" + std::to_string((size_t)this); }
-        std::string GetContentID() const { return "CNT_" + std::to_string((size_t)this); }
-        std::string GetBarID() const { return "BAR_" + std::to_string((size_t)this); }
+        ElementId viewportID = MakeUniqueElementId();
+        ElementId contentID = MakeUniqueElementId();
+        ElementId barID = MakeUniqueElementId();
     };
 
     void ScrollUpdateHandler_Phase1(BaseComponent* comp, ScrollContext& ctx, const UIEventContext& eventCtx);
@@ -0,0 +1,53 @@
+#pragma once
+#include <SableUI/utils/utils.h>
+#include <cstdint>
+#include <vector>
+
+namespace SableUI
+{
+	class Element;
+
+	/* Uniform grid over element rects, used for pointer hit-testing.
+	 * Entries are inserted in tree order and queries return them in that
+	 * same order, so callers see the same dispatch order as a DFS walk. */
+	class SpatialIndex
+	{
+	public:
+		void Clear();
+		void Insert(Element* element, const Rect& rect);
+		void Build();
+
+		void Query(ivec2 point, std::vector<Element*>& out) const;
+		bool Contains(ivec2 point, const Element* element) const;
+
+		size_t GetNumEntries() const { return m_entries.size(); }
+		size_t GetNumCells() const { return m_cellStart.empty() ? 0 : m_cellStart.size() - 1; }
+		int GetCellSize() const { return m_cellSize; }
+
+		// stats for the last query
+		int GetLastQueryTests() const { return m_lastQueryTests; }
+
+		// cleared by the owning component whenever one of its elements moves,
+		// is destroyed or gains or loses pointer handlers or hover styling
+		bool valid = false;
+
+	private:
+		struct Entry
+		{
+			Element* element;
+			Rect rect;
+		};
+
+		bool CellOf(ivec2 point, int& cx, int& cy) const;
+
+		std::vector<Entry> m_entries;
+		std::vector<uint32_t> m_cellStart;
+		std::vector<uint32_t> m_cellItems;
+
+		Rect m_bounds = { 0, 0, 0, 0 };
+		int m_cellSize = 64;
+		int m_cols = 0;
+		int m_rows = 0;
+		mutable int m_lastQueryTests = 0;
+	};
+}
@@ -1,8 +1,10 @@
 ﻿#pragma once
 #include <string>
 #include <vector>
+#include <memory>
 #include <cstdint>
 #include <SableUI/utils/utils.h>
+#include <SableUI/core/atlas_packer.h>
 
 namespace SableUI
 {
@@ -75,6 +77,70 @@ namespace SableUI
 		TextJustification justification = TextJustification::Left
 	);
 
+	struct TextLine
+	{
+		uint32_t begin = 0;	// first source index on the line
+		uint32_t end = 0;	// one past the last, a hard break's '\n' is left out
+		float width = 0.0f;
+		uint8_t style = 0;	// style in effect at begin
+	};
+
+	/* Line breaks of one text and the caret x before every source index,
+	 * kept between edits. Update diffs the new string against the last one
+	 * and rewraps from the line before the edit until a line starts where an
+	 * old one did, the lines after it are reused as they were. Caret and
+	 * index lookups are binary searches over the line and offset tables. */
+	class TextLayout
+	{
+	public:
+		// false if nothing had to be laid out again
+		bool Update(const SableString& text, int fontSize, int maxWidth);
+		void Invalidate();
+
+		size_t GetLineCount() const { return m_lines.size(); }
+		const TextLine& GetLine(size_t line) const { return m_lines[line]; }
+
+		// line holding the caret before this source index
+		size_t GetLineOfIndex(size_t index) const;
+		// from the start of the line, without justification
+		float GetCaretX(size_t index) const;
+		// nearest caret index to x on the line
+		size_t GetIndexAt(size_t line, float x) const;
+
+		// lines laid out by the last Update, the rest were reused
+		size_t GetRewrappedLines() const { return m_rewrappedLines; }
+
+	private:
+		void Rewrap(size_t firstLine, uint32_t editEnd, int64_t delta, bool canResync);
+
+		SableString m_source;
+		int m_fontSize = 0;
+		int m_maxWidth = 0;
+		bool m_valid = false;
+		size_t m_rewrappedLines = 0;
+
+		std::vector<TextLine> m_lines;
+		std::vector<float> m_caretX; // one per source index plus the end
+	};
+
+	struct ShapedParagraph;
+
+	/* Text is shaped a hard line at a time, once per line content and font
+	 * size, into a cache shared by measurement, hit testing and drawing.
+	 * Wrapping at any width is a pass over the runs and an edit reshapes only
+	 * the lines it touched. Lines held by a text stay cached while it does,
+	 * the rest are dropped least recently used first past the byte budget. */
+	struct ParagraphCacheStats
+	{
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		size_t lines = 0;
+		size_t bytes = 0;
+		size_t budget = 0;
+	};
+
+	ParagraphCacheStats GetParagraphCacheStats();
+
 	class RendererBackend;
 	struct GpuObject;
 	struct TextCacheKey;
@@ -102,6 +168,14 @@ namespace SableUI
 		int GetMinWidth(bool wrapped);
 		int GetUnwrappedHeight();
 
+		// call before drawing, rasterises and builds the vertices after a layout or an
+		// eviction and marks the layers in use. layout alone never touches the atlas
+		void PrepareAtlas();
+
+		// caret and hit testing against the wrapped lines as drawn, local to the text
+		CursorPosition GetCursorPosition(size_t index);
+		size_t GetIndexAtPoint(ivec2 point);
+
 		SableString m_content;
 		Colour m_colour = { 255, 255, 255, 255 };
 		int m_fontSize = 0;
@@ -115,14 +189,46 @@ namespace SableUI
 		GpuObject* m_gpuObject = nullptr;
 		uint32_t indiciesSize = 0;
 		RendererBackend* m_renderer = nullptr;
+		uint64_t m_atlasGeneration = 0;	// atlas generation the gpu object was built against
+		uint64_t m_atlasLayers = 0;		// bit per atlas layer sampled, see PrepareAtlas()
+		bool m_gpuStale = false;		// laid out since the vertices were built, see PrepareAtlas()
+		mutable TextLayout m_layout;	// line breaks as last drawn or queried, reused across edits
 
 	private:
+		void Rebuild();
+		void BuildGpuObject();
+		const ShapedParagraph& GetShaped();
 		std::vector<TextCacheKey> m_cacheKeys;
+		std::shared_ptr<const ShapedParagraph> m_shaped;
 	};
 
-	GpuObject* GetTextGpuObject(const _Text* text, int& height, int& maxWidth);
+	GpuObject* GetTextGpuObject(const _Text* text, int& height, int& maxWidth, uint64_t& atlasLayers);
 
 	const GpuTexture2DArray* GetTextAtlasTexture();
+
+	/* Glyphs share a texture array of at most this many 512x512 layers, the
+	 * least recently drawn layer is reclaimed once it is full. Layers drawn
+	 * in the current frame are never reclaimed, the array grows past the
+	 * budget instead. */
+	void SetFontAtlasLayerBudget(int layers);
+	AtlasStats GetFontAtlasStats();
+	uint64_t GetFontAtlasGeneration();
+	void AdvanceFontAtlasFrame();
+
+	enum class GlyphRenderMode
+	{
+		Bitmap,	// coverage rasterised per font size, hinted
+		SDF		// one distance field per glyph at SDF_REFERENCE_SIZE, scaled to every size
+	};
+
+	/* SDF keeps atlas memory flat when many font sizes are on screen (e.g.
+	 * zoomable panels), at the cost of unhinted shapes at small sizes. Layout
+	 * metrics are the same in both modes. Switching drops every rasterised
+	 * glyph, text rebuilds the next time it is drawn. */
+	void SetGlyphRenderMode(GlyphRenderMode mode);
+	GlyphRenderMode GetGlyphRenderMode();
+	// pixel range for the text shader, 0 in bitmap mode
+	float GetTextSdfRange(int fontSize);
 	void SetFontDPI(const vec2& dpi);
 	void InitFontManager();
 	void DestroyFontManager();
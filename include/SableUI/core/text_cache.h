@@ -1,9 +1,11 @@
 #pragma once
 #include <unordered_map>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <vector>
+#include <SableUI/utils/utils.h>
 
 namespace SableUI
 {
@@ -14,21 +16,27 @@ namespace SableUI
 	struct TextCacheKey
 	{
 		TextCacheKey(const _Text* text);
-		uint64_t stringHash;
+		SableString content;
+		Colour colour;
 		int maxWidth;
 		int fontSize;
 		int maxHeight;
 		int lineSpacingPx;
 		TextJustification justification;
+		uint64_t atlasGeneration;
 
 		bool operator==(const TextCacheKey& other) const
 		{
-			return stringHash == other.stringHash &&
+			// copies of one string share its buffer, only a different buffer is compared
+			return atlasGeneration == other.atlasGeneration &&
 				maxWidth == other.maxWidth &&
 				fontSize == other.fontSize &&
 				maxHeight == other.maxHeight &&
 				lineSpacingPx == other.lineSpacingPx &&
-				justification == other.justification;
+				justification == other.justification &&
+				colour == other.colour &&
+				content.size() == other.content.size() &&
+				(content.begin() == other.content.begin() || content == other.content);
 		}
 	};
 }
@@ -41,13 +49,17 @@ namespace std
 		std::size_t operator()(const SableUI::TextCacheKey& key) const noexcept
 		{
 			std::size_t h = 0;
+			uint32_t colour = (static_cast<uint32_t>(key.colour.r) << 24) | (static_cast<uint32_t>(key.colour.g) << 16) |
+				(static_cast<uint32_t>(key.colour.b) << 8) | key.colour.a;
 
-			h ^= std::hash<uint64_t>()(key.stringHash) + 0x9e3779b9 + (h << 6) + (h >> 2);
+			h ^= std::hash<SableUI::String>()(key.content) + 0x9e3779b9 + (h << 6) + (h >> 2);
+			h ^= std::hash<uint32_t>()(colour) + 0x9e3779b9 + (h << 6) + (h >> 2);
 			h ^= std::hash<int>()(key.maxWidth) + 0x9e3779b9 + (h << 6) + (h >> 2);
 			h ^= std::hash<int>()(key.fontSize) + 0x9e3779b9 + (h << 6) + (h >> 2);
 			h ^= std::hash<int>()(key.maxHeight) + 0x9e3779b9 + (h << 6) + (h >> 2);
 			h ^= std::hash<int>()(key.lineSpacingPx) + 0x9e3779b9 + (h << 6) + (h >> 2);
 			h ^= std::hash<int>()(static_cast<int>(key.justification)) + 0x9e3779b9 + (h << 6) + (h >> 2);
+			h ^= std::hash<uint64_t>()(key.atlasGeneration) + 0x9e3779b9 + (h << 6) + (h >> 2);
 
 			return h;
 		}
@@ -62,28 +74,68 @@ namespace SableUI
 		int refCount;
 		int maxWidth;
 		int height;
+		uint64_t atlasLayers;
 		int lastConsumedFrame;
+		size_t bytes;	// vertex and index buffers plus the key's text
+
+		// unreferenced entries only, most recently released at the head
+		const TextCacheKey* key = nullptr;
+		TextCache* idlePrev = nullptr;
+		TextCache* idleNext = nullptr;
 
 		bool operator==(const TextCache& other) const { return gpuObject == other.gpuObject; }
 	};
 
+	struct TextCacheStats
+	{
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		uint64_t evictions = 0;
+		size_t entries = 0;
+		size_t idleEntries = 0;
+		size_t bytes = 0;
+		size_t budget = 0;
+	};
+
+	/* Text gpu objects shared by every text with the same key, one factory
+	 * per renderer. Entries no text holds stay cached in least recently
+	 * released order and are destroyed oldest first once the factory's
+	 * buffers and the text of its keys outgrow the memory budget. Entries in use are never evicted,
+	 * the budget is exceeded instead. */
 	class TextCacheFactory
 	{
 	public:
-		static GpuObject* Get(const _Text* key, int& height);
+		static GpuObject* Get(const _Text* key, int& height, uint64_t& atlasLayers);
 		static void Release(RendererBackend* renderer, const TextCacheKey& key);
 		static void ShutdownFactory(RendererBackend* renderer);
 		static void CleanCache(RendererBackend* renderer);
 
+		// bytes of buffers and key text each factory may keep, applied at the next clean
+		static void SetMemoryBudget(size_t bytes);
+		static size_t GetMemoryBudget();
+
 		static std::vector<const TextCacheFactory*> GetFactories();
 		int GetNumInstances() const;
+		TextCacheStats GetStats() const;
 
 	private:
 		void CleanCache_priv();
 		int m_currentFrame = 0;
-		GpuObject* Get_priv(const _Text* key, int& height);
+		GpuObject* Get_priv(const _Text* key, int& height, uint64_t& atlasLayers);
 		void Release_priv(TextCacheKey key);
 		void Delete(TextCacheKey key);
+
+		void LinkIdle(TextCache& entry);
+		void UnlinkIdle(TextCache& entry);
+
 		std::unordered_map<TextCacheKey, TextCache> m_cache;
+		TextCache* m_idleHead = nullptr;
+		TextCache* m_idleTail = nullptr;
+		size_t m_idleCount = 0;
+		size_t m_bytes = 0;
+
+		uint64_t m_hits = 0;
+		uint64_t m_misses = 0;
+		uint64_t m_evictions = 0;
 	};
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include <SableUI/utils/memory.h>
 #include <SableUI/utils/console.h>
 #include <SableUI/core/drawable.h>
+#include <SableUI/core/dirty_queue.h>
 
 #include <string>
 #include <array>
@@ -75,6 +76,7 @@ namespace SableUI
 		void RemoveQueueReference(CustomTargetQueue* queue);
 		GpuFramebuffer* GetSurface() { return &m_windowSurface; }
 		RendererBackend* GetBaseRenderer() const { return m_baseRenderer; }
+		DirtyQueue& GetDirtyQueue() { return m_dirtyQueue; }
 
 		void MakeContextCurrent();
 		bool IsMinimized() const;
@@ -93,6 +95,7 @@ namespace SableUI
 		ResizeState m_resizeState;
 
 		RootPanel* m_root = nullptr;
+		DirtyQueue m_dirtyQueue;
 		bool m_resizing = false;
 		bool m_isMinimized = false;
 
@@ -121,6 +124,7 @@ namespace SableUI
 		std::array<ivec2, SABLE_MAX_MOUSE_BUTTONS> m_lastClickPos = {};
 
 		std::vector<CustomTargetQueue*> m_customTargetQueues;
+		bool m_customQueuesChanged = false;
 
 	private:
 		int m_syncFrames = 2;
@@ -46,6 +46,7 @@ namespace SableUI
 		void Unbind(uint32_t slot = 0) const;
 		void Init(int width, int height, int depth);
 		void Resize(int newDepth);
+		void SetLinearFiltering(bool linear);
 		void SubImage(int xOffset, int yOffset, int zOffset, int width, int height,
 			int depth, const uint8_t* pixels);
 		void CopyImageSubData(const GpuTexture2DArray& src, int srcX, int srcY, int srcZ,
@@ -53,5 +54,6 @@ namespace SableUI
 
 	private:
 		int m_width = 0, m_height = 0, m_depth = 0;
+		bool m_linear = false;
 	};
 }
\ No newline at end of file
@@ -47,6 +47,7 @@ namespace SableUI
 		void SetBlendState(bool enabled, BlendFactor src, BlendFactor dst);
 		void SetScissor(int x, int y, int width, int height);
 		void DisableScissor();
+		const std::optional<Rect>& GetScissor() const { return m_state.scissor; }
 
 		void BindGpuObject(uint32_t handle);
 		void BindUniformBuffer(uint32_t binding, uint32_t ubo);
@@ -80,6 +81,7 @@ namespace SableUI
 		struct State
 		{
 			std::optional<PipelineType> pipeline;
+			std::optional<Rect> scissor;
 		} m_state;
 	};
 
@@ -8,7 +8,7 @@ namespace SableUI
 	class Ref : public StateBase {
 	public:
 		Ref(BaseComponent* owner, T initialValue)
-			: m_value(initialValue) {
+			: m_value(initialValue), m_owner(owner) {
 			owner->RegisterState(this);
 		}
 
@@ -21,17 +21,20 @@ namespace SableUI
 		T& get() { return m_value; }
 
 		void set(const T& newValue) {
+			// values passed to Init only seed a new instance
+			if (m_owner->IsHoldingState()) return;
 			m_value = newValue;
 		}
 
 		operator const T& () const { return m_value; }
 
 		Ref& operator=(const T& newValue) {
-			m_value = newValue;
+			set(newValue);
 			return *this;
 		}
 
 	private:
 		T m_value;
+		BaseComponent* m_owner;
 	};
 }
\ No newline at end of file
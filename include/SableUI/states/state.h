@@ -23,6 +23,8 @@ namespace SableUI
 		const T& get() const { return m_value; }
 
 		void set(const T& newValue) {
+			// values passed to Init only seed a new instance
+			if (m_owner->IsHoldingState()) return;
 			if (m_value == newValue) return;
 			m_value = newValue;
 			m_owner->MarkDirty();
@@ -0,0 +1,149 @@
+#pragma once
+#include <SableUI/states/state_base.h>
+#include <SableUI/states/state.h>
+#include <SableUI/core/component.h>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace SableUI
+{
+	class StoreSubscriber
+	{
+	public:
+		virtual ~StoreSubscriber() = default;
+		virtual void OnStoreChanged() = 0;
+		virtual void OnStoreDestroyed() = 0;
+	};
+
+	class StoreBase
+	{
+	public:
+		StoreBase(const StoreBase&) = delete;
+		StoreBase& operator=(const StoreBase&) = delete;
+
+		uint64_t GetVersion() const { return m_version; }
+		size_t GetNumSubscribers() const;
+
+		void Subscribe(StoreSubscriber* subscriber);
+		void Unsubscribe(StoreSubscriber* subscriber);
+
+	protected:
+		StoreBase() = default;
+		~StoreBase();
+
+		void Notify();
+
+	private:
+		std::vector<StoreSubscriber*> m_subscribers;
+		uint64_t m_version = 0;
+		bool m_notifying = false;
+	};
+
+	/* Data shared between components that do not own it, e.g. a selection
+	 * model or a connection status read by several panels. Components read it
+	 * through a Selector and only rerender when their selected slice changes.
+	 * Must be modified from the ui thread. */
+	template <typename T>
+	class Store : public StoreBase
+	{
+	public:
+		Store(T initialValue = T{}) : m_value(std::move(initialValue)) {}
+
+		const T& get() const { return m_value; }
+
+		void set(const T& newValue) {
+			m_value = newValue;
+			Notify();
+		}
+
+		// modify in place, fn is called as fn(T&)
+		template <typename Fn>
+		void update(Fn&& fn) {
+			fn(m_value);
+			Notify();
+		}
+
+	private:
+		T m_value;
+	};
+
+	// value computed from a store, recomputed at most once per store change
+	template <typename T, typename S>
+	class Derived
+	{
+	public:
+		Derived(const Store<T>& store, std::function<S(const T&)> compute)
+			: m_store(store), m_compute(std::move(compute)) {}
+
+		const S& get() {
+			if (!m_valid || m_version != m_store.GetVersion())
+			{
+				m_value = m_compute(m_store.get());
+				m_version = m_store.GetVersion();
+				m_valid = true;
+			}
+
+			return m_value;
+		}
+
+		operator const S& () { return get(); }
+
+	private:
+		const Store<T>& m_store;
+		std::function<S(const T&)> m_compute;
+		S m_value{};
+		uint64_t m_version = 0;
+		bool m_valid = false;
+	};
+
+	// component state holding a slice of a store, the owner is marked dirty
+	// only when the slice compares unequal to the last one
+	template <typename T, typename S>
+	class Selector : public StateBase, private StoreSubscriber
+	{
+		static_assert(HasEqualityOperator<S>, "Selector<T, S> requires S to have an operator== overloaded");
+
+	public:
+		Selector(BaseComponent* owner, Store<T>& store, std::function<S(const T&)> select)
+			: m_owner(owner), m_store(&store), m_select(std::move(select)), m_value(m_select(store.get())) {
+			store.Subscribe(this);
+			owner->RegisterState(this);
+		}
+
+		~Selector() {
+			if (m_store) m_store->Unsubscribe(this);
+		}
+
+		Selector(const Selector&) = delete;
+		Selector& operator=(const Selector&) = delete;
+
+		const S& get() const { return m_value; }
+		operator const S& () const { return m_value; }
+
+		void Sync(StateBase* other) override {
+			if (!other) return;
+			auto* otherPtr = static_cast<Selector<T, S>*>(other);
+			this->m_value = otherPtr->m_value;
+		}
+
+	private:
+		void OnStoreChanged() override {
+			S next = m_select(m_store->get());
+			if (next == m_value) return;
+
+			m_value = std::move(next);
+			m_owner->MarkDirty();
+		}
+
+		void OnStoreDestroyed() override {
+			m_store = nullptr;
+		}
+
+		BaseComponent* m_owner;
+		Store<T>* m_store;
+		std::function<S(const T&)> m_select;
+		S m_value;
+	};
+}
@@ -0,0 +1,168 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+
+namespace SableUI
+{
+	struct StyleInternStats
+	{
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		size_t records = 0;
+	};
+
+	/* Refcounted handle to an immutable block of style props. Records are
+	 * interned by value, so identically styled elements share one record and
+	 * diffing can stop at pointer equality. Writes go through mut(), which
+	 * copies the record first if it is shared. T needs operator== and a
+	 * HashStyle(const T&) overload. Not thread safe, ui thread only. */
+	template <typename T>
+	class StyleRef
+	{
+	public:
+		StyleRef() : m_record(DefaultRecord()) { m_record->refs++; }
+		StyleRef(const StyleRef& other) : m_record(other.m_record) { m_record->refs++; }
+		StyleRef(StyleRef&& other) noexcept : m_record(other.m_record) { other.m_record = DefaultRecord(); other.m_record->refs++; }
+		~StyleRef() { Release(m_record); }
+
+		StyleRef& operator=(const StyleRef& other)
+		{
+			if (m_record == other.m_record) return *this;
+			other.m_record->refs++;
+			Release(m_record);
+			m_record = other.m_record;
+			return *this;
+		}
+
+		StyleRef& operator=(StyleRef&& other) noexcept
+		{
+			if (this != &other) std::swap(m_record, other.m_record);
+			return *this;
+		}
+
+		const T& get() const { return m_record->value; }
+		const T& operator*() const { return m_record->value; }
+		const T* operator->() const { return &m_record->value; }
+
+		T& mut()
+		{
+			if (m_record->interned || m_record->refs > 1)
+			{
+				Record* copy = new Record{ m_record->value };
+				Release(m_record);
+				m_record = copy;
+			}
+
+			m_record->hash = 0;
+			return m_record->value;
+		}
+
+		// swaps a private record for the shared one with the same props
+		void Intern()
+		{
+			if (m_record->interned) return;
+
+			size_t hash = Hash();
+			Table& table = GetTable();
+
+			auto range = table.equal_range(hash);
+			for (auto it = range.first; it != range.second; it++)
+			{
+				if (it->second->value == m_record->value)
+				{
+					it->second->refs++;
+					Release(m_record);
+					m_record = it->second;
+					GetStats().hits++;
+					return;
+				}
+			}
+
+			// other handles to a private record share it from here on too
+			m_record->interned = true;
+			table.emplace(hash, m_record);
+			GetStats().misses++;
+			GetStats().records = table.size();
+		}
+
+		size_t Hash() const
+		{
+			if (m_record->hash == 0)
+			{
+				size_t h = HashStyle(m_record->value);
+				m_record->hash = (h != 0) ? h : 1;
+			}
+
+			return m_record->hash;
+		}
+
+		bool SameRecord(const StyleRef& other) const { return m_record == other.m_record; }
+
+		bool operator==(const StyleRef& other) const
+		{
+			if (m_record == other.m_record) return true;
+			if (m_record->interned && other.m_record->interned) return false;
+			return Hash() == other.Hash() && m_record->value == other.m_record->value;
+		}
+
+		static const StyleInternStats& GetInternStats() { return GetStats(); }
+
+	private:
+		struct Record
+		{
+			T value;
+			uint32_t refs = 1;
+			size_t hash = 0;
+			bool interned = false;
+		};
+
+		using Table = std::unordered_multimap<size_t, Record*>;
+
+		static Record* DefaultRecord()
+		{
+			// never freed, default constructed props are shared without interning
+			static Record* record = new Record{ T{}, 1 };
+			return record;
+		}
+
+		static Table& GetTable()
+		{
+			// leaked like the default record so handles in static objects can outlive it
+			static Table* table = new Table();
+			return *table;
+		}
+
+		static StyleInternStats& GetStats()
+		{
+			static StyleInternStats stats;
+			return stats;
+		}
+
+		static void Release(Record* record)
+		{
+			if (--record->refs > 0) return;
+
+			if (record->interned)
+			{
+				Table& table = GetTable();
+				auto range = table.equal_range(record->hash);
+				for (auto it = range.first; it != range.second; it++)
+				{
+					if (it->second == record)
+					{
+						table.erase(it);
+						break;
+					}
+				}
+
+				GetStats().records = table.size();
+			}
+
+			delete record;
+		}
+
+		Record* m_record;
+	};
+}
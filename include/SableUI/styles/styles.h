@@ -39,167 +39,181 @@ namespace SableUI::Style
 	inline Property<SableString> id(SableString v) {
 		return { std::move(v), [](ElementInfo& i, SableString val) { i.id = std::move(val); } };
 	}
+	inline constexpr Property<ElementId> id(ElementId v) {
+		return { v, [](ElementInfo& i, ElementId val) { i.internedId = val; } };
+	}
+
+	// sibling keys, keyed children are matched by key instead of position.
+	// integer and string keys are tagged so key(0) is still a key. string keys
+	// are hashed rather than interned, so a list keyed by row names leaves
+	// nothing behind once its rows are gone
+	inline constexpr Property<uint64_t> key(uint64_t v) {
+		return { v | (1ull << 63), [](ElementInfo& i, uint64_t val) { i.key = val; } };
+	}
+	inline Property<uint64_t> key(const SableString& v) {
+		return { (1ull << 62) | (v.Hash() & ((1ull << 62) - 1)), [](ElementInfo& i, uint64_t val) { i.key = val; } };
+	}
 
 	// sizing
 	inline constexpr Property<int> w(int v) {
-		return { v, [](ElementInfo& i, int val) { i.layout.width = val; i.layout.minW = val; i.layout.wType = RectType::Fixed; } };
+		return { v, [](ElementInfo& i, int val) { i.layout.mut().width = val; i.layout.mut().minW = val; i.layout.mut().wType = RectType::Fixed; } };
 	}
 	inline constexpr Property<int> h(int v) {
-		return { v, [](ElementInfo& i, int val) { i.layout.height = val; i.layout.minH = val; i.layout.hType = RectType::Fixed; } };
+		return { v, [](ElementInfo& i, int val) { i.layout.mut().height = val; i.layout.mut().minH = val; i.layout.mut().hType = RectType::Fixed; } };
 	}
-	inline constexpr Property<int> minW(int v) { return { v, [](ElementInfo& i, int val) { i.layout.minW = val; } }; }
-	inline constexpr Property<int> maxW(int v) { return { v, [](ElementInfo& i, int val) { i.layout.maxW = val; } }; }
-	inline constexpr Property<int> minH(int v) { return { v, [](ElementInfo& i, int val) { i.layout.minH = val; } }; }
-	inline constexpr Property<int> maxH(int v) { return { v, [](ElementInfo& i, int val) { i.layout.maxH = val; } }; }
+	inline constexpr Property<int> minW(int v) { return { v, [](ElementInfo& i, int val) { i.layout.mut().minW = val; } }; }
+	inline constexpr Property<int> maxW(int v) { return { v, [](ElementInfo& i, int val) { i.layout.mut().maxW = val; } }; }
+	inline constexpr Property<int> minH(int v) { return { v, [](ElementInfo& i, int val) { i.layout.mut().minH = val; } }; }
+	inline constexpr Property<int> maxH(int v) { return { v, [](ElementInfo& i, int val) { i.layout.mut().maxH = val; } }; }
 
 	// rect type flags
-	inline constexpr FlagProperty w_fill = { [](ElementInfo& i) { i.layout.wType = RectType::Fill; } };
-	inline constexpr FlagProperty h_fill = { [](ElementInfo& i) { i.layout.hType = RectType::Fill; } };
-	inline constexpr FlagProperty w_fixed = { [](ElementInfo& i) { i.layout.wType = RectType::Fixed; } };
-	inline constexpr FlagProperty h_fixed = { [](ElementInfo& i) { i.layout.hType = RectType::Fixed; } };
-	inline constexpr FlagProperty w_fit = { [](ElementInfo& i) { i.layout.wType = RectType::FitContent; } };
-	inline constexpr FlagProperty h_fit = { [](ElementInfo& i) { i.layout.hType = RectType::FitContent; } };
+	inline constexpr FlagProperty w_fill = { [](ElementInfo& i) { i.layout.mut().wType = RectType::Fill; } };
+	inline constexpr FlagProperty h_fill = { [](ElementInfo& i) { i.layout.mut().hType = RectType::Fill; } };
+	inline constexpr FlagProperty w_fixed = { [](ElementInfo& i) { i.layout.mut().wType = RectType::Fixed; } };
+	inline constexpr FlagProperty h_fixed = { [](ElementInfo& i) { i.layout.mut().hType = RectType::Fixed; } };
+	inline constexpr FlagProperty w_fit = { [](ElementInfo& i) { i.layout.mut().wType = RectType::FitContent; } };
+	inline constexpr FlagProperty h_fit = { [](ElementInfo& i) { i.layout.mut().hType = RectType::FitContent; } };
 
 	// alignment
-	inline constexpr FlagProperty centerX = { [](ElementInfo& i) { i.layout.centerX = true; } };
-	inline constexpr FlagProperty centerY = { [](ElementInfo& i) { i.layout.centerY = true; } };
-	inline constexpr FlagProperty centerXY = { [](ElementInfo& i) { i.layout.centerX = i.layout.centerY = true; } };
-	inline constexpr FlagProperty clipChildren = { [](ElementInfo& i) {i.appearance.clipChildren = true; }};
+	inline constexpr FlagProperty centerX = { [](ElementInfo& i) { i.layout.mut().centerX = true; } };
+	inline constexpr FlagProperty centerY = { [](ElementInfo& i) { i.layout.mut().centerY = true; } };
+	inline constexpr FlagProperty centerXY = { [](ElementInfo& i) { i.layout.mut().centerX = i.layout.mut().centerY = true; } };
+	inline constexpr FlagProperty clipChildren = { [](ElementInfo& i) {i.appearance.mut().clipChildren = true; }};
 
 	// layout dirs
 	inline constexpr Property<LayoutDirection> dir(LayoutDirection v) {
-		return { v, [](ElementInfo& i, LayoutDirection val) { i.layout.layoutDirection = val; } };
+		return { v, [](ElementInfo& i, LayoutDirection val) { i.layout.mut().layoutDirection = val; } };
 	}
-	inline constexpr FlagProperty left_right = { [](ElementInfo& i) { i.layout.layoutDirection = LayoutDirection::LeftRight; } };
-	inline constexpr FlagProperty right_left = { [](ElementInfo& i) { i.layout.layoutDirection = LayoutDirection::RightLeft; } };
-	inline constexpr FlagProperty up_down = { [](ElementInfo& i) { i.layout.layoutDirection = LayoutDirection::UpDown; } };
-	inline constexpr FlagProperty down_up = { [](ElementInfo& i) { i.layout.layoutDirection = LayoutDirection::DownUp; } };
+	inline constexpr FlagProperty left_right = { [](ElementInfo& i) { i.layout.mut().layoutDirection = LayoutDirection::LeftRight; } };
+	inline constexpr FlagProperty right_left = { [](ElementInfo& i) { i.layout.mut().layoutDirection = LayoutDirection::RightLeft; } };
+	inline constexpr FlagProperty up_down = { [](ElementInfo& i) { i.layout.mut().layoutDirection = LayoutDirection::UpDown; } };
+	inline constexpr FlagProperty down_up = { [](ElementInfo& i) { i.layout.mut().layoutDirection = LayoutDirection::DownUp; } };
 
 	// margins
-	inline constexpr Property<int> m(int v) { return { v, [](ElementInfo& i, int val) { i.layout.mT = i.layout.mB = i.layout.mL = i.layout.mR = val; } }; }
-	inline constexpr Property<int> mx(int v) { return { v, [](ElementInfo& i, int val) { i.layout.mL = i.layout.mR = val; } }; }
-	inline constexpr Property<int> my(int v) { return { v, [](ElementInfo& i, int val) { i.layout.mT = i.layout.mB = val; } }; }
-	inline constexpr Property<int> mt(int v) { return { v, [](ElementInfo& i, int val) { i.layout.mT = val; } }; }
-	inline constexpr Property<int> mb(int v) { return { v, [](ElementInfo& i, int val) { i.layout.mB = val; } }; }
-	inline constexpr Property<int> ml(int v) { return { v, [](ElementInfo& i, int val) { i.layout.mL = val; } }; }
-	inline constexpr Property<int> mr(int v) { return { v, [](ElementInfo& i, int val) { i.layout.mR = val; } }; }
+	inline constexpr Property<int> m(int v) { return { v, [](ElementInfo& i, int val) { i.layout.mut().mT = i.layout.mut().mB = i.layout.mut().mL = i.layout.mut().mR = val; } }; }
+	inline constexpr Property<int> mx(int v) { return { v, [](ElementInfo& i, int val) { i.layout.mut().mL = i.layout.mut().mR = val; } }; }
+	inline constexpr Property<int> my(int v) { return { v, [](ElementInfo& i, int val) { i.layout.mut().mT = i.layout.mut().mB = val; } }; }
+	inline constexpr Property<int> mt(int v) { return { v, [](ElementInfo& i, int val) { i.layout.mut().mT = val; } }; }
+	inline constexpr Property<int> mb(int v) { return { v, [](ElementInfo& i, int val) { i.layout.mut().mB = val; } }; }
+	inline constexpr Property<int> ml(int v) { return { v, [](ElementInfo& i, int val) { i.layout.mut().mL = val; } }; }
+	inline constexpr Property<int> mr(int v) { return { v, [](ElementInfo& i, int val) { i.layout.mut().mR = val; } }; }
 
 	// padding
-	inline constexpr Property<int> p(int v) { return { v, [](ElementInfo& i, int val) { i.layout.pT = i.layout.pB = i.layout.pL = i.layout.pR = val; } }; }
-	inline constexpr Property<int> px(int v) { return { v, [](ElementInfo& i, int val) { i.layout.pL = i.layout.pR = val; } }; }
-	inline constexpr Property<int> py(int v) { return { v, [](ElementInfo& i, int val) { i.layout.pT = i.layout.pB = val; } }; }
-	inline constexpr Property<int> pt(int v) { return { v, [](ElementInfo& i, int val) { i.layout.pT = val; } }; }
-	inline constexpr Property<int> pb(int v) { return { v, [](ElementInfo& i, int val) { i.layout.pB = val; } }; }
-	inline constexpr Property<int> pl(int v) { return { v, [](ElementInfo& i, int val) { i.layout.pL = val; } }; }
-	inline constexpr Property<int> pr(int v) { return { v, [](ElementInfo& i, int val) { i.layout.pR = val; } }; }
+	inline constexpr Property<int> p(int v) { return { v, [](ElementInfo& i, int val) { i.layout.mut().pT = i.layout.mut().pB = i.layout.mut().pL = i.layout.mut().pR = val; } }; }
+	inline constexpr Property<int> px(int v) { return { v, [](ElementInfo& i, int val) { i.layout.mut().pL = i.layout.mut().pR = val; } }; }
+	inline constexpr Property<int> py(int v) { return { v, [](ElementInfo& i, int val) { i.layout.mut().pT = i.layout.mut().pB = val; } }; }
+	inline constexpr Property<int> pt(int v) { return { v, [](ElementInfo& i, int val) { i.layout.mut().pT = val; } }; }
+	inline constexpr Property<int> pb(int v) { return { v, [](ElementInfo& i, int val) { i.layout.mut().pB = val; } }; }
+	inline constexpr Property<int> pl(int v) { return { v, [](ElementInfo& i, int val) { i.layout.mut().pL = val; } }; }
+	inline constexpr Property<int> pr(int v) { return { v, [](ElementInfo& i, int val) { i.layout.mut().pR = val; } }; }
 
 	// borders
 	inline constexpr Property<int> b(int v) {
 		return { v, [](ElementInfo& i, int val) {
-			i.layout.bT = i.layout.bB = i.layout.bL = i.layout.bR = val;
+			i.layout.mut().bT = i.layout.mut().bB = i.layout.mut().bL = i.layout.mut().bR = val;
 		} };
 	}
 	inline constexpr Property<int> bx(int v) {
-		return { v, [](ElementInfo& i, int val) { i.layout.bL = i.layout.bR = val; } };
+		return { v, [](ElementInfo& i, int val) { i.layout.mut().bL = i.layout.mut().bR = val; } };
 	}
 	inline constexpr Property<int> by(int v) {
-		return { v, [](ElementInfo& i, int val) { i.layout.bT = i.layout.bB = val; } };
+		return { v, [](ElementInfo& i, int val) { i.layout.mut().bT = i.layout.mut().bB = val; } };
 	}
 	inline constexpr Property<int> bt(int v) {
-		return { v, [](ElementInfo& i, int val) { i.layout.bT = val; } };
+		return { v, [](ElementInfo& i, int val) { i.layout.mut().bT = val; } };
 	}
 	inline constexpr Property<int> bb(int v) {
-		return { v, [](ElementInfo& i, int val) { i.layout.bB = val; } };
+		return { v, [](ElementInfo& i, int val) { i.layout.mut().bB = val; } };
 	}
 	inline constexpr Property<int> bl(int v) {
-		return { v, [](ElementInfo& i, int val) { i.layout.bL = val; } };
+		return { v, [](ElementInfo& i, int val) { i.layout.mut().bL = val; } };
 	}
 	inline constexpr Property<int> br(int v) {
-		return { v, [](ElementInfo& i, int val) { i.layout.bR = val; } };
+		return { v, [](ElementInfo& i, int val) { i.layout.mut().bR = val; } };
 	}
 
 	// bg colours
 	inline constexpr Property<Colour> bg(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255) {
-		return { Colour(r, g, b, a), [](ElementInfo& i, Colour val) { i.appearance.bg = val; } };
+		return { Colour(r, g, b, a), [](ElementInfo& i, Colour val) { i.appearance.mut().bg = val; } };
 	}
 	inline constexpr Property<Colour> bg(Colour c) {
-		return { c, [](ElementInfo& i, Colour val) { i.appearance.bg = val; } };
+		return { c, [](ElementInfo& i, Colour val) { i.appearance.mut().bg = val; } };
 	}
 	inline constexpr Property<bool> inheritBg(bool v) {
-		return { v, [](ElementInfo& i, bool val) { i.appearance.inheritBg = val; } };
+		return { v, [](ElementInfo& i, bool val) { i.appearance.mut().inheritBg = val; } };
 	}
 
 	// border radius
 	inline constexpr Property<float> rounded(float r) {
 		return { r, [](ElementInfo& i, float val) { 
-			i.appearance.rTL = val; 
-			i.appearance.rTR = val; 
-			i.appearance.rBL = val;
-			i.appearance.rBR = val; 
+			i.appearance.mut().rTL = val; 
+			i.appearance.mut().rTR = val; 
+			i.appearance.mut().rBL = val;
+			i.appearance.mut().rBR = val; 
 		} };
 	}
 	inline constexpr Property<float> roundedTL(float r) {
-		return { r, [](ElementInfo& i, float v) { i.appearance.rTL = v; } };
+		return { r, [](ElementInfo& i, float v) { i.appearance.mut().rTL = v; } };
 	}
 
 	inline constexpr Property<float> roundedTR(float r) {
-		return { r, [](ElementInfo& i, float v) { i.appearance.rTR = v; } };
+		return { r, [](ElementInfo& i, float v) { i.appearance.mut().rTR = v; } };
 	}
 
 	inline constexpr Property<float> roundedBL(float r) {
-		return { r, [](ElementInfo& i, float v) { i.appearance.rBL = v; } };
+		return { r, [](ElementInfo& i, float v) { i.appearance.mut().rBL = v; } };
 	}
 
 	inline constexpr Property<float> roundedBR(float r) {
-		return { r, [](ElementInfo& i, float v) { i.appearance.rBR = v; } };
+		return { r, [](ElementInfo& i, float v) { i.appearance.mut().rBR = v; } };
 	}
 	inline constexpr Property<float> roundedTop(float r) {
 		return { r, [](ElementInfo& i, float v) {
-			i.appearance.rTL = v;
-			i.appearance.rTR = v;
+			i.appearance.mut().rTL = v;
+			i.appearance.mut().rTR = v;
 		} };
 	}
 
 	inline constexpr Property<float> roundedBottom(float r) {
 		return { r, [](ElementInfo& i, float v) {
-			i.appearance.rBL = v;
-			i.appearance.rBR = v;
+			i.appearance.mut().rBL = v;
+			i.appearance.mut().rBR = v;
 		} };
 	}
 
 	inline constexpr Property<float> roundedLeft(float r) {
 		return { r, [](ElementInfo& i, float v) {
-			i.appearance.rTL = v;
-			i.appearance.rBL = v;
+			i.appearance.mut().rTL = v;
+			i.appearance.mut().rBL = v;
 		} };
 	}
 
 	inline constexpr Property<float> roundedRight(float r) {
 		return { r, [](ElementInfo& i, float v) {
-			i.appearance.rTR = v;
-			i.appearance.rBR = v;
+			i.appearance.mut().rTR = v;
+			i.appearance.mut().rBR = v;
 		} };
 	}
 
 	// border colour
 	inline constexpr Property<Colour> borderColour(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255) {
-		return { Colour(r, g, b, a), [](ElementInfo& i, Colour val) { i.appearance.borderColour = val; } };
+		return { Colour(r, g, b, a), [](ElementInfo& i, Colour val) { i.appearance.mut().borderColour = val; } };
 	}
 
 	inline constexpr Property<Colour> borderColour(Colour c) {
-		return { c, [](ElementInfo& i, Colour val) { i.appearance.borderColour = val; } };
+		return { c, [](ElementInfo& i, Colour val) { i.appearance.mut().borderColour = val; } };
 	}
 
 	// overflow
-	inline constexpr FlagProperty overflow_hidden = { [](ElementInfo& i) { i.appearance.clipChildren = true; } };
+	inline constexpr FlagProperty overflow_hidden = { [](ElementInfo& i) { i.appearance.mut().clipChildren = true; } };
 
 	// sizes
-	inline constexpr FlagProperty size_sm = { [](ElementInfo& i) {i.appearance.size = ComponentSize::Small; } };
-	inline constexpr FlagProperty size_md = { [](ElementInfo& i) {i.appearance.size = ComponentSize::Medium; } };
-	inline constexpr FlagProperty size_lg = { [](ElementInfo& i) {i.appearance.size = ComponentSize::Large; } };
-	inline constexpr FlagProperty size_none = { [](ElementInfo& i) {i.appearance.size = ComponentSize::None; } };
+	inline constexpr FlagProperty size_sm = { [](ElementInfo& i) {i.appearance.mut().size = ComponentSize::Small; } };
+	inline constexpr FlagProperty size_md = { [](ElementInfo& i) {i.appearance.mut().size = ComponentSize::Medium; } };
+	inline constexpr FlagProperty size_lg = { [](ElementInfo& i) {i.appearance.mut().size = ComponentSize::Large; } };
+	inline constexpr FlagProperty size_none = { [](ElementInfo& i) {i.appearance.mut().size = ComponentSize::None; } };
 	inline constexpr Property<bool> disabled(bool v) {
-		return { v, [](ElementInfo& i, bool val) { i.appearance.disabled = val; } };
+		return { v, [](ElementInfo& i, bool val) { i.appearance.mut().disabled = val; } };
 	}
 
 	// text
@@ -224,27 +238,27 @@ namespace SableUI::Style
 
 	// callbacks
 	struct CallbackProperty {
-		std::function<void()> func;
-		void (*apply)(ElementInfo&, const std::function<void()>&);
+		EventHandler func;
+		void (*apply)(ElementInfo&, const EventHandler&);
 		void ApplyTo(ElementInfo& i) const { apply(i, func); }
 	};
 
-	inline CallbackProperty onClick(std::function<void()> f) { return { std::move(f), [](ElementInfo& i, const std::function<void()>& v) { i.onClickFunc = v; } }; }
-	inline CallbackProperty onSecondaryClick(std::function<void()> f) { return { std::move(f), [](ElementInfo& i, const std::function<void()>& v) { i.onSecondaryClickFunc = v; } }; }
-	inline CallbackProperty onDoubleClick(std::function<void()> f) { return { std::move(f), [](ElementInfo& i, const std::function<void()>& v) { i.onDoubleClickFunc = v; } }; }
+	inline CallbackProperty onClick(EventHandler f) { return { std::move(f), [](ElementInfo& i, const EventHandler& v) { i.onClickFunc = v; } }; }
+	inline CallbackProperty onSecondaryClick(EventHandler f) { return { std::move(f), [](ElementInfo& i, const EventHandler& v) { i.onSecondaryClickFunc = v; } }; }
+	inline CallbackProperty onDoubleClick(EventHandler f) { return { std::move(f), [](ElementInfo& i, const EventHandler& v) { i.onDoubleClickFunc = v; } }; }
 
 	// etc
 	struct Pos { int x, y; };
 	inline constexpr Property<Pos> absolutePos(int x, int y) {
-		return { {x, y}, [](ElementInfo& i, Pos v) { i.layout.pos.x = v.x; i.layout.pos.y = v.y; } };
+		return { {x, y}, [](ElementInfo& i, Pos v) { i.layout.mut().pos = { v.x, v.y }; } };
 	}
 
 	// hoverable
 	inline constexpr Property<std::pair<Colour, Colour>> hoverBg(Colour normal, Colour hover) {
 		return { {normal, hover}, [](ElementInfo& i, std::pair<Colour, Colour> val) {
-			i.appearance.bg = val.first;
-			i.appearance.hoverBg = val.second;
-			i.appearance.hasHoverBg = true;
+			i.appearance.mut().bg = val.first;
+			i.appearance.mut().hoverBg = val.second;
+			i.appearance.mut().hasHoverBg = true;
 		} };
 	}
 }
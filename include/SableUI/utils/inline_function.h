@@ -0,0 +1,128 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace SableUI
+{
+	template <typename Signature, size_t Capacity = 48>
+	class InlineFunction;
+
+	/* Callable stored in a fixed inline buffer, it never allocates. Captures
+	 * larger than Capacity fail to compile, capture less (e.g. `this` and a
+	 * few values) or point at state owned by the component instead.
+	 * Copying copies the captured callable in place. */
+	template <typename R, typename... Args, size_t Capacity>
+	class InlineFunction<R(Args...), Capacity>
+	{
+	public:
+		InlineFunction() noexcept = default;
+		InlineFunction(std::nullptr_t) noexcept {}
+
+		template <typename F, typename Fn = std::decay_t<F>,
+			typename = std::enable_if_t<!std::is_same_v<Fn, InlineFunction> && std::is_invocable_r_v<R, Fn&, Args...>>>
+		InlineFunction(F&& f)
+		{
+			static_assert(sizeof(Fn) <= Capacity,
+				"InlineFunction: capture is too large for the inline buffer, capture less or by pointer");
+			static_assert(alignof(Fn) <= alignof(std::max_align_t),
+				"InlineFunction: capture is over-aligned");
+			static_assert(std::is_copy_constructible_v<Fn> && std::is_nothrow_move_constructible_v<Fn>,
+				"InlineFunction: callable must be copyable and nothrow movable");
+
+			if constexpr (std::is_pointer_v<Fn> || std::is_member_pointer_v<Fn>)
+			{
+				if (f == nullptr) return;
+			}
+
+			::new (static_cast<void*>(m_storage)) Fn(std::forward<F>(f));
+			m_ops = &OpsFor<Fn>::ops;
+		}
+
+		InlineFunction(const InlineFunction& other)
+		{
+			if (other.m_ops) other.m_ops->copy(m_storage, other.m_storage);
+			m_ops = other.m_ops;
+		}
+
+		InlineFunction(InlineFunction&& other) noexcept
+		{
+			if (other.m_ops) other.m_ops->move(m_storage, other.m_storage);
+			m_ops = other.m_ops;
+			other.Reset();
+		}
+
+		~InlineFunction() { Reset(); }
+
+		InlineFunction& operator=(const InlineFunction& other)
+		{
+			if (this == &other) return *this;
+			Reset();
+			if (other.m_ops) other.m_ops->copy(m_storage, other.m_storage);
+			m_ops = other.m_ops;
+			return *this;
+		}
+
+		InlineFunction& operator=(InlineFunction&& other) noexcept
+		{
+			if (this == &other) return *this;
+			Reset();
+			if (other.m_ops) other.m_ops->move(m_storage, other.m_storage);
+			m_ops = other.m_ops;
+			other.Reset();
+			return *this;
+		}
+
+		InlineFunction& operator=(std::nullptr_t) noexcept
+		{
+			Reset();
+			return *this;
+		}
+
+		R operator()(Args... args) const
+		{
+			if (!m_ops) throw std::bad_function_call();
+			return m_ops->invoke(const_cast<unsigned char*>(m_storage), std::forward<Args>(args)...);
+		}
+
+		explicit operator bool() const noexcept { return m_ops != nullptr; }
+		bool operator==(std::nullptr_t) const noexcept { return m_ops == nullptr; }
+
+		static constexpr size_t GetCapacity() { return Capacity; }
+
+	private:
+		struct Ops
+		{
+			R (*invoke)(void* storage, Args&&... args);
+			void (*copy)(void* dst, const void* src);
+			void (*move)(void* dst, void* src);
+			void (*destroy)(void* storage);
+		};
+
+		template <typename Fn>
+		struct OpsFor
+		{
+			static R Invoke(void* storage, Args&&... args)
+			{
+				return std::invoke(*static_cast<Fn*>(storage), std::forward<Args>(args)...);
+			}
+
+			static void Copy(void* dst, const void* src) { ::new (dst) Fn(*static_cast<const Fn*>(src)); }
+			static void Move(void* dst, void* src) { ::new (dst) Fn(std::move(*static_cast<Fn*>(src))); }
+			static void Destroy(void* storage) { static_cast<Fn*>(storage)->~Fn(); }
+
+			static constexpr Ops ops = { &Invoke, &Copy, &Move, &Destroy };
+		};
+
+		void Reset() noexcept
+		{
+			if (m_ops) m_ops->destroy(m_storage);
+			m_ops = nullptr;
+		}
+
+		alignas(std::max_align_t) unsigned char m_storage[Capacity];
+		const Ops* m_ops = nullptr;
+	};
+}
@@ -53,6 +53,9 @@ namespace SableUI
 
 		size_t size() const noexcept;
 		bool empty() const noexcept;
+
+		// cached in the shared data until the string is mutated
+		size_t Hash() const noexcept;
 		char32_t operator[](size_t index) const noexcept;
 
 		operator std::string() const;
@@ -78,6 +81,7 @@ namespace SableUI
 			char32_t* data = nullptr;
 			size_t size = 0;
 			size_t refCount = 1;
+			size_t hash = 0; // 0 until computed
 
 			StringData() = default;
 			StringData(const char32_t* str, size_t len);
@@ -112,15 +116,7 @@ namespace std
 	{
 		std::size_t operator()(const SableUI::String& s) const noexcept
 		{
-			std::size_t h = 0;
-			std::hash<char32_t> charHasher;
-
-			for (auto c : s)
-			{
-				std::size_t charHash = charHasher(c);
-				h ^= charHash + 0x9e3779b9 + (h << 6) + (h >> 2);
-			}
-			return h;
+			return s.Hash();
 		}
 	};
 }
\ No newline at end of file
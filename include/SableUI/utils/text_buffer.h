@@ -0,0 +1,69 @@
+#pragma once
+#include <SableUI/utils/string.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace SableUI
+{
+	/* Editable text as a piece table. Pieces point into append-only blocks
+	 * and live in a persistent treap ordered by position, so insert, erase
+	 * and index lookups are O(log pieces) and never move the text itself.
+	 * Edits copy only the path they touch, a snapshot is the root pointer
+	 * and shares everything else with the live buffer. */
+	class TextBuffer
+	{
+	public:
+		struct Node;
+		using NodePtr = std::shared_ptr<const Node>;
+
+		struct Snapshot
+		{
+			NodePtr root;
+		};
+
+		TextBuffer() = default;
+		explicit TextBuffer(const String& text);
+
+		void Assign(const String& text);
+		void Insert(size_t pos, const String& text);
+		void Insert(size_t pos, char32_t c);
+		void Erase(size_t pos, size_t count);
+
+		size_t size() const;
+		bool empty() const { return size() == 0; }
+		char32_t At(size_t index) const;
+		String Substr(size_t pos, size_t count) const;
+
+		// the same String until the next edit. after edits only the range
+		// they touched is read from the pieces, the rest is copied from the
+		// previous flattening
+		const String& ToString() const;
+
+		Snapshot GetSnapshot() const { return { m_root }; }
+		void Restore(const Snapshot& snapshot);
+
+		size_t GetPieceCount() const;
+
+	private:
+		void Append(const char32_t* text, size_t length, size_t pos);
+		void MarkEdited(size_t pos, size_t erased);
+
+		NodePtr m_root;
+
+		// append-only, text written here is never moved or overwritten
+		std::shared_ptr<char32_t[]> m_block;
+		uint32_t m_blockSize = 0;
+		uint32_t m_blockUsed = 0;
+		uint32_t m_seed = 0x9E3779B9u;
+
+		mutable String m_flat;
+		mutable bool m_flatValid = true;
+
+		// chars at the start and end of m_flat that no edit since has touched
+		mutable size_t m_flatPrefix = 0;
+		mutable size_t m_flatSuffix = 0;
+		mutable std::u32string m_scratch;
+	};
+}
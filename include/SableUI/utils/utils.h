@@ -254,18 +254,6 @@ namespace SableUI
 				b == other.b && a == other.a;
 		}
 
-		Colour& operator=(const Colour& other)
-		{
-			if (this != &other)
-			{
-				r = other.r;
-				g = other.g;
-				b = other.b;
-				a = other.a;
-			}
-			return *this;
-		}
-
 		const Colour operator*(const float v) const
 		{
 			return Colour(r * v, g * v, b * v, a);
@@ -327,7 +315,7 @@ namespace SableUI
 			return true;
 		}
 
-		Rect getIntersection(const Rect& other) {
+		Rect getIntersection(const Rect& other) const {
 			int newX = (std::max)(x, other.x);
 			int newY = (std::max)(y, other.y);
 			int newRight = (std::min)(x + w, other.x + other.w);
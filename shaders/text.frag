@@ -7,11 +7,26 @@ in vec4 colour;
 
 layout(binding = 0) uniform sampler2DArray uAtlas;
 
+layout(std140, binding = 2) uniform TextBlock
+{
+	vec2 uTargetSize;
+	vec2 uPos;
+	float uSdfRange; // screen pixels per unit of field value, 0 for coverage atlases
+};
+
 void main()
 {
 	float a = texture(uAtlas, UV).r;
 
-	a = a * a * (3.0 - 2.0 * a);
+	if (uSdfRange > 0.0)
+	{
+		// 128 / 255 is the outline, same as SableUI::SdfToCoverage
+		a = clamp((a - 128.0 / 255.0) * uSdfRange + 0.5, 0.0, 1.0);
+	}
+	else
+	{
+		a = a * a * (3.0 - 2.0 * a);
+	}
 
 	FragColour = vec4(colour.rgb, a * colour.a);
 }
\ No newline at end of file
@@ -11,6 +11,7 @@ layout(std140, binding = 2) uniform TextBlock
 {
 	vec2 uTargetSize;
 	vec2 uPos;
+	float uSdfRange;
 };
 
 void main()
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+/* Replaces the global operator new for the test executable including it,
+ * include from exactly one source file. Allocations are counted while an
+ * AllocationScope is alive. */
+namespace AllocCounter
+{
+	inline bool counting = false;
+	inline size_t allocations = 0;
+
+	inline void* Allocate(std::size_t size) noexcept
+	{
+		if (counting) allocations++;
+		return std::malloc(size ? size : 1);
+	}
+
+	// kept out of line so the compiler does not pair free() with operator new
+	[[gnu::noinline]] inline void Free(void* p) noexcept { std::free(p); }
+}
+
+void* operator new(std::size_t size)
+{
+	if (void* p = AllocCounter::Allocate(size)) return p;
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+	if (void* p = AllocCounter::Allocate(size)) return p;
+	throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return AllocCounter::Allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return AllocCounter::Allocate(size); }
+void operator delete(void* p) noexcept { AllocCounter::Free(p); }
+void operator delete[](void* p) noexcept { AllocCounter::Free(p); }
+void operator delete(void* p, std::size_t) noexcept { AllocCounter::Free(p); }
+void operator delete[](void* p, std::size_t) noexcept { AllocCounter::Free(p); }
+
+struct AllocationScope
+{
+	AllocationScope() { AllocCounter::allocations = 0; AllocCounter::counting = true; }
+	~AllocationScope() { AllocCounter::counting = false; }
+	size_t Count() const { return AllocCounter::allocations; }
+};
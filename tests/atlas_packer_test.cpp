@@ -0,0 +1,172 @@
+#include "test_check.h"
+#include <SableUI/core/atlas_packer.h>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace SableUI;
+
+struct Placed
+{
+	int x, y, w, h;
+};
+
+static bool Overlaps(const Placed& a, const Placed& b, int gap)
+{
+	return a.x < b.x + b.w + gap && b.x < a.x + a.w + gap
+		&& a.y < b.y + b.h + gap && b.y < a.y + a.h + gap;
+}
+
+static bool AnyOverlap(const std::vector<Placed>& rects, int gap)
+{
+	for (size_t i = 0; i < rects.size(); i++)
+		for (size_t j = i + 1; j < rects.size(); j++)
+			if (Overlaps(rects[i], rects[j], gap))
+				return true;
+
+	return false;
+}
+
+// glyph-like sizes, mostly small with the odd wide or tall one
+static void RandomSize(std::mt19937& rng, int& w, int& h)
+{
+	std::uniform_int_distribution<int> small(4, 24);
+	std::uniform_int_distribution<int> large(24, 64);
+
+	w = (rng() % 8 == 0) ? large(rng) : small(rng);
+	h = (rng() % 8 == 0) ? large(rng) : small(rng);
+}
+
+static void TestSkylineFill()
+{
+	std::mt19937 rng(42);
+	SkylinePacker packer(512, 512);
+
+	std::vector<Placed> placed;
+	uint64_t area = 0;
+	int failures = 0;
+
+	// fill until a run of sizes stops fitting
+	while (failures < 64)
+	{
+		int w, h, x, y;
+		RandomSize(rng, w, h);
+
+		if (!packer.Insert(w, h, x, y))
+		{
+			failures++;
+			continue;
+		}
+
+		CHECK(x >= 0 && y >= 0 && x + w <= 512 && y + h <= 512);
+		placed.push_back({ x, y, w, h });
+		area += static_cast<uint64_t>(w) * h;
+	}
+
+	CHECK(!AnyOverlap(placed, 0));
+	CHECK(packer.GetUsedArea() == area);
+
+	float occupancy = packer.GetOccupancy();
+	std::printf("skyline: %zu rects, %.1f%% occupancy\n", placed.size(), occupancy * 100.0f);
+	CHECK(occupancy > 0.75f && occupancy <= 1.0f);
+
+	packer.Reset();
+	CHECK(packer.GetUsedArea() == 0);
+
+	int x, y;
+	CHECK(packer.Insert(512, 512, x, y) && x == 0 && y == 0);
+	CHECK(!packer.Insert(1, 1, x, y));
+	CHECK(!packer.Insert(0, 4, x, y));
+	CHECK(!packer.Insert(513, 1, x, y));
+}
+
+static void TestPaddedSlots()
+{
+	const int padding = 2;
+	std::mt19937 rng(9);
+	AtlasAllocator atlas(256, 256, padding, 4);
+
+	std::map<uint16_t, std::vector<Placed>> byLayer;
+	std::vector<uint64_t> evicted;
+
+	for (uint64_t key = 0; key < 600; key++)
+	{
+		int w, h;
+		RandomSize(rng, w, h);
+
+		AtlasSlot slot;
+		CHECK(atlas.Allocate(key, w, h, 1, slot, evicted));
+		CHECK(slot.x >= padding && slot.y >= padding && slot.x + w <= 256 && slot.y + h <= 256);
+		byLayer[slot.layer].push_back({ slot.x, slot.y, w, h });
+	}
+
+	// every slot keeps its padding from its neighbours
+	for (auto& [layer, rects] : byLayer)
+		CHECK(!AnyOverlap(rects, padding));
+
+	CHECK(evicted.empty());
+
+	AtlasStats stats = atlas.GetStats();
+	CHECK(stats.allocations == 600);
+	CHECK(stats.layers == atlas.GetLayerCount());
+	CHECK(stats.occupancy > 0.5f && stats.occupancy <= 1.0f);
+
+	// too big for a layer once padded
+	AtlasSlot slot;
+	CHECK(!atlas.Allocate(9999, 254, 8, 1, slot, evicted));
+}
+
+static void TestEvictionOverBudget()
+{
+	// one 32x32 rect fills a layer
+	AtlasAllocator atlas(32, 32, 0, 2);
+	std::vector<uint64_t> evicted;
+	AtlasSlot slot;
+
+	CHECK(atlas.Allocate(1, 32, 32, 1, slot, evicted) && slot.layer == 0);
+	CHECK(atlas.Allocate(2, 32, 32, 2, slot, evicted) && slot.layer == 1);
+	CHECK(atlas.GetLayerCount() == 2);
+
+	// layer 0 was used last in frame 1, it is reclaimed for the new key
+	CHECK(atlas.Allocate(3, 32, 32, 3, slot, evicted) && slot.layer == 0);
+	CHECK(evicted.size() == 1 && evicted[0] == 1);
+	CHECK(atlas.GetLayerCount() == 2);
+
+	// touching layer 1 makes layer 0 the oldest again
+	evicted.clear();
+	atlas.Touch(1, 4);
+	CHECK(atlas.Allocate(4, 32, 32, 4, slot, evicted) && slot.layer == 0);
+	CHECK(evicted.size() == 1 && evicted[0] == 3);
+
+	// both layers drawn this frame, the atlas grows past its budget instead
+	evicted.clear();
+	CHECK(atlas.Allocate(5, 32, 32, 4, slot, evicted) && slot.layer == 2);
+	CHECK(evicted.empty());
+	CHECK(atlas.GetLayerCount() == 3);
+
+	AtlasStats stats = atlas.GetStats();
+	CHECK(stats.layerBudget == 2);
+	CHECK(stats.evictedEntries == 2);
+	CHECK(stats.reclaimedLayers == 2);
+	CHECK(stats.overBudget == 1);
+
+	// a later frame reclaims a layer again rather than growing further,
+	// every layer was last used in frame 4 so the first one goes
+	CHECK(atlas.Allocate(6, 32, 32, 5, slot, evicted) && slot.layer == 0);
+	CHECK(evicted.size() == 1 && evicted[0] == 4);
+	CHECK(atlas.GetLayerCount() == 3);
+
+	atlas.Clear();
+	CHECK(atlas.GetLayerCount() == 0);
+}
+
+int main()
+{
+	TestSkylineFill();
+	TestPaddedSlots();
+	TestEvictionOverBudget();
+
+	return TestResult("atlas_packer_test");
+}
@@ -0,0 +1,67 @@
+#include "headless_renderer.h"
+#include "test_check.h"
+#include <SableUI/SableUI.h>
+#include <SableUI/core/element.h>
+#include <SableUI/utils/memory.h>
+
+using namespace SableUI;
+using namespace SableUI::Style;
+
+// the child sticks out to the left and above its parent through negative margins
+static void BuildTree(Colour rowBg)
+{
+	StartDiv(PackStyles(w(200), h(40), bg(rowBg.r, rowBg.g, rowBg.b)));
+	RectElement(w(100), h(20), ml(-30), mt(-10), bg(255, 0, 0));
+	EndDiv();
+}
+
+static bool Contains(const Rect& outer, const Rect& inner)
+{
+	return inner.x >= outer.x && inner.y >= outer.y &&
+		inner.x + inner.w <= outer.x + outer.w && inner.y + inner.h <= outer.y + outer.h;
+}
+
+// a repaint sets the rect of a patched element again without laying out its
+// children, its subtree bounds must still cover them or the clip and hit
+// tests drop what sticks out
+int main()
+{
+	HeadlessRenderer renderer;
+
+	ElementInfo rootInfo = PackStyles(w(400), h(200), p(50));
+	rootInfo.type = ElementType::Div;
+	Element* root = SableMemory::SB_new<Element>(&renderer, rootInfo);
+	root->SetRect({ 0, 0, 400, 200 });
+
+	SetElementBuilderContext(&renderer, root, false);
+	BuildTree({ 20, 20, 20, 255 });
+	root->LayoutChildren();
+
+	Element* row = root->children.empty() ? nullptr : (Element*)*root->children[0];
+	CHECK(row != nullptr);
+	if (row == nullptr) return TestResult("element_bounds_test");
+
+	Element* child = (Element*)*row->children[0];
+	Rect laidOut = row->subtreeBounds;
+	CHECK(!Contains(row->rect, child->rect));
+	CHECK(Contains(laidOut, child->rect));
+	CHECK(Contains(root->subtreeBounds, laidOut));
+
+	// only the row's colour changes, a paint patch
+	Element::ResetReconcileStats();
+	SetElementBuilderContext(&renderer, root, true);
+	BuildTree({ 60, 20, 20, 255 });
+	root->Reconcile(GetVirtualRootNode());
+
+	CHECK(Element::GetReconcileStats().paintPatches > 0);
+	CHECK(Element::GetReconcileStats().layoutPatches == 0);
+	CHECK(row->subtreeBounds == laidOut);
+	CHECK(Contains(row->subtreeBounds, child->rect));
+
+	// setting the same rect again, as hover does, keeps them too
+	row->SetRect(row->rect);
+	CHECK(row->subtreeBounds == laidOut);
+
+	SableMemory::SB_delete(root);
+	return TestResult("element_bounds_test");
+}
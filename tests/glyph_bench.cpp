@@ -0,0 +1,205 @@
+#include "headless_renderer.h"
+#include <SableUI/core/text.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <string>
+
+using namespace SableUI;
+
+/* Glyphs per second through text layout, each glyph is resolved against
+ * the glyph table and emitted as a quad.
+ * Usage: glyph_bench [layouts] [--script latin|cjk|mixed|all] [--cjk-fonts DIR]
+ * The first layout of a script loads and rasterises its font ranges and is
+ * reported separately. The CJK faces are not shipped in fonts/, --cjk-fonts
+ * copies them from DIR into fonts/Regular. A requested script whose faces
+ * are missing fails the run instead of being skipped. */
+
+// every CJK face of the regular font pack, the pack is loaded as a whole
+static const char* s_cjkFaces[] = {
+	"NotoSansJP-Regular.ttf", "NotoSansSC-Regular.ttf", "NotoSansHK-Regular.ttf", "NotoSansKR-Regular.ttf"
+};
+
+// copies whatever faces DIR has that fonts/Regular is missing
+static bool CopyCjkFaces(const std::filesystem::path& dir)
+{
+	std::filesystem::path target = "fonts/Regular";
+	for (const char* face : s_cjkFaces)
+	{
+		if (std::filesystem::exists(target / face) || !std::filesystem::exists(dir / face))
+			continue;
+
+		std::error_code error;
+		std::filesystem::copy_file(dir / face, target / face, error);
+		if (error)
+		{
+			std::fprintf(stderr, "could not copy %s into %s: %s\n",
+				(dir / face).string().c_str(), target.string().c_str(), error.message().c_str());
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static bool HasCjkFaces()
+{
+	bool found = true;
+	for (const char* face : s_cjkFaces)
+	{
+		if (std::filesystem::exists(std::filesystem::path("fonts/Regular") / face))
+			continue;
+
+		std::fprintf(stderr, "fonts/Regular/%s not found\n", face);
+		found = false;
+	}
+
+	if (!found)
+	{
+		std::fprintf(stderr,
+			"cjk and mixed need the Noto Sans CJK faces, get NotoSansJP, NotoSansSC, NotoSansHK and\n"
+			"NotoSansKR Regular from https://github.com/notofonts/noto-cjk and pass their directory with\n"
+			"--cjk-fonts DIR, or run with --script latin\n");
+	}
+
+	return found;
+}
+
+static std::u32string MakeLatin(size_t length)
+{
+	static const char32_t pangram[] = U"The quick brown fox jumps over the lazy dog, 0123456789. ";
+
+	std::u32string s;
+	while (s.size() < length)
+		s += pangram;
+
+	s.resize(length);
+	return s;
+}
+
+static std::u32string MakeCjk(size_t length)
+{
+	// common ideographs, kana and hangul spread over several ranges
+	std::mt19937 rng(7);
+	std::uniform_int_distribution<int> script(0, 3);
+
+	std::u32string s;
+	for (size_t i = 0; i < length; i++)
+	{
+		switch (script(rng))
+		{
+		case 0:
+		case 1: s.push_back(static_cast<char32_t>(0x4E00 + rng() % 3000)); break;
+		case 2: s.push_back(static_cast<char32_t>(0x3041 + rng() % 86)); break;
+		default: s.push_back(static_cast<char32_t>(0xAC00 + rng() % 2000)); break;
+		}
+	}
+
+	return s;
+}
+
+static std::u32string MakeMixed(size_t length)
+{
+	std::u32string latin = MakeLatin(length);
+	std::u32string cjk = MakeCjk(length);
+
+	// alternating runs the way mixed-language ui text tends to look
+	std::u32string s;
+	for (size_t i = 0; s.size() < length; i += 8)
+	{
+		s.append(latin, i % latin.size(), 8);
+		s.append(cjk, i % cjk.size(), 4);
+	}
+
+	s.resize(length);
+	return s;
+}
+
+// false if the faces found drew none of the text
+static bool Run(const char* name, const std::u32string& content, int layouts, HeadlessRenderer& renderer)
+{
+	using Clock = std::chrono::steady_clock;
+
+	_Text text;
+	text.m_renderer = &renderer;
+	text.m_content = SableString(content);
+	text.m_fontSize = 14;
+	text.m_maxWidth = 600;
+	text.m_maxHeight = 0;
+	text.m_lineSpacingPx = 18;
+
+	int height = 0, width = 0;
+	uint64_t layers = 0;
+
+	auto start = Clock::now();
+	GetTextGpuObject(&text, height, width, layers);
+	double firstMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+	start = Clock::now();
+	for (int i = 0; i < layouts; i++)
+		GetTextGpuObject(&text, height, width, layers);
+	double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+	double glyphs = static_cast<double>(content.size()) * layouts;
+	std::printf("%-6s %6zu glyphs  first layout %8.2f ms  steady %8.2f M glyphs/s  (%u quads)\n",
+		name, content.size(), firstMs, glyphs / seconds / 1e6, renderer.lastIndices / 6);
+
+	if (renderer.lastIndices == 0)
+	{
+		std::fprintf(stderr, "%s: no glyphs were drawn, the faces in fonts/Regular do not cover it\n", name);
+		return false;
+	}
+
+	return true;
+}
+
+static int Usage()
+{
+	std::fprintf(stderr, "usage: glyph_bench [layouts] [--script latin|cjk|mixed|all] [--cjk-fonts DIR]\n");
+	return 2;
+}
+
+int main(int argc, char** argv)
+{
+	int layouts = 200;
+	std::string script = "all";
+	const char* cjkFonts = nullptr;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--script" && i + 1 < argc)
+			script = argv[++i];
+		else if (arg == "--cjk-fonts" && i + 1 < argc)
+			cjkFonts = argv[++i];
+		else if (std::atoi(argv[i]) > 0)
+			layouts = std::atoi(argv[i]);
+		else
+			return Usage();
+	}
+
+	bool latin = script == "latin" || script == "all";
+	bool cjk = script == "cjk" || script == "all";
+	bool mixed = script == "mixed" || script == "all";
+	if (!latin && !cjk && !mixed)
+		return Usage();
+
+	if ((cjk || mixed) && cjkFonts && !CopyCjkFaces(cjkFonts))
+		return 1;
+
+	if ((cjk || mixed) && !HasCjkFaces())
+		return 1;
+
+	const size_t length = 4000;
+	HeadlessRenderer renderer;
+
+	bool drawn = true;
+	if (latin) drawn &= Run("latin", MakeLatin(length), layouts, renderer);
+	if (cjk) drawn &= Run("cjk", MakeCjk(length), layouts, renderer);
+	if (mixed) drawn &= Run("mixed", MakeMixed(length), layouts, renderer);
+
+	DestroyFontManager();
+	return drawn ? 0 : 1;
+}
@@ -0,0 +1,158 @@
+#include "test_check.h"
+#include <SableUI/core/glyph_sdf.h>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include FT_MODULE_H
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace SableUI;
+
+// FT_RENDER_MODE_SDF arrived in FreeType 2.11
+#if FREETYPE_MAJOR > 2 || (FREETYPE_MAJOR == 2 && FREETYPE_MINOR >= 11)
+#define SABLEUI_FT_HAS_SDF 1
+#else
+#define SABLEUI_FT_HAS_SDF 0
+#endif
+
+struct GlyphImage
+{
+	std::vector<uint8_t> pixels;
+	int width = 0;
+	int height = 0;
+	int left = 0;
+	int top = 0;
+};
+
+static bool Render(FT_Face face, char32_t c, FT_Render_Mode mode, GlyphImage& out)
+{
+	if (FT_Load_Char(face, c, FT_LOAD_NO_HINTING) || FT_Render_Glyph(face->glyph, mode))
+		return false;
+
+	const FT_Bitmap& bitmap = face->glyph->bitmap;
+	out.width = static_cast<int>(bitmap.width);
+	out.height = static_cast<int>(bitmap.rows);
+	out.left = face->glyph->bitmap_left;
+	out.top = face->glyph->bitmap_top;
+	out.pixels.resize(static_cast<size_t>(out.width) * out.height);
+
+	for (int y = 0; y < out.height; y++)
+		for (int x = 0; x < out.width; x++)
+			out.pixels[y * out.width + x] = bitmap.buffer[y * bitmap.pitch + x];
+
+	return true;
+}
+
+/* Renders a glyph at the reference size both as a plain bitmap and as a
+ * field the way the atlas does, then samples the field at every bitmap
+ * pixel centre. Pixels the outline covers fully or not at all must come out
+ * the same, pixels on the edge close to the bitmap's own coverage. */
+static void CheckGlyph(FT_Face face, char32_t c)
+{
+	GlyphImage bitmap, field;
+	CHECK(Render(face, c, FT_RENDER_MODE_NORMAL, bitmap));
+	CHECK(Render(face, c, FT_RENDER_MODE_SDF, field));
+	if (bitmap.pixels.empty() || field.pixels.empty()) return;
+
+	// the field is padded by the spread on every side
+	CHECK(field.width >= bitmap.width + SDF_SPREAD);
+	CHECK(field.height >= bitmap.height + SDF_SPREAD);
+
+	float range = GetSdfPixelRange(SDF_REFERENCE_SIZE);
+	float dx = static_cast<float>(bitmap.left - field.left);
+	float dy = static_cast<float>(field.top - bitmap.top);
+
+	int inside = 0, outside = 0, edge = 0;
+	float edgeError = 0.0f;
+
+	// one pixel of margin around the bitmap is outside the outline
+	for (int y = -1; y <= bitmap.height; y++)
+	{
+		for (int x = -1; x <= bitmap.width; x++)
+		{
+			bool inBitmap = x >= 0 && y >= 0 && x < bitmap.width && y < bitmap.height;
+			float expected = inBitmap ? bitmap.pixels[y * bitmap.width + x] / 255.0f : 0.0f;
+			float coverage = SampleSdfCoverage(field.pixels.data(), field.width, field.height,
+				x + 0.5f + dx, y + 0.5f + dy, range);
+
+			if (expected == 1.0f)
+			{
+				inside++;
+				CHECK(coverage > 0.9f);
+			}
+			else if (expected == 0.0f)
+			{
+				// a fully empty pixel can still touch the outline at a corner
+				outside++;
+				CHECK(coverage < 0.6f);
+			}
+			else
+			{
+				edge++;
+				edgeError += std::fabs(coverage - expected);
+				CHECK(std::fabs(coverage - expected) < 0.5f);
+			}
+		}
+	}
+
+	CHECK(inside > 0 && outside > 0 && edge > 0);
+	if (edge > 0)
+	{
+		float meanError = edgeError / edge;
+		if (meanError >= 0.1f)
+			std::fprintf(stderr, "'%c': mean edge error %.3f over %d pixels\n", static_cast<char>(c), meanError, edge);
+		CHECK(meanError < 0.1f);
+	}
+
+	// well outside the outline, past the bitmap, the field reads as empty
+	CHECK(SampleSdfCoverage(field.pixels.data(), field.width, field.height, 0.5f, 0.5f, range) == 0.0f);
+}
+
+static void CheckSampler()
+{
+	// a flat field reads as the same coverage everywhere, clamped at the edges
+	const uint8_t flat[4] = { 128, 128, 128, 128 };
+	float range = GetSdfPixelRange(SDF_REFERENCE_SIZE);
+	CHECK(std::fabs(SampleSdfCoverage(flat, 2, 2, 1.0f, 1.0f, range) - 0.5f) < 0.01f);
+	CHECK(std::fabs(SampleSdfCoverage(flat, 2, 2, -4.0f, 9.0f, range) - 0.5f) < 0.01f);
+
+	// a step from outside to inside is blended across one texel
+	const uint8_t step[2] = { 0, 255 };
+	CHECK(SampleSdfCoverage(step, 2, 1, 0.5f, 0.5f, range) == 0.0f);
+	CHECK(SampleSdfCoverage(step, 2, 1, 1.5f, 0.5f, range) == 1.0f);
+	CHECK(SampleSdfCoverage(nullptr, 2, 1, 1.0f, 0.5f, range) == 0.0f);
+}
+
+int main()
+{
+	CheckSampler();
+
+#if SABLEUI_FT_HAS_SDF
+	FT_Library library = nullptr;
+	FT_Face face = nullptr;
+	CHECK(FT_Init_FreeType(&library) == 0);
+
+	FT_Int spread = SDF_SPREAD;
+	FT_Property_Set(library, "sdf", "spread", &spread);
+
+	if (FT_New_Face(library, "fonts/Regular/NotoSans-Regular.ttf", 0, &face) == 0)
+	{
+		FT_Set_Pixel_Sizes(face, 0, SDF_REFERENCE_SIZE);
+		for (char32_t c : U"OilW@")
+			if (c) CheckGlyph(face, c);
+		FT_Done_Face(face);
+	}
+	else
+	{
+		std::fprintf(stderr, "fonts/Regular/NotoSans-Regular.ttf not found, run from the build directory\n");
+		CHECK(face != nullptr);
+	}
+
+	FT_Done_FreeType(library);
+#else
+	std::printf("FreeType older than 2.11 has no sdf renderer, only the sampler was checked\n");
+#endif
+
+	return TestResult("glyph_sdf_test");
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <SableUI/renderer/renderer.h>
+#include <cstdint>
+
+/* Renderer for tests and benches that run without a window. Nothing is
+ * uploaded, the sizes handed to the gpu are recorded instead. */
+class HeadlessRenderer : public SableUI::RendererBackend
+{
+public:
+	uint32_t lastVertices = 0;
+	uint32_t lastIndices = 0;
+
+	void Initialise() override {}
+	void Clear(float, float, float, float) override {}
+	void Viewport(int, int, int, int) override {}
+	void SetBlending(bool) override {}
+	void SetBlendFunction(SableUI::BlendFactor, SableUI::BlendFactor) override {}
+	void CheckErrors() override {}
+	uint32_t CreateUniformBuffer(size_t, const void*) override { return 0; }
+	void DestroyUniformBuffer(uint32_t) override {}
+	void BindUniformBufferBase(uint32_t, uint32_t) override {}
+	void ExecuteCommandBuffer() override {}
+
+	SableUI::GpuObject* CreateGpuObject(const void*, uint32_t numVertices, const uint32_t*, uint32_t numIndices,
+		const SableUI::VertexLayout&) override
+	{
+		lastVertices = numVertices;
+		lastIndices = numIndices;
+		return nullptr;
+	}
+
+	void DestroyGpuObject(SableUI::GpuObject*) override {}
+	void BeginRenderPass(const SableUI::GpuFramebuffer*) override {}
+	void EndRenderPass() override {}
+	void BlitToScreen(SableUI::GpuFramebuffer*, SableUI::TextureInterpolation) override {}
+	void BlitToScreenWithRects(SableUI::GpuFramebuffer*, const SableUI::Rect&, const SableUI::Rect&, SableUI::TextureInterpolation) override {}
+	void BlitToFramebuffer(SableUI::GpuFramebuffer*, SableUI::GpuFramebuffer*, SableUI::Rect, SableUI::Rect, SableUI::TextureInterpolation) override {}
+	void DrawToScreen(SableUI::GpuFramebuffer*, const SableUI::Rect&, const SableUI::Rect&, const SableUI::ivec2&) override {}
+};
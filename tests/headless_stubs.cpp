@@ -0,0 +1,17 @@
+#include <SableUI/renderer/gpu_texture.h>
+#include <cstdint>
+
+// gpu and event loop entry points the text sources call, for targets built without a backend
+void SableUI::GpuTexture2DArray::Init(int width, int height, int depth) { m_width = width; m_height = height; m_depth = depth; handle = 1; }
+void SableUI::GpuTexture2DArray::Resize(int newDepth) { m_depth = newDepth; }
+void SableUI::GpuTexture2DArray::Bind(uint32_t) const {}
+void SableUI::GpuTexture2DArray::Unbind(uint32_t) const {}
+void SableUI::GpuTexture2DArray::SetLinearFiltering(bool linear) { m_linear = linear; }
+void SableUI::GpuTexture2DArray::SubImage(int, int, int, int, int, int, const uint8_t*) {}
+void SableUI::GpuTexture2DArray::CopyImageSubData(const GpuTexture2DArray&, int, int, int, int, int, int, int, int, int) {}
+SableUI::GpuTexture2DArray::~GpuTexture2DArray() {}
+
+namespace SableUI
+{
+	void PostEmptyEvent() {}
+}
@@ -0,0 +1,124 @@
+#include "alloc_counter.h"
+#include "test_check.h"
+#include <SableUI/utils/inline_function.h>
+#include <SableUI/core/element.h>
+#include <utility>
+
+using namespace SableUI;
+
+// tracks live copies so leaked or double destroyed captures show up
+struct Tracked
+{
+	static inline int live = 0;
+	int* hits;
+
+	Tracked(int* hits) : hits(hits) { live++; }
+	Tracked(const Tracked& other) : hits(other.hits) { live++; }
+	Tracked(Tracked&& other) noexcept : hits(other.hits) { live++; }
+	~Tracked() { live--; }
+};
+
+static int s_freeHits = 0;
+static void FreeHandler() { s_freeHits++; }
+
+static void TestInlineFunction()
+{
+	int hits = 0;
+	double a = 1.0, b = 2.0, c = 3.0;
+
+	{
+		AllocationScope scope;
+
+		// a capture close to the 48 byte capacity
+		Tracked tracked(&hits);
+		InlineFunction<void()> f = [tracked, a, b, c]() { *tracked.hits += static_cast<int>(a + b + c); };
+		CHECK(f);
+
+		InlineFunction<void()> copy = f;
+		InlineFunction<void()> assigned;
+		assigned = copy;
+
+		InlineFunction<void()> moved = std::move(copy);
+		CHECK(!copy);
+
+		InlineFunction<void()> moveAssigned;
+		moveAssigned = std::move(moved);
+		CHECK(!moved);
+
+		f();
+		assigned();
+		moveAssigned();
+		CHECK(hits == 18);
+
+		InlineFunction<int(int, int)> add = [](int x, int y) { return x + y; };
+		CHECK(add(2, 3) == 5);
+
+		InlineFunction<void()> fn = &FreeHandler;
+		fn();
+		CHECK(s_freeHits == 1);
+
+		void (*nullFn)() = nullptr;
+		InlineFunction<void()> empty = nullFn;
+		CHECK(!empty);
+
+		assigned = nullptr;
+		CHECK(!assigned);
+
+		CHECK(scope.Count() == 0);
+	}
+
+	CHECK(Tracked::live == 0);
+	CHECK((InlineFunction<void()>::GetCapacity() == 48));
+}
+
+static void TestElementInfo()
+{
+	int clicks = 0;
+
+	// default style records are created once per process, outside the measured part
+	{
+		ElementInfo warm;
+		(void)warm;
+	}
+
+	AllocationScope scope;
+
+	ElementInfo info;
+	info.type = ElementType::Div;
+	info.onClickFunc = [&clicks]() { clicks++; };
+	info.onSecondaryClickFunc = [&clicks]() { clicks += 10; };
+	info.onDoubleClickFunc = [&clicks, step = 100]() { clicks += step; };
+
+	// virtual node builds and reconciles copy infos around like this
+	ElementInfo copy = info;
+	ElementInfo assigned;
+	assigned = copy;
+	ElementInfo moved = std::move(copy);
+
+	moved.onClickFunc();
+	moved.onSecondaryClickFunc();
+	assigned.onDoubleClickFunc();
+	info.onClickFunc();
+	CHECK(clicks == 112);
+
+	assigned.onClickFunc = moved.onClickFunc;
+	assigned.onClickFunc();
+	CHECK(clicks == 113);
+
+	CHECK(scope.Count() == 0);
+}
+
+int main()
+{
+	// the counter itself has to see allocations for the zero checks to mean anything
+	{
+		AllocationScope scope;
+		::operator delete(::operator new(16));
+		CHECK(scope.Count() == 1);
+	}
+
+	TestInlineFunction();
+	TestElementInfo();
+
+	return TestResult("inline_function_test");
+}
@@ -0,0 +1,130 @@
+#include "headless_renderer.h"
+#include <SableUI/SableUI.h>
+#include <SableUI/core/element.h>
+#include <SableUI/utils/memory.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace SableUI;
+using namespace SableUI::Style;
+
+/* Reconcile cost of list edits, keyed against positional matching.
+ * Usage: reconcile_bench [rows] [iterations]
+ * Each workload flips a list of rows between two orders and reconciles
+ * the element tree every time, rows hold a couple of rects whose size and
+ * colour follow the row id so a row matched to the wrong id is patched. */
+
+struct Workload
+{
+	const char* name;
+	std::vector<int> a;
+	std::vector<int> b;
+};
+
+static void BuildRows(const std::vector<int>& ids, bool keyed)
+{
+	for (int id : ids)
+	{
+		ElementInfo row = PackStyles(w(400), h(20), left_right,
+			bg(static_cast<uint8_t>(id * 37), static_cast<uint8_t>(id * 11), 80));
+		if (keyed)
+			key(static_cast<uint64_t>(id)).ApplyTo(row);
+
+		StartDiv(row);
+		RectElement(w(8 + id % 40), h(8), bg(255, static_cast<uint8_t>(id), 0));
+		RectElement(w(16), h(8 + id % 8), bg(0, 0, static_cast<uint8_t>(id)));
+		EndDiv();
+	}
+}
+
+static void Run(const Workload& workload, bool keyed, int iterations, HeadlessRenderer& renderer)
+{
+	using Clock = std::chrono::steady_clock;
+
+	ElementInfo rootInfo = PackStyles(w(400), h(800));
+	rootInfo.type = ElementType::Div;
+	Element* root = SableMemory::SB_new<Element>(&renderer, rootInfo);
+
+	SetElementBuilderContext(&renderer, root, false);
+	BuildRows(workload.a, keyed);
+	root->LayoutChildren();
+
+	Element::ResetReconcileStats();
+
+	// building the virtual tree is the same work either way, only the diff is timed
+	Clock::duration elapsed{};
+	for (int i = 0; i < iterations; i++)
+	{
+		SetElementBuilderContext(&renderer, root, true);
+		BuildRows((i & 1) ? workload.a : workload.b, keyed);
+
+		auto start = Clock::now();
+		root->Reconcile(GetVirtualRootNode());
+		elapsed += Clock::now() - start;
+	}
+	double us = std::chrono::duration<double, std::micro>(elapsed).count() / iterations;
+
+	const ReconcileStats& rs = Element::GetReconcileStats();
+	auto per = [&](uint64_t v) { return static_cast<double>(v) / iterations; };
+
+	std::printf("%-8s %-10s %9.1f us  unchanged %7.1f  paint %6.1f  layout %6.1f  created %6.1f  removed %6.1f  moved %6.1f\n",
+		workload.name, keyed ? "keyed" : "positional", us,
+		per(rs.unchanged), per(rs.paintPatches), per(rs.layoutPatches),
+		per(rs.created), per(rs.removed), per(rs.moved));
+
+	SableMemory::SB_delete(root);
+}
+
+int main(int argc, char** argv)
+{
+	int rows = argc > 1 ? std::atoi(argv[1]) : 1000;
+	int iterations = argc > 2 ? std::atoi(argv[2]) : 200;
+	if (rows < 2) rows = 1000;
+	if (iterations <= 0) iterations = 200;
+
+	std::vector<int> ids(rows);
+	std::iota(ids.begin(), ids.end(), 0);
+
+	std::vector<Workload> workloads;
+
+	// one row added at the top
+	std::vector<int> prepended = ids;
+	prepended.insert(prepended.begin(), rows);
+	workloads.push_back({ "prepend", ids, prepended });
+
+	// one row added in the middle
+	std::vector<int> inserted = ids;
+	inserted.insert(inserted.begin() + rows / 2, rows);
+	workloads.push_back({ "insert", ids, inserted });
+
+	// one row taken out of the middle
+	std::vector<int> removed = ids;
+	removed.erase(removed.begin() + rows / 2);
+	workloads.push_back({ "remove", ids, removed });
+
+	// a row dragged from the bottom to the top
+	std::vector<int> moved = ids;
+	std::rotate(moved.begin(), moved.end() - 1, moved.end());
+	workloads.push_back({ "move", ids, moved });
+
+	// every row shuffled
+	std::vector<int> shuffled = ids;
+	std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(5));
+	workloads.push_back({ "shuffle", ids, shuffled });
+
+	HeadlessRenderer renderer;
+	std::printf("%d rows, %d reconciles per run, counts are per reconcile\n", rows, iterations);
+
+	for (const Workload& workload : workloads)
+	{
+		Run(workload, false, iterations, renderer);
+		Run(workload, true, iterations, renderer);
+	}
+
+	return 0;
+}
@@ -0,0 +1,159 @@
+#include "test_check.h"
+#include <SableUI/core/spatial_index.h>
+#include <SableUI/utils/utils.h>
+#include <random>
+#include <vector>
+
+using namespace SableUI;
+
+// the index never dereferences its elements, distinct addresses are enough
+static Element* FakeElement(std::vector<char>& storage, size_t i)
+{
+	return reinterpret_cast<Element*>(&storage[i]);
+}
+
+static void BruteForce(const std::vector<Rect>& rects, const std::vector<Element*>& elements,
+	ivec2 p, std::vector<Element*>& out)
+{
+	out.clear();
+	for (size_t i = 0; i < rects.size(); i++)
+		if (rects[i].w > 0 && rects[i].h > 0 && RectBoundingBox(rects[i], p))
+			out.push_back(elements[i]);
+}
+
+static void TestMatchesTreeWalk()
+{
+	std::mt19937 rng(1234);
+	std::uniform_int_distribution<int> pos(-200, 2000);
+	std::uniform_int_distribution<int> size(0, 400);
+
+	const size_t count = 2000;
+	std::vector<char> storage(count);
+	std::vector<Rect> rects;
+	std::vector<Element*> elements;
+
+	SpatialIndex index;
+	for (size_t i = 0; i < count; i++)
+	{
+		Rect r = { pos(rng), pos(rng), size(rng), size(rng) };
+		rects.push_back(r);
+		elements.push_back(FakeElement(storage, i));
+		index.Insert(elements.back(), r);
+	}
+	index.Build();
+
+	CHECK(index.valid);
+	CHECK(index.GetNumCells() <= 4096);
+
+	std::vector<Element*> expected, actual;
+	std::uniform_int_distribution<int> point(-300, 2500);
+	for (int i = 0; i < 20000; i++)
+	{
+		ivec2 p = { point(rng), point(rng) };
+		BruteForce(rects, elements, p, expected);
+		index.Query(p, actual);
+
+		// same elements in the same order as a dfs over the tree
+		CHECK(actual == expected);
+
+		for (Element* el : expected)
+			CHECK(index.Contains(p, el));
+	}
+}
+
+static void TestEdges()
+{
+	std::vector<char> storage(4);
+	Element* a = FakeElement(storage, 0);
+	Element* b = FakeElement(storage, 1);
+	Element* empty = FakeElement(storage, 2);
+
+	SpatialIndex index;
+	index.Insert(a, { 10, 10, 100, 50 });
+	index.Insert(empty, { 20, 20, 0, 30 });
+	index.Insert(b, { 60, 30, 100, 100 });
+	index.Build();
+
+	// zero sized rects are never hit
+	CHECK(index.GetNumEntries() == 2);
+
+	std::vector<Element*> out;
+	index.Query({ 10, 10 }, out);
+	CHECK(out.size() == 1 && out[0] == a);
+
+	index.Query({ 109, 59 }, out);
+	CHECK(out.size() == 2 && out[0] == a && out[1] == b);
+
+	index.Query({ 110, 60 }, out);
+	CHECK(out.size() == 1 && out[0] == b);
+
+	index.Query({ 9, 10 }, out);
+	CHECK(out.empty());
+
+	CHECK(index.Contains({ 15, 15 }, a));
+	CHECK(!index.Contains({ 15, 15 }, b));
+	CHECK(!index.Contains({ 25, 25 }, empty));
+}
+
+static void TestClear()
+{
+	std::vector<char> storage(1);
+	Element* a = FakeElement(storage, 0);
+
+	SpatialIndex index;
+	std::vector<Element*> out;
+
+	// never built
+	index.Query({ 0, 0 }, out);
+	CHECK(out.empty());
+
+	index.Insert(a, { 0, 0, 10, 10 });
+	index.Build();
+	index.Query({ 5, 5 }, out);
+	CHECK(out.size() == 1);
+
+	index.Clear();
+	CHECK(!index.valid);
+	CHECK(index.GetNumEntries() == 0);
+	index.Query({ 5, 5 }, out);
+	CHECK(out.empty());
+
+	// an empty build is valid and hits nothing
+	index.Build();
+	CHECK(index.valid);
+	index.Query({ 5, 5 }, out);
+	CHECK(out.empty());
+}
+
+static void TestWideBounds()
+{
+	std::vector<char> storage(2);
+	Element* a = FakeElement(storage, 0);
+	Element* b = FakeElement(storage, 1);
+
+	// far apart entries coarsen the grid instead of growing it past the budget
+	SpatialIndex index;
+	index.Insert(a, { 0, 0, 8, 8 });
+	index.Insert(b, { 100000, 100000, 8, 8 });
+	index.Build();
+
+	CHECK(index.GetNumCells() <= 4096);
+	CHECK(index.GetCellSize() > 64);
+
+	std::vector<Element*> out;
+	index.Query({ 100004, 100004 }, out);
+	CHECK(out.size() == 1 && out[0] == b);
+
+	index.Query({ 50000, 50000 }, out);
+	CHECK(out.empty());
+}
+
+int main()
+{
+	TestMatchesTreeWalk();
+	TestEdges();
+	TestClear();
+	TestWideBounds();
+
+	return TestResult("spatial_index_test");
+}
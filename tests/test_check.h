@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdio>
+
+/* Checks shared by the test executables. A failed CHECK is reported and
+ * counted and the test carries on, main returns TestResult() so ctest sees
+ * any failure. */
+namespace TestCheck
+{
+	inline int failures = 0;
+}
+
+#define CHECK(cond) \
+	do { if (!(cond)) { std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); TestCheck::failures++; } } while (0)
+
+inline int TestResult(const char* name)
+{
+	if (TestCheck::failures)
+	{
+		std::fprintf(stderr, "%s: %d failure(s)\n", name, TestCheck::failures);
+		return 1;
+	}
+
+	std::printf("%s: passed\n", name);
+	return 0;
+}
@@ -0,0 +1,141 @@
+#include "test_check.h"
+#include <SableUI/utils/text_buffer.h>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace SableUI;
+
+static std::u32string Flat(const String& s)
+{
+	return std::u32string(s.begin(), s.begin() + s.size());
+}
+
+static std::u32string RandomText(std::mt19937& rng, size_t maxLength)
+{
+	std::uniform_int_distribution<size_t> length(1, maxLength);
+	std::uniform_int_distribution<int> ch(0, 3);
+	const char32_t alphabet[] = { U'a', U' ', U'\n', U'中' };
+
+	std::u32string out(length(rng), U'a');
+	for (char32_t& c : out)
+		c = alphabet[ch(rng)];
+	return out;
+}
+
+static bool Matches(const TextBuffer& buffer, const std::u32string& oracle)
+{
+	return buffer.size() == oracle.size() && Flat(buffer.ToString()) == oracle;
+}
+
+// random edits against a plain string, flattening at random points so the
+// partial rebuild sees runs of one to many edits
+static void TestMatchesOracle()
+{
+	std::mt19937 rng(4321);
+	std::uniform_int_distribution<int> op(0, 9);
+
+	std::u32string oracle = U"The quick brown fox\njumps over the lazy dog";
+	TextBuffer buffer{ String(oracle) };
+
+	struct Saved { TextBuffer::Snapshot snapshot; std::u32string text; };
+	std::vector<Saved> saved;
+
+	for (int i = 0; i < 20000; i++)
+	{
+		int kind = op(rng);
+		size_t pos = std::uniform_int_distribution<size_t>(0, oracle.size())(rng);
+
+		if (kind < 4)
+		{
+			char32_t c = kind == 0 ? U'\n' : U'x';
+			buffer.Insert(pos, c);
+			oracle.insert(oracle.begin() + pos, c);
+		}
+		else if (kind < 6)
+		{
+			std::u32string text = RandomText(rng, 16);
+			buffer.Insert(pos, String(text));
+			oracle.insert(pos, text);
+		}
+		else if (kind < 8)
+		{
+			size_t count = std::uniform_int_distribution<size_t>(0, 8)(rng);
+			buffer.Erase(pos, count);
+			if (pos < oracle.size())
+				oracle.erase(pos, count);
+		}
+		else if (kind == 8)
+		{
+			saved.push_back({ buffer.GetSnapshot(), oracle });
+		}
+		else if (!saved.empty())
+		{
+			size_t which = std::uniform_int_distribution<size_t>(0, saved.size() - 1)(rng);
+			buffer.Restore(saved[which].snapshot);
+			oracle = saved[which].text;
+		}
+
+		if (i % 3 == 0 || op(rng) == 0)
+			CHECK(Matches(buffer, oracle));
+
+		if (i % 97 == 0 && !oracle.empty())
+		{
+			size_t at = std::uniform_int_distribution<size_t>(0, oracle.size() - 1)(rng);
+			CHECK(buffer.At(at) == oracle[at]);
+			CHECK(Flat(buffer.Substr(at, 20)) == oracle.substr(at, 20));
+		}
+	}
+
+	CHECK(Matches(buffer, oracle));
+
+	// every snapshot still reads back as the text it was taken of
+	for (const Saved& s : saved)
+	{
+		buffer.Restore(s.snapshot);
+		CHECK(Matches(buffer, s.text));
+	}
+}
+
+// the flattened string is shared with whoever read it, a later edit must
+// not change what they hold
+static void TestFlatIsNotModified()
+{
+	TextBuffer buffer(String(U"hello world"));
+	String before = buffer.ToString();
+
+	buffer.Insert(5, U',');
+	buffer.Erase(0, 1);
+	buffer.Insert(0, U'H');
+
+	CHECK(Flat(before) == U"hello world");
+	CHECK(Flat(buffer.ToString()) == U"Hello, world");
+}
+
+static void TestEditsAtEnds()
+{
+	TextBuffer buffer;
+	std::u32string oracle;
+
+	for (int i = 0; i < 100; i++)
+	{
+		buffer.Insert(buffer.size(), U'a' + (i % 26));
+		oracle.push_back(U'a' + (i % 26));
+		buffer.Insert(0, U'0' + (i % 10));
+		oracle.insert(oracle.begin(), U'0' + (i % 10));
+		CHECK(Matches(buffer, oracle));
+	}
+
+	buffer.Erase(0, buffer.size());
+	CHECK(buffer.empty());
+	CHECK(buffer.ToString().size() == 0);
+}
+
+int main()
+{
+	TestMatchesOracle();
+	TestFlatIsNotModified();
+	TestEditsAtEnds();
+
+	return TestResult("text_buffer_test");
+}
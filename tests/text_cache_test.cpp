@@ -0,0 +1,113 @@
+#include "headless_renderer.h"
+#include "test_check.h"
+#include <SableUI/core/text.h>
+#include <SableUI/core/text_cache.h>
+#include <vector>
+
+using namespace SableUI;
+
+constexpr size_t TEXT_LENGTH = 1000;
+constexpr size_t ENTRY_BYTES = TEXT_LENGTH * sizeof(char32_t); // headless gpu objects hold no buffers
+
+static SableString MakeContent(char32_t c)
+{
+	return SableString(std::u32string(TEXT_LENGTH, c));
+}
+
+// one renderer in this test, so one factory
+static TextCacheStats GetStats()
+{
+	std::vector<const TextCacheFactory*> factories = TextCacheFactory::GetFactories();
+	CHECK(factories.size() == 1);
+	return factories.empty() ? TextCacheStats{} : factories[0]->GetStats();
+}
+
+static void Acquire(_Text& text)
+{
+	int height = 0;
+	uint64_t layers = 0;
+	TextCacheFactory::Get(&text, height, layers);
+}
+
+int main()
+{
+	HeadlessRenderer renderer;
+
+	std::vector<_Text> texts(5);
+	for (size_t i = 0; i < texts.size(); i++)
+	{
+		texts[i].m_renderer = &renderer;
+		texts[i].m_content = MakeContent(U'a' + static_cast<char32_t>(i));
+		texts[i].m_fontSize = 11;
+		texts[i].m_maxWidth = 400;
+		texts[i].m_lineSpacingPx = 14;
+	}
+
+	TextCacheFactory::SetMemoryBudget(ENTRY_BYTES * 2 + ENTRY_BYTES / 2);
+
+	for (_Text& text : texts)
+		Acquire(text);
+
+	// entries in use are never evicted, the budget is exceeded instead
+	TextCacheStats stats = GetStats();
+	CHECK(stats.entries == 5);
+	CHECK(stats.misses == 5);
+	CHECK(stats.bytes == ENTRY_BYTES * 5);
+
+	TextCacheFactory::CleanCache(&renderer);
+	TextCacheFactory::CleanCache(&renderer);
+	stats = GetStats();
+	CHECK(stats.evictions == 0);
+	CHECK(stats.bytes == ENTRY_BYTES * 5);
+
+	// released oldest first: 0, 1, 2, 3, 4
+	for (_Text& text : texts)
+		TextCacheFactory::Release(&renderer, TextCacheKey(&text));
+
+	stats = GetStats();
+	CHECK(stats.idleEntries == 5);
+	CHECK(stats.bytes == ENTRY_BYTES * 5);
+
+	// the first three released go, two entries fit the budget
+	TextCacheFactory::CleanCache(&renderer);
+	stats = GetStats();
+	CHECK(stats.evictions == 3);
+	CHECK(stats.entries == 2);
+	CHECK(stats.idleEntries == 2);
+	CHECK(stats.bytes == ENTRY_BYTES * 2);
+	CHECK(stats.bytes <= stats.budget);
+
+	// 3 and 4 are still cached, 0 has to be built again
+	Acquire(texts[3]);
+	Acquire(texts[4]);
+	CHECK(GetStats().hits == 2);
+	CHECK(GetStats().misses == 5);
+
+	Acquire(texts[0]);
+	stats = GetStats();
+	CHECK(stats.misses == 6);
+	CHECK(stats.idleEntries == 0);
+	CHECK(stats.bytes == ENTRY_BYTES * 3);
+
+	// 4 is released after 3 and 0, so it outlives them
+	TextCacheFactory::Release(&renderer, TextCacheKey(&texts[3]));
+	TextCacheFactory::Release(&renderer, TextCacheKey(&texts[0]));
+	TextCacheFactory::Release(&renderer, TextCacheKey(&texts[4]));
+	TextCacheFactory::SetMemoryBudget(ENTRY_BYTES);
+	TextCacheFactory::CleanCache(&renderer);
+	TextCacheFactory::CleanCache(&renderer);
+
+	stats = GetStats();
+	CHECK(stats.evictions == 5);
+	CHECK(stats.entries == 1);
+	CHECK(stats.bytes == ENTRY_BYTES);
+
+	Acquire(texts[4]);
+	CHECK(GetStats().hits == 3);
+	TextCacheFactory::Release(&renderer, TextCacheKey(&texts[4]));
+
+	TextCacheFactory::ShutdownFactory(&renderer);
+	texts.clear();
+	DestroyFontManager();
+	return TestResult("text_cache_test");
+}
@@ -0,0 +1,83 @@
+#include "alloc_counter.h"
+#include "headless_renderer.h"
+#include "test_check.h"
+#include <SableUI/core/text.h>
+#include <cstdio>
+
+using namespace SableUI;
+
+static void CheckSteadyState(const char* name, _Text& text, HeadlessRenderer& renderer)
+{
+	int height = 0, width = 0;
+	uint64_t layers = 0;
+
+	// the first layouts load font ranges, rasterise glyphs and grow the scratch
+	GetTextGpuObject(&text, height, width, layers);
+	GetTextGpuObject(&text, height, width, layers);
+
+	uint32_t vertices = renderer.lastVertices;
+	uint32_t indices = renderer.lastIndices;
+	int warmHeight = height;
+
+	size_t allocations;
+	{
+		AllocationScope scope;
+		for (int i = 0; i < 100; i++)
+			GetTextGpuObject(&text, height, width, layers);
+		allocations = scope.Count();
+	}
+
+	if (allocations != 0)
+		std::fprintf(stderr, "%s: %zu allocations over 100 layouts\n", name, allocations);
+
+	CHECK(allocations == 0);
+	CHECK(vertices > 0 && indices > 0);
+	CHECK(renderer.lastVertices == vertices && renderer.lastIndices == indices);
+	CHECK(height == warmHeight && height > 0);
+}
+
+int main()
+{
+	// the counter itself has to see allocations for the zero checks to mean anything
+	{
+		AllocationScope scope;
+		::operator delete(::operator new(16));
+		CHECK(scope.Count() == 1);
+	}
+
+	HeadlessRenderer renderer;
+
+	SableString paragraph;
+	for (int i = 0; i < 20; i++)
+		paragraph = paragraph + SableString(U"The quick brown fox jumps over the lazy dog. ");
+	paragraph = paragraph + SableString(U"Some ") + SableString(U"bold").bold()
+		+ SableString(U" text\nand a second paragraph.");
+
+	{
+		_Text text;
+		text.m_renderer = &renderer;
+		text.m_content = paragraph;
+		text.m_fontSize = 14;
+		text.m_maxWidth = 300;
+		text.m_maxHeight = 0;
+		text.m_lineSpacingPx = 18;
+
+		CheckSteadyState("wrapped", text, renderer);
+
+		// cut off after three lines with an ellipsis
+		text.m_maxHeight = 54;
+		CheckSteadyState("truncated", text, renderer);
+
+		text.m_maxHeight = 0;
+		text.m_justify = TextJustification::Center;
+		CheckSteadyState("centred", text, renderer);
+
+		SetGlyphRenderMode(GlyphRenderMode::SDF);
+		CheckSteadyState("sdf", text, renderer);
+		SetGlyphRenderMode(GlyphRenderMode::Bitmap);
+	}
+
+	DestroyFontManager();
+
+	return TestResult("text_layout_alloc_test");
+}
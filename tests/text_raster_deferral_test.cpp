@@ -0,0 +1,51 @@
+#include "headless_renderer.h"
+#include "test_check.h"
+#include <SableUI/core/text.h>
+
+using namespace SableUI;
+
+// layout, measurement and hit testing use glyph metrics only, the atlas is
+// only written once the text is prepared for drawing
+int main()
+{
+	HeadlessRenderer renderer;
+
+	SableString content;
+	for (int i = 0; i < 8; i++)
+		content = content + SableString(U"Pack my box with five dozen liquor jugs. ");
+	content = content + SableString(U"Sphinx of black quartz").italic() + SableString(U", judge my vow.");
+
+	{
+		_Text text;
+		int height = text.SetContent(&renderer, content, 240, 15);
+		uint64_t allocations = GetFontAtlasStats().allocations;
+
+		CHECK(height > 0);
+		CHECK(text.GetMinWidth(true) > 0);
+		CHECK(text.GetUnwrappedHeight() > 0);
+
+		text.UpdateMaxWidth(180);
+		text.GetCursorPosition(content.size());
+		text.GetIndexAtPoint({ 20, 20 });
+		text.SetContent(&renderer, content + SableString(U" Again."), 200, 17);
+
+		CHECK(GetFontAtlasStats().allocations == allocations);
+		CHECK(renderer.lastVertices == 0);
+
+		text.PrepareAtlas();
+
+		CHECK(GetFontAtlasStats().allocations > allocations);
+		CHECK(renderer.lastVertices > 0);
+
+		// drawing again with no layout in between reuses the built vertices
+		allocations = GetFontAtlasStats().allocations;
+		renderer.lastVertices = 0;
+		text.PrepareAtlas();
+
+		CHECK(GetFontAtlasStats().allocations == allocations);
+		CHECK(renderer.lastVertices == 0);
+	}
+
+	DestroyFontManager();
+	return TestResult("text_raster_deferral_test");
+}
@@ -0,0 +1,159 @@
+#include "test_check.h"
+#include <SableUI/core/text.h>
+#include <cstdio>
+#include <random>
+
+using namespace SableUI;
+
+// an incremental rewrap has to end up with the lines and caret offsets a
+// layout of the new text from scratch gives
+static bool SameAsFullLayout(const TextLayout& layout, const SableString& text, int fontSize, int maxWidth)
+{
+	TextLayout full;
+	full.Update(text, fontSize, maxWidth);
+
+	if (layout.GetLineCount() != full.GetLineCount())
+	{
+		std::fprintf(stderr, "%zu lines, full layout has %zu\n", layout.GetLineCount(), full.GetLineCount());
+		return false;
+	}
+
+	for (size_t i = 0; i < full.GetLineCount(); i++)
+	{
+		const TextLine& a = layout.GetLine(i);
+		const TextLine& b = full.GetLine(i);
+		if (a.begin != b.begin || a.end != b.end || a.width != b.width || a.style != b.style)
+		{
+			std::fprintf(stderr, "line %zu is [%u, %u) %.2f, full layout has [%u, %u) %.2f\n",
+				i, a.begin, a.end, a.width, b.begin, b.end, b.width);
+			return false;
+		}
+	}
+
+	for (size_t i = 0; i <= text.size(); i++)
+	{
+		if (layout.GetLineOfIndex(i) != full.GetLineOfIndex(i) || layout.GetCaretX(i) != full.GetCaretX(i))
+		{
+			std::fprintf(stderr, "caret at %zu differs from the full layout\n", i);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static SableString Splice(const SableString& text, size_t pos, size_t erase, const SableString& insert)
+{
+	return text.substr(0, pos) + insert + text.substr(pos + erase);
+}
+
+static SableString MakeText()
+{
+	SableString text;
+	for (int i = 0; i < 12; i++)
+	{
+		text = text + SableString(U"Pack my box with five dozen liquor jugs. ");
+		if (i % 4 == 3)
+			text = text + SableString(U"Sphinx of black quartz").bold() + SableString(U", judge my vow.\n");
+	}
+	return text;
+}
+
+static void TestEdits()
+{
+	const int fontSize = 14;
+	const int width = 260;
+
+	SableString text = MakeText();
+	TextLayout layout;
+	layout.Update(text, fontSize, width);
+	CHECK(SameAsFullLayout(layout, text, fontSize, width));
+
+	size_t end = text.size();
+	size_t middle = end / 2;
+
+	struct Edit { size_t pos; size_t erase; SableString insert; };
+	const Edit edits[] = {
+		{ 0, 0, U"x" },								// start
+		{ 0, 1, U"" },
+		{ 0, 0, U"Supercalifragilistic " },			// pushes words onto the next line
+		{ 0, 21, U"" },
+		{ middle, 0, U"y" },						// middle
+		{ middle, 0, U" " },
+		{ middle, 2, U"" },
+		{ middle, 0, U"\n" },						// new hard line
+		{ middle, 1, U"" },
+		{ middle - 30, 60, U"" },					// across line breaks
+		{ middle, 0, SableString(U"bold ").bold() },// style carried past the edit
+		{ end - 60, 0, U"z" },						// end
+		{ end - 60, 1, U"" },
+	};
+
+	for (const Edit& edit : edits)
+	{
+		text = Splice(text, std::min(edit.pos, text.size()), edit.erase, edit.insert);
+		layout.Update(text, fontSize, width);
+
+		CHECK(SameAsFullLayout(layout, text, fontSize, width));
+		CHECK(layout.GetRewrappedLines() < layout.GetLineCount());
+	}
+
+	// appending at the very end
+	text = text + SableString(U" and the end");
+	layout.Update(text, fontSize, width);
+	CHECK(SameAsFullLayout(layout, text, fontSize, width));
+}
+
+static void TestWidthChanges()
+{
+	const int fontSize = 14;
+	SableString text = MakeText();
+	TextLayout layout;
+
+	const int widths[] = { 300, 120, 121, 600, 40, 300 };
+	for (int width : widths)
+	{
+		layout.Update(text, fontSize, width);
+		CHECK(SameAsFullLayout(layout, text, fontSize, width));
+
+		// an edit straight after the width changed rewraps against the new width
+		text = Splice(text, text.size() / 3, 0, U"word ");
+		layout.Update(text, fontSize, width);
+		CHECK(SameAsFullLayout(layout, text, fontSize, width));
+	}
+}
+
+// typing and deleting at random, as a text field does
+static void TestRandomEdits()
+{
+	const int fontSize = 14;
+	const int width = 200;
+	const char32_t* pieces[] = { U"a", U" ", U"\n", U"longerword ", U"b" };
+
+	std::mt19937 rng(77);
+	SableString text = MakeText();
+	TextLayout layout;
+	layout.Update(text, fontSize, width);
+
+	for (int i = 0; i < 300; i++)
+	{
+		size_t pos = std::uniform_int_distribution<size_t>(0, text.size())(rng);
+		if (rng() % 3 == 0 && pos < text.size())
+			text = Splice(text, pos, 1 + rng() % 4, U"");
+		else
+			text = Splice(text, pos, 0, pieces[rng() % 5]);
+
+		layout.Update(text, fontSize, width);
+		CHECK(SameAsFullLayout(layout, text, fontSize, width));
+	}
+}
+
+int main()
+{
+	TestEdits();
+	TestWidthChanges();
+	TestRandomEdits();
+
+	DestroyFontManager();
+	return TestResult("text_rewrap_test");
+}